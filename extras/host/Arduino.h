@@ -0,0 +1,93 @@
+/**
+ * @file Arduino.h
+ * @brief Sustituto mínimo de <Arduino.h> para compilar la librería en el host.
+ * Permite usar AdaptiveTXWSN y sus componentes en simuladores y herramientas
+ * de gateway con un reloj virtual en lugar de millis() real.
+ * Se activa añadiendo `-I extras/host` a la línea de compilación.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+#define INPUT   0x0
+#define OUTPUT  0x1
+#define LOW     0x0
+#define HIGH    0x1
+#define A0      14
+#define A1      15
+#define A2      16
+#define A3      17
+
+// Memoria de programa: en el host es memoria normal
+#define PROGMEM
+#define pgm_read_byte(p)  (*(const uint8_t*)(p))
+#define pgm_read_word(p)  (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+
+namespace atx {
+namespace sim {
+
+/**
+ * @brief Estado del "hardware" simulado: reloj virtual y lectura ADC.
+ */
+struct Hardware {
+  uint32_t ms          = 0;   ///< Valor devuelto por millis().
+  uint32_t us          = 0;   ///< Valor devuelto por micros().
+  int      adcCuentas  = 0;   ///< Valor devuelto por analogRead().
+  const uint16_t* adcRafaga = nullptr; ///< Si no es nullptr, analogRead() recorre estas cuentas.
+  uint8_t  adcLargo    = 0;
+  uint8_t  adcIndice   = 0;
+};
+
+inline Hardware& hw() {
+  static thread_local Hardware h;
+  return h;
+}
+
+/** @brief Fija el reloj virtual (ms). */
+inline void setMillis(uint32_t ms) { hw().ms = ms; hw().us = ms * 1000UL; }
+
+/** @brief Avanza el reloj virtual (ms). */
+inline void advanceMillis(uint32_t ms) { setMillis(hw().ms + ms); }
+
+/** @brief Fija las cuentas que devolverá analogRead(). */
+inline void setAdcCounts(int cuentas) { hw().adcCuentas = cuentas; hw().adcRafaga = nullptr; }
+
+/**
+ * @brief Hace que analogRead() devuelva `cuentas[0..largo)` en orden (y
+ * vuelva a empezar), p. ej. una ráfaga distinta por tick(). El arreglo debe
+ * seguir vivo mientras se lea; nullptr vuelve al valor de setAdcCounts().
+ */
+inline void setAdcBurst(const uint16_t* cuentas, uint8_t largo) {
+  hw().adcRafaga = (largo > 0) ? cuentas : nullptr;
+  hw().adcLargo  = largo;
+  hw().adcIndice = 0;
+}
+
+/** @brief Lectura del ADC simulado (ver setAdcCounts() y setAdcBurst()). */
+inline int adcRead() {
+  Hardware& h = hw();
+  if (!h.adcRafaga) return h.adcCuentas;
+  const uint16_t c = h.adcRafaga[h.adcIndice];
+  h.adcIndice = (uint8_t)((h.adcIndice + 1) % h.adcLargo);
+  return c;
+}
+
+} // namespace sim
+} // namespace atx
+
+inline uint32_t millis()                 { return atx::sim::hw().ms; }
+inline uint32_t micros()                 { return atx::sim::hw().us; }
+inline void     delay(uint32_t ms)       { atx::sim::advanceMillis(ms); }
+inline void     delayMicroseconds(unsigned int) {}
+inline void     pinMode(uint8_t, uint8_t) {}
+inline void     digitalWrite(uint8_t, uint8_t) {}
+inline int      analogRead(uint8_t)      { return atx::sim::adcRead(); }
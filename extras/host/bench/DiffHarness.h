@@ -0,0 +1,323 @@
+/**
+ * @file DiffHarness.h
+ * @brief Verificación diferencial: corre la clase de referencia
+ * (AdaptiveTXWSN, tick() en float) y un motor optimizado sobre la misma traza
+ * y compara tick a tick nivel, corte, envío y período.
+ *
+ * Una traza es una secuencia de voltajes en mV enteros, uno por tick(), con
+ * un paso fijo del loop(), que se inyectan con setBatteryVolts() /
+ * setBatteryMillivolts(). En modo ADC la traza trae en cambio las
+ * MUESTRAS_ADC cuentas que devuelve analogRead() en cada tick(): ambos
+ * motores leen el pin y convierten (float en AdcSampler, Q16 en
+ * AdaptiveTXWSNTiny), así que se comparan voltajes con fracciones de mV.
+ * La primera divergencia se clasifica: si el voltaje
+ * de ese tick está a `tolerancia_mV` o menos de un borde de banda (umbral con
+ * histéresis o corte), se acepta como diferencia de redondeo; si no, es una
+ * falla y se guarda con el historial de estado para reproducirla.
+ *
+ * Un motor cumple el concepto:
+ *  - `static const char* nombre()`;
+ *  - `void run(const Trace&, std::vector<TickState>& salida)`: un TickState
+ *    por muestra de la traza, con el estado que dejó ese tick().
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <AdaptiveTXWSNTiny.h>
+#include <sim/SkipAhead.h>
+
+#include <cmath>
+#include <vector>
+
+namespace atx {
+namespace verify {
+
+static const uint8_t MUESTRAS_ADC = 8; ///< Lecturas por tick() en modo ADC (`muestrasPromedioAdc` por defecto).
+
+/** @brief mV de batería por cuenta del ADC con el divisor y la referencia por defecto del `Cfg`. */
+inline double mVPorCuenta() {
+  const AdaptiveTXWSN::Cfg c;
+  return 1000.0 * c.voltajeReferenciaAdc / 1023.0 * (c.divisorRArriba_k + c.divisorRAbajo_k) / c.divisorRAbajo_k;
+}
+
+/**
+ * @struct Trace
+ * @brief Voltajes (mV) de tick() consecutivos separados por `paso_ms`.
+ */
+struct Trace {
+  uint64_t              semilla = 0;  ///< Semilla que la generó (0: grabada).
+  uint32_t              paso_ms = 1000;
+  std::vector<uint16_t> mV;           ///< En modo ADC, el voltaje de las cuentas redondeado (sólo para mostrar).
+  std::vector<uint16_t> adc;          ///< Modo ADC: MUESTRAS_ADC cuentas por tick(); vacío si se inyecta mV.
+
+  bool modoAdc() const { return !adc.empty(); }
+
+  /** @brief Voltaje (mV) que corresponde al tick i, con fracción en modo ADC. */
+  double voltaje_mV(size_t i) const {
+    if (!modoAdc()) return mV[i];
+    uint32_t suma = 0;
+    for (uint8_t k = 0; k < MUESTRAS_ADC; ++k) suma += adc[i * MUESTRAS_ADC + k];
+    return suma * mVPorCuenta() / MUESTRAS_ADC;
+  }
+
+  /** @brief Prepara la entrada del tick i: analogRead() en modo ADC. */
+  void alimentarAdc(size_t i) const { sim::setAdcBurst(&adc[i * MUESTRAS_ADC], MUESTRAS_ADC); }
+};
+
+/** @brief Configuración de la referencia para una traza (con pin en modo ADC). */
+inline AdaptiveTXWSN::Cfg cfgPara(const Trace& tr) {
+  AdaptiveTXWSN::Cfg c;
+  if (tr.modoAdc()) c.pinAdcBateria = A0;
+  return c;
+}
+
+/** @brief TinyCfg que lee el mismo pin (mismos divisor, referencia y muestras que el `Cfg`). */
+struct TinyAdcCfg : TinyCfg {
+  static constexpr int8_t PIN_ADC = A0;
+};
+
+/**
+ * @struct TickState
+ * @brief Estado observable después de un tick().
+ */
+struct TickState {
+  uint32_t periodo_ms;
+  uint8_t  nivel;
+  bool     corte;
+  bool     envio;
+
+  bool operator==(const TickState& o) const {
+    return periodo_ms == o.periodo_ms && nivel == o.nivel && corte == o.corte && envio == o.envio;
+  }
+  bool operator!=(const TickState& o) const { return !(*this == o); }
+};
+
+/**
+ * @class TraceGen
+ * @brief Trazas aleatorias deterministas por semilla (splitmix64): caminata
+ * que pasa la mayor parte del tiempo cerca de los bordes de banda, con saltos
+ * a un borde ± 3 mV, pasos de 1 a 40 mV y paso del loop() de 10 ms a 5 s.
+ * makeAdc() hace lo mismo en unidades de la suma de la ráfaga (1/8 de
+ * cuenta, ~2.5 mV) y reparte cada suma entre las lecturas con ruido de
+ * suma cero.
+ */
+class TraceGen {
+public:
+  /** @param cfg Configuración cuyos bordes se buscan. */
+  explicit TraceGen(const AdaptiveTXWSN::Cfg& cfg) { bordes(cfg, _bordes); }
+
+  void make(uint64_t semilla, uint16_t ticks, Trace& tr) const {
+    static const uint32_t PASOS_ms[4] = { 10, 100, 1000, 5000 };
+    static const int      ANCHOS[4]   = { 1, 3, 10, 40 };
+    uint64_t s = semilla;
+    tr.semilla = semilla;
+    tr.paso_ms = PASOS_ms[siguiente(s) & 3];
+    const int ancho = ANCHOS[siguiente(s) & 3];
+    int mV = 3000 + (int)(siguiente(s) % 1400);
+    tr.adc.clear();
+    tr.mV.resize(ticks);
+    for (uint16_t i = 0; i < ticks; ++i) {
+      const uint64_t r = siguiente(s);
+      if ((r & 31) == 0) mV = (int)lround(_bordes[(r >> 5) % 5]) - 3 + (int)((r >> 16) % 7);
+      else               mV += (int)((r >> 8) % (2 * ancho + 1)) - ancho;
+      if (mV < 3000) mV = 3000;
+      if (mV > 4400) mV = 4400;
+      tr.mV[i] = (uint16_t)mV;
+    }
+  }
+
+  /** @brief Como make() pero en cuentas del ADC (ver Trace::adc). */
+  void makeAdc(uint64_t semilla, uint16_t ticks, Trace& tr) const {
+    static const uint32_t PASOS_ms[4] = { 10, 100, 1000, 5000 };
+    static const int      ANCHOS[4]   = { 1, 2, 4, 16 };
+    const double mVPorSuma = mVPorCuenta() / MUESTRAS_ADC;
+    const int minimo = (int)std::ceil(3000 / mVPorSuma), maximo = (int)(4400 / mVPorSuma);
+    uint64_t s = semilla;
+    tr.semilla = semilla;
+    tr.paso_ms = PASOS_ms[siguiente(s) & 3];
+    const int ancho = ANCHOS[siguiente(s) & 3];
+    int suma = minimo + (int)(siguiente(s) % (uint64_t)(maximo - minimo));
+    tr.mV.resize(ticks);
+    tr.adc.resize((size_t)ticks * MUESTRAS_ADC);
+    for (uint16_t i = 0; i < ticks; ++i) {
+      const uint64_t r = siguiente(s);
+      if ((r & 31) == 0) suma = (int)lround(_bordes[(r >> 5) % 5] / mVPorSuma) - 3 + (int)((r >> 16) % 7);
+      else               suma += (int)((r >> 8) % (2 * ancho + 1)) - ancho;
+      if (suma < minimo) suma = minimo;
+      if (suma > maximo) suma = maximo;
+      uint16_t* c = &tr.adc[(size_t)i * MUESTRAS_ADC];
+      for (uint8_t k = 0; k < MUESTRAS_ADC; ++k) c[k] = (uint16_t)(suma / MUESTRAS_ADC + (k < suma % MUESTRAS_ADC));
+      const uint16_t ruido = (uint16_t)((r >> 24) % 4);
+      const uint8_t a = (uint8_t)((r >> 32) % MUESTRAS_ADC), b = (uint8_t)((r >> 40) % MUESTRAS_ADC);
+      if (a != b && c[b] >= ruido) { c[a] += ruido; c[b] -= ruido; }
+      tr.mV[i] = (uint16_t)lround(tr.voltaje_mV(i));
+    }
+  }
+
+  /** @brief Bordes de banda en mV (HysteresisClassifier y corte), en la aritmética float de tick(). */
+  static void bordes(const AdaptiveTXWSN::Cfg& c, double b[5]) {
+    const float diferencialAlto_V  = c.umbralAlto_V  * c.fraccionHisteresis;
+    const float diferencialMedio_V = c.umbralMedio_V * c.fraccionHisteresis;
+    b[0] = (c.umbralAlto_V  - diferencialAlto_V)  * 1000.0;
+    b[1] = (c.umbralAlto_V  + diferencialAlto_V)  * 1000.0;
+    b[2] = (c.umbralMedio_V - diferencialMedio_V) * 1000.0;
+    b[3] = (c.umbralMedio_V + diferencialMedio_V) * 1000.0;
+    b[4] = c.corteVoltaje_V * 1000.0;
+  }
+
+private:
+  double _bordes[5];
+
+  static uint64_t siguiente(uint64_t& s) {
+    uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+};
+
+// ---------------------------------------------------------------- Motores
+
+/** @brief Referencia: AdaptiveTXWSN con el voltaje inyectado en float (o leído del ADC). */
+struct ReferenceEngine {
+  static const char* nombre() { return "referencia"; }
+
+  template <class Nodo>
+  static void correr(Nodo& nodo, const Trace& tr, std::vector<TickState>& salida) {
+    sim::setMillis(0);
+    nodo.begin(cfgPara(tr));
+    salida.resize(tr.mV.size());
+    for (size_t i = 0; i < tr.mV.size(); ++i) {
+      sim::setMillis((uint32_t)(i * tr.paso_ms));
+      if (tr.modoAdc()) tr.alimentarAdc(i);
+      else              nodo.setBatteryVolts(tr.mV[i] / 1000.0f);
+      const bool envio = nodo.tick();
+      salida[i] = TickState{ nodo.currentPeriod(), (uint8_t)nodo.level(), nodo.isCutoff(), envio };
+    }
+    sim::setAdcBurst(nullptr, 0);
+  }
+
+  void run(const Trace& tr, std::vector<TickState>& salida) {
+    AdaptiveTXWSN nodo;
+    correr(nodo, tr, salida);
+  }
+};
+
+/** @brief CachedHysteresisClassifier en lugar del de por defecto. */
+struct CachedEngine {
+  static const char* nombre() { return "cached"; }
+
+  void run(const Trace& tr, std::vector<TickState>& salida) {
+    BasicAdaptiveTXWSN<NoTrace, AdcSampler, NoFilter, CachedHysteresisClassifier> nodo;
+    ReferenceEngine::correr(nodo, tr, salida);
+  }
+};
+
+/**
+ * @brief AdaptiveTXWSNTiny (aritmética entera en mV, configuración TinyCfg;
+ * en modo ADC, TinyAdcCfg y su conversión en Q16).
+ */
+struct TinyEngine {
+  static const char* nombre() { return "tiny"; }
+
+  void run(const Trace& tr, std::vector<TickState>& salida) {
+    if (tr.modoAdc()) correr<TinyAdcCfg>(tr, salida);
+    else              correr<TinyCfg>(tr, salida);
+  }
+
+private:
+  template <class C>
+  static void correr(const Trace& tr, std::vector<TickState>& salida) {
+    sim::setMillis(0);
+    AdaptiveTXWSNTiny<C> nodo;
+    nodo.begin();
+    salida.resize(tr.mV.size());
+    for (size_t i = 0; i < tr.mV.size(); ++i) {
+      sim::setMillis((uint32_t)(i * tr.paso_ms));
+      if (tr.modoAdc()) tr.alimentarAdc(i);
+      else              nodo.setBatteryMillivolts(tr.mV[i]);
+      const bool envio = nodo.tick();
+      salida[i] = TickState{ nodo.currentPeriod(), (uint8_t)nodo.level(), nodo.isCutoff(), envio };
+    }
+    sim::setAdcBurst(nullptr, 0);
+  }
+};
+
+/**
+ * @brief SkipAhead sobre la traza como retención de orden cero, avanzado
+ * hasta cada tick() de la traza; en los tick() que salta se toma el estado
+ * del último ejecutado. En modo ADC el voltaje de cada tramo es el que
+ * AdcSampler calcula con las cuentas de ese tick().
+ */
+struct SkipEngine {
+  static const char* nombre() { return "skip"; }
+
+  void run(const Trace& tr, std::vector<TickState>& salida) {
+    sim::PiecewiseVoltage& modelo = _modelo;
+    modelo.clear();
+    AdaptiveTXWSN lector;
+    lector.begin(cfgPara(tr));
+    for (size_t i = 0; i < tr.mV.size(); ++i) {
+      const uint64_t t = (uint64_t)i * tr.paso_ms;
+      float v = tr.mV[i] / 1000.0f;
+      if (tr.modoAdc()) {
+        tr.alimentarAdc(i);
+        v = lector.readBatteryVolts();
+      }
+      modelo.add(t, v);
+      if (tr.paso_ms > 1 && i + 1 < tr.mV.size()) modelo.add(t + tr.paso_ms - 1, v);
+    }
+    sim::setAdcBurst(nullptr, 0);
+    salida.resize(tr.mV.size());
+    sim::SkipAhead sim;
+    sim.begin(AdaptiveTXWSN::Cfg(), tr.paso_ms);
+    for (size_t i = 0; i < tr.mV.size(); ++i) {
+      const uint64_t t = (uint64_t)i * tr.paso_ms;
+      bool envio = false;
+      sim.run(modelo, t, [&](uint64_t te, AdaptiveTXWSN&) { envio = (te == t); });
+      // Si SkipAhead saltó este tick(), el estado es el del último ejecutado
+      const AdaptiveTXWSN& n = sim.node();
+      salida[i] = TickState{ n.currentPeriod(), (uint8_t)n.level(), n.isCutoff(), envio };
+    }
+  }
+
+private:
+  sim::PiecewiseVoltage _modelo; ///< Se reutiliza entre trazas.
+};
+
+// ----------------------------------------------------------- Comparación
+
+/**
+ * @struct Divergence
+ * @brief Primera diferencia entre referencia y candidato en una traza.
+ */
+struct Divergence {
+  bool      hay       = false;
+  size_t    tick      = 0;
+  double    borde_mV  = 0;    ///< Distancia del voltaje de ese tick al borde más cercano.
+  TickState referencia;
+  TickState candidato;
+};
+
+/** @brief Compara dos salidas y mide la distancia al borde de la primera divergencia. */
+inline Divergence compare(const Trace& tr, const std::vector<TickState>& ref, const std::vector<TickState>& cand,
+                          const double bordes[5]) {
+  Divergence d;
+  for (size_t i = 0; i < ref.size() && i < cand.size(); ++i) {
+    if (ref[i] == cand[i]) continue;
+    d.hay = true;
+    d.tick = i;
+    d.referencia = ref[i];
+    d.candidato = cand[i];
+    d.borde_mV = 1e9;
+    for (int b = 0; b < 5; ++b) d.borde_mV = std::min(d.borde_mV, std::fabs(tr.voltaje_mV(i) - bordes[b]));
+    break;
+  }
+  return d;
+}
+
+} // namespace verify
+} // namespace atx
@@ -0,0 +1,243 @@
+/**
+ * @file diff_verify.cpp
+ * @brief Verificación diferencial de los motores optimizados contra
+ * AdaptiveTXWSN (ver DiffHarness.h), en todos los núcleos.
+ *
+ * Cada traza sale de su semilla, así que una falla se reproduce sola con
+ * `repro`. Las divergencias a `tol` mV o menos de un borde de banda se
+ * cuentan como toleradas (redondeo float contra mV enteros); las demás son
+ * fallas y el programa termina con código 1. Con entrada `adc` las trazas
+ * son cuentas que ambos motores leen con analogRead() (conversión float
+ * contra Q16, voltajes con fracción de mV).
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -pthread -I src -I extras/host extras/host/bench/diff_verify.cpp -o diff_verify
+ * Uso:
+ *   ./diff_verify [motor=todos] [trazas=1000000] [ticks=256] [tol=1] [hilos=núcleos] [semilla=1] [entrada=mv]
+ *       motor: cached, tiny, skip o todos; entrada: mv (voltaje inyectado) o adc.
+ *   ./diff_verify repro <motor> <semilla> [ticks=256] [entrada=mv]
+ *   ./diff_verify file <motor> <archivo> [paso_ms=1000]   traza medida ("t_s,volts" por línea)
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include "DiffHarness.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using atx::verify::Divergence;
+using atx::verify::TickState;
+using atx::verify::Trace;
+
+struct Opciones {
+  std::string motor   = "todos";
+  uint64_t    trazas  = 1000000;
+  uint16_t    ticks   = 256;
+  double      tol_mV  = 1.0;
+  unsigned    hilos   = 0;
+  uint64_t    semilla = 1;
+  bool        adc     = false;
+};
+
+/** Traza de una semilla según la entrada elegida. */
+void generar(const atx::verify::TraceGen& gen, bool adc, uint64_t semilla, uint16_t ticks, Trace& tr) {
+  if (adc) gen.makeAdc(semilla, ticks, tr);
+  else     gen.make(semilla, ticks, tr);
+}
+
+struct Resumen {
+  uint64_t   trazas     = 0;
+  uint64_t   ticks      = 0;
+  uint64_t   exactas    = 0;
+  uint64_t   toleradas  = 0;
+  uint64_t   fallas     = 0;
+  uint64_t   porDistancia[4] = {}; ///< Divergencias a 0, 1, 2 y 3+ mV de un borde.
+  bool       hayFalla   = false;
+  uint64_t   semillaFalla = 0;   ///< La menor semilla con falla.
+  Divergence falla;
+};
+
+void imprimirEstado(const char* quien, const TickState& e) {
+  printf("%s(nivel=%u corte=%d envio=%d periodo_ms=%u)", quien, e.nivel, e.corte, e.envio, e.periodo_ms);
+}
+
+/** Tick a tick alrededor de la divergencia, con ambos estados. */
+template <class Motor>
+void detallar(const Trace& tr, const Divergence& d) {
+  std::vector<TickState> ref, cand;
+  atx::verify::ReferenceEngine().run(tr, ref);
+  Motor().run(tr, cand);
+  printf("  semilla=%llu paso_ms=%u tick=%zu t_ms=%llu mV=%.2f distancia_borde_mV=%.3f\n",
+         (unsigned long long)tr.semilla, tr.paso_ms, d.tick, (unsigned long long)d.tick * tr.paso_ms,
+         tr.voltaje_mV(d.tick), d.borde_mV);
+  const size_t desde = (d.tick > 8) ? d.tick - 8 : 0;
+  for (size_t i = desde; i <= d.tick + 2 && i < tr.mV.size(); ++i) {
+    printf("  %c %5zu %7.2fmV ", (i == d.tick) ? '>' : ' ', i, tr.voltaje_mV(i));
+    imprimirEstado("ref", ref[i]);
+    printf(" ");
+    imprimirEstado(Motor::nombre(), cand[i]);
+    printf("\n");
+  }
+}
+
+template <class Motor>
+int verificar(const Opciones& o) {
+  const AdaptiveTXWSN::Cfg cfg;
+  const atx::verify::TraceGen gen(cfg);
+  double bordes[5];
+  atx::verify::TraceGen::bordes(cfg, bordes);
+
+  const unsigned hilos = o.hilos ? o.hilos : std::max(1u, std::thread::hardware_concurrency());
+  std::vector<Resumen> parciales(hilos);
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> ts;
+  for (unsigned h = 0; h < hilos; ++h) {
+    ts.emplace_back([&, h] {
+      Resumen& r = parciales[h];
+      Trace tr;
+      std::vector<TickState> ref, cand;
+      atx::verify::ReferenceEngine motorRef;
+      Motor motor;
+      for (uint64_t i = h; i < o.trazas; i += hilos) {
+        generar(gen, o.adc, o.semilla + i, o.ticks, tr);
+        motorRef.run(tr, ref);
+        motor.run(tr, cand);
+        r.trazas++;
+        r.ticks += tr.mV.size();
+        const Divergence d = atx::verify::compare(tr, ref, cand, bordes);
+        if (!d.hay) { r.exactas++; continue; }
+        r.porDistancia[(d.borde_mV < 3.0) ? (int)d.borde_mV : 3]++;
+        if (d.borde_mV <= o.tol_mV) { r.toleradas++; continue; }
+        r.fallas++;
+        if (!r.hayFalla || tr.semilla < r.semillaFalla) {
+          r.hayFalla = true;
+          r.semillaFalla = tr.semilla;
+          r.falla = d;
+        }
+      }
+    });
+  }
+  for (std::thread& t : ts) t.join();
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  Resumen total;
+  for (const Resumen& r : parciales) {
+    total.trazas += r.trazas;
+    total.ticks += r.ticks;
+    total.exactas += r.exactas;
+    total.toleradas += r.toleradas;
+    total.fallas += r.fallas;
+    for (int k = 0; k < 4; ++k) total.porDistancia[k] += r.porDistancia[k];
+    if (r.hayFalla && (!total.hayFalla || r.semillaFalla < total.semillaFalla)) {
+      total.hayFalla = true;
+      total.semillaFalla = r.semillaFalla;
+      total.falla = r.falla;
+    }
+  }
+  printf("motor=%s entrada=%s trazas=%llu ticks=%llu exactas=%llu toleradas=%llu fallas=%llu "
+         "divergencias_por_mV_al_borde=%llu/%llu/%llu/%llu+ hilos=%u trazas_por_min=%.0f\n",
+         Motor::nombre(), o.adc ? "adc" : "mv", (unsigned long long)total.trazas, (unsigned long long)total.ticks,
+         (unsigned long long)total.exactas, (unsigned long long)total.toleradas, (unsigned long long)total.fallas,
+         (unsigned long long)total.porDistancia[0], (unsigned long long)total.porDistancia[1],
+         (unsigned long long)total.porDistancia[2], (unsigned long long)total.porDistancia[3], hilos,
+         total.trazas / s * 60.0);
+  if (total.hayFalla) {
+    printf("  primera falla (reproducir con: repro %s %llu %u %s):\n", Motor::nombre(),
+           (unsigned long long)total.semillaFalla, o.ticks, o.adc ? "adc" : "mv");
+    Trace tr;
+    generar(gen, o.adc, total.semillaFalla, o.ticks, tr);
+    detallar<Motor>(tr, total.falla);
+    return 1;
+  }
+  return 0;
+}
+
+template <class Motor>
+int reproducir(const Trace& tr) {
+  double bordes[5];
+  atx::verify::TraceGen::bordes(AdaptiveTXWSN::Cfg(), bordes);
+  std::vector<TickState> ref, cand;
+  atx::verify::ReferenceEngine().run(tr, ref);
+  Motor().run(tr, cand);
+  const Divergence d = atx::verify::compare(tr, ref, cand, bordes);
+  if (!d.hay) {
+    printf("motor=%s ticks=%zu sin divergencia\n", Motor::nombre(), tr.mV.size());
+    return 0;
+  }
+  printf("motor=%s divergencia:\n", Motor::nombre());
+  detallar<Motor>(tr, d);
+  return 1;
+}
+
+/** Remuestrea una traza "t_s,volts" a un tick() cada `paso_ms` (retención de orden cero). */
+bool leerArchivo(const char* ruta, uint32_t paso_ms, Trace& tr) {
+  FILE* f = fopen(ruta, "r");
+  if (!f) { perror(ruta); return false; }
+  std::vector<std::pair<double, double>> muestras;
+  char linea[128];
+  double t_s, v;
+  while (fgets(linea, sizeof(linea), f)) {
+    if (sscanf(linea, "%lf,%lf", &t_s, &v) == 2 && t_s >= 0) muestras.push_back({ t_s * 1000.0, v });
+  }
+  fclose(f);
+  if (muestras.empty()) return false;
+  tr.semilla = 0;
+  tr.paso_ms = paso_ms;
+  tr.mV.clear();
+  size_t j = 0;
+  for (double t = muestras[0].first; t <= muestras.back().first; t += paso_ms) {
+    while (j + 1 < muestras.size() && muestras[j + 1].first <= t) ++j;
+    tr.mV.push_back((uint16_t)lround(muestras[j].second * 1000.0));
+  }
+  return true;
+}
+
+template <class Fn>
+int porMotor(const std::string& motor, Fn&& fn) {
+  int r = 0;
+  bool alguno = false;
+  if (motor == "cached" || motor == "todos") { alguno = true; r |= fn(atx::verify::CachedEngine()); }
+  if (motor == "tiny"   || motor == "todos") { alguno = true; r |= fn(atx::verify::TinyEngine()); }
+  if (motor == "skip"   || motor == "todos") { alguno = true; r |= fn(atx::verify::SkipEngine()); }
+  if (!alguno) { fprintf(stderr, "motor desconocido: %s\n", motor.c_str()); return 2; }
+  return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 4 && strcmp(argv[1], "repro") == 0) {
+    const uint16_t ticks = (argc > 4) ? (uint16_t)atoi(argv[4]) : 256;
+    const bool adc = (argc > 5) && strcmp(argv[5], "adc") == 0;
+    Trace tr;
+    generar(atx::verify::TraceGen(AdaptiveTXWSN::Cfg()), adc, strtoull(argv[3], nullptr, 10), ticks, tr);
+    return porMotor(argv[2], [&](auto m) { return reproducir<decltype(m)>(tr); });
+  }
+  if (argc >= 4 && strcmp(argv[1], "file") == 0) {
+    Trace tr;
+    if (!leerArchivo(argv[3], (argc > 4) ? (uint32_t)atoi(argv[4]) : 1000, tr)) {
+      fprintf(stderr, "%s: sin muestras\n", argv[3]);
+      return 1;
+    }
+    return porMotor(argv[2], [&](auto m) { return reproducir<decltype(m)>(tr); });
+  }
+
+  Opciones o;
+  if (argc > 1) o.motor   = argv[1];
+  if (argc > 2) o.trazas  = strtoull(argv[2], nullptr, 10);
+  if (argc > 3) o.ticks   = (uint16_t)atoi(argv[3]);
+  if (argc > 4) o.tol_mV  = atof(argv[4]);
+  if (argc > 5) o.hilos   = (unsigned)atoi(argv[5]);
+  if (argc > 6) o.semilla = strtoull(argv[6], nullptr, 10);
+  if (argc > 7) o.adc     = strcmp(argv[7], "adc") == 0;
+  return porMotor(o.motor, [&](auto m) { return verificar<decltype(m)>(o); });
+}
@@ -0,0 +1,61 @@
+#!/bin/sh
+# @file flash_budget.sh
+# @brief Control de regresión del tamaño de código de AdaptiveTXWSNTiny.
+#
+# Compila una unidad mínima (begin() y tick() con lectura del ADC) con -Os
+# y falla si la sección .text supera el presupuesto. Es una medida del host
+# (x86-64 o lo que compile $CXX), no del AVR: sirve para detectar
+# crecimientos, no para saber cuánto ocupa en un ATtiny. Para contar sólo
+# código de la librería, la unidad se compila contra un Arduino.h mínimo con
+# millis(), analogRead(), pinMode() y delayMicroseconds() declarados extern
+# (fuera de línea), no contra el sustituto del host. Con un compilador
+# cruzado se pasan CXX, SIZE, CORE (directorio con el Arduino.h del core) y
+# el presupuesto propio del destino.
+#
+# Uso, desde la raíz del repositorio:
+#   sh extras/host/bench/flash_budget.sh [presupuesto_bytes=320]
+# @authors Francisco Rosales, Omar Tox
+# @date 2025-09
+
+set -e
+PRESUPUESTO=${1:-320}
+CXX=${CXX:-g++}
+SIZE=${SIZE:-size}
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+if [ -z "$CORE" ]; then
+  CORE="$DIR/core"
+  mkdir "$CORE"
+  cat > "$CORE/Arduino.h" <<'FIN'
+#pragma once
+#include <stdint.h>
+#define INPUT 0x0
+extern "C" {
+unsigned long millis(void);
+int analogRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t modo);
+void delayMicroseconds(unsigned int us);
+}
+FIN
+fi
+
+cat > "$DIR/tiny.cpp" <<'FIN'
+#include <Arduino.h>
+#include <AdaptiveTXWSNTiny.h>
+
+struct CfgAdc : TinyCfg { static constexpr int8_t PIN_ADC = 0; };
+AdaptiveTXWSNTiny<CfgAdc> txTimer;
+
+void setup() { txTimer.begin(); }
+bool loopTick() { return txTimer.tick(); }
+FIN
+
+"$CXX" -std=c++17 -Os -ffunction-sections -fno-exceptions -fno-asynchronous-unwind-tables \
+  -I src -I "$CORE" -c "$DIR/tiny.cpp" -o "$DIR/tiny.o"
+TEXTO=$("$SIZE" -A "$DIR/tiny.o" | awk '$1 ~ /^\.text/ { s += $2 } END { print s + 0 }')
+if [ "$TEXTO" -gt "$PRESUPUESTO" ]; then
+  echo "AdaptiveTXWSNTiny: .text=$TEXTO bytes supera el presupuesto de $PRESUPUESTO FALLA"
+  exit 1
+fi
+echo "AdaptiveTXWSNTiny: .text=$TEXTO bytes presupuesto=$PRESUPUESTO ok"
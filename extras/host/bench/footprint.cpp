@@ -0,0 +1,65 @@
+/**
+ * @file footprint.cpp
+ * @brief Control de regresión de tamaño y equivalencia de AdaptiveTXWSNTiny.
+ *
+ * Los static_assert fallan la compilación si el estado de la edición
+ * compacta supera 8 bytes o si deja de ser copiable sin constructor. En
+ * ejecución se compara, tick a tick, contra AdaptiveTXWSN con la misma
+ * configuración sobre una caminata aleatoria de voltaje que cruza todos los
+ * umbrales y el corte: nivel, corte y envíos deben coincidir.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/bench/footprint.cpp -o footprint
+ * Uso:
+ *   ./footprint [ticks=5000000]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <AdaptiveTXWSNTiny.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <type_traits>
+
+static_assert(sizeof(AdaptiveTXWSNTiny<>) <= 8, "AdaptiveTXWSNTiny: el estado supera 8 bytes de RAM");
+static_assert(std::is_trivially_copyable<AdaptiveTXWSNTiny<>>::value, "AdaptiveTXWSNTiny: el estado debe ser plano");
+
+int main(int argc, char** argv) {
+  const uint32_t ticks = (argc > 1) ? (uint32_t)atoi(argv[1]) : 5000000;
+
+  atx::sim::setMillis(0);
+  AdaptiveTXWSN completo;
+  completo.begin(AdaptiveTXWSN::Cfg());
+  AdaptiveTXWSNTiny<> tiny;
+  tiny.begin();
+
+  std::mt19937 rng(2025);
+  std::uniform_int_distribution<int> paso(-6, 6);
+  int mV = 3900;
+  uint32_t difNivel = 0, difCorte = 0, difEnvio = 0, envios = 0, cambios = 0;
+  AdaptiveTXWSN::Level anterior = completo.level();
+  for (uint32_t i = 0; i < ticks; ++i) {
+    mV += paso(rng);
+    if (mV < 3200) mV = 3200;
+    if (mV > 4250) mV = 4250;
+    completo.setBatteryVolts(mV / 1000.0f);
+    tiny.setBatteryMillivolts((uint16_t)mV);
+    const bool a = completo.tick();
+    const bool b = tiny.tick();
+    envios += a;
+    if (a != b) difEnvio++;
+    if (completo.isCutoff() != tiny.isCutoff()) difCorte++;
+    if (completo.level() != tiny.level()) difNivel++;
+    if (completo.level() != anterior) { cambios++; anterior = completo.level(); }
+    atx::sim::advanceMillis(250);
+  }
+
+  printf("sizeof AdaptiveTXWSN=%zu AdaptiveTXWSNTiny=%zu\n", sizeof(AdaptiveTXWSN), sizeof(AdaptiveTXWSNTiny<>));
+  printf("ticks=%u envios=%u cambios_nivel=%u dif_nivel=%u dif_corte=%u dif_envio=%u\n",
+         ticks, envios, cambios, difNivel, difCorte, difEnvio);
+  return (difNivel || difCorte || difEnvio) ? 1 : 0;
+}
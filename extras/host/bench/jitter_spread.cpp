@@ -0,0 +1,72 @@
+/**
+ * @file jitter_spread.cpp
+ * @brief Verifica la distribución de JitterScheduler: para varios porcentajes
+ * y períodos, la media del período programado debe coincidir con el período
+ * y el desplazamiento debe cubrir ±PORCENTAJE % con la dispersión de una
+ * uniforme (desvío estándar = amplitud / sqrt(12)).
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/bench/jitter_spread.cpp -o jitter_spread
+ * Uso:
+ *   ./jitter_spread [muestras=65535]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <StagePolicies.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+template <uint8_t P>
+bool medir(uint32_t periodo_ms, uint32_t muestras) {
+  JitterScheduler<P> sched;
+  sched.seed(0x1234);
+  double suma = 0, suma2 = 0;
+  uint32_t menor = 0xFFFFFFFFUL, mayor = 0;
+  for (uint32_t i = 0; i < muestras; ++i) {
+    sched.schedule(0, periodo_ms);
+    const uint32_t p = sched.nextMs();
+    suma += p;
+    suma2 += (double)p * p;
+    if (p < menor) menor = p;
+    if (p > mayor) mayor = p;
+  }
+  const double media = suma / muestras;
+  const double desvio = std::sqrt(std::max(0.0, suma2 / muestras - media * media));
+  const double amplitud = (double)periodo_ms * P / 50.0;
+  const double errorMedia = (media - periodo_ms) / periodo_ms;
+  // media dentro de 0.1 % (o 1 ms), extremos a menos de 2 % de la amplitud y
+  // desvío estándar a menos de 5 % del de una uniforme
+  const bool ok = std::fabs(media - periodo_ms) <= std::max(1.0, periodo_ms * 0.001)
+               && menor <= periodo_ms - amplitud / 2 * 0.98 && mayor >= periodo_ms + amplitud / 2 * 0.98
+               && std::fabs(desvio - amplitud / std::sqrt(12.0)) <= 0.05 * amplitud / std::sqrt(12.0);
+  printf("P=%-2u periodo_ms=%-8u media=%+.4f%% min=%+.2f%% max=%+.2f%% desvio=%.3f%% (uniforme %.3f%%) %s\n",
+         (unsigned)P, periodo_ms, errorMedia * 100.0, (menor - (double)periodo_ms) * 100.0 / periodo_ms,
+         (mayor - (double)periodo_ms) * 100.0 / periodo_ms, desvio * 100.0 / periodo_ms,
+         amplitud / std::sqrt(12.0) * 100.0 / periodo_ms, ok ? "ok" : "FALLA");
+  return ok;
+}
+
+template <uint8_t P>
+bool medirPeriodos(uint32_t muestras) {
+  bool ok = true;
+  const uint32_t periodos[] = { 5000, 60000, 1200000 };
+  for (uint32_t p : periodos) ok = medir<P>(p, muestras) && ok;
+  return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t muestras = (argc > 1) ? (uint32_t)atoi(argv[1]) : 65535;
+  bool ok = medirPeriodos<1>(muestras);
+  ok = medirPeriodos<2>(muestras) && ok;
+  ok = medirPeriodos<10>(muestras) && ok;
+  ok = medirPeriodos<50>(muestras) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file tick_latency.cpp
+ * @brief Latencia por etapa de tick() medida con TickProfiler en el host:
+ * mínimo, media, máximo y el desglose del tick más lento, con la batería
+ * leída por el ADC (ráfaga de `muestrasPromedioAdc` lecturas) y con el
+ * voltaje inyectado.
+ *
+ * En el host el ADC y delayMicroseconds() del sustituto de Arduino no
+ * cuestan nada, así que los números muestran el costo del código propio; la
+ * ráfaga real (8 × (analogRead + 250 µs) ≈ 2.9 ms en un ATmega328P) sólo se
+ * ve midiendo en la placa.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/bench/tick_latency.cpp -o tick_latency
+ * Uso:
+ *   ./tick_latency [ticks=1000000]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <TickProfiler.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+/** Cuentas del contador por ns, midiendo contra steady_clock. */
+double cuentasPorNs(TickProfiler& p) {
+  const auto t0 = std::chrono::steady_clock::now();
+  const uint32_t c0 = p.now();
+  while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(50)) {}
+  const uint32_t c1 = p.now();
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  return (c1 - c0) / ns;
+}
+
+void correr(const char* nombre, bool conAdc, uint32_t ticks, double escala) {
+  static BasicAdaptiveTXWSN<TickProfiler> nodo;
+  AdaptiveTXWSN::Cfg cfg;
+  if (conAdc) {
+    cfg.pinAdcBateria = A0;
+    cfg.divisorRArriba_k = 0.01f;
+    cfg.divisorRAbajo_k  = 0.99f;
+  }
+  nodo = BasicAdaptiveTXWSN<TickProfiler>();
+  atx::sim::setMillis(0);
+  nodo.tracer().begin();
+  nodo.begin(cfg);
+
+  for (uint32_t i = 0; i < ticks; ++i) {
+    // Recorre los tres niveles y el corte: 4.2 V -> 3.3 V -> 4.2 V
+    const uint32_t fase = (i / 16) % 180;
+    const uint32_t mV = (fase < 90) ? 4200 - fase * 10 : 3300 + (fase - 90) * 10;
+    if (conAdc) atx::sim::setAdcCounts((int)(mV * 1023UL / 5000));
+    else        nodo.setBatteryVolts(mV / 1000.0f);
+    nodo.tick();
+    atx::sim::advanceMillis(100);
+  }
+
+  const char* etapas[ETAPAS] = { "muestreo", "filtrado", "clasificacion", "planificacion", "tick" };
+  printf("%s\n", nombre);
+  printf("  %-14s %10s %10s %10s %10s %12s\n", "etapa", "n", "min_ns", "media_ns", "max_ns", "peor_tick_ns");
+  for (uint8_t e = 0; e < ETAPAS; ++e) {
+    const TickProfiler::Estadistica& s = nodo.tracer().stage((TickStage)e);
+    printf("  %-14s %10u %10.0f %10.0f %10.0f %12.0f\n", etapas[e], s.n, s.min / escala, s.mean() / escala,
+           s.max / escala, nodo.tracer().worstTick((TickStage)e) / escala);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t ticks = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1000000;
+  TickProfiler calibracion;
+  calibracion.begin();
+  const double escala = cuentasPorNs(calibracion);
+  printf("contador=%s cuentas_por_ns=%.3f\n", TickProfiler::UNIDAD, escala);
+  correr("voltaje inyectado", false, ticks, escala);
+  correr("ADC (8 lecturas)", true, ticks, escala);
+  return 0;
+}
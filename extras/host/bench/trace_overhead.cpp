@@ -0,0 +1,90 @@
+/**
+ * @file trace_overhead.cpp
+ * @brief Mide el costo por tick() de cada política de traza de
+ * BasicAdaptiveTXWSN (TracePolicies.h) en el host.
+ *
+ * Cada política corre el mismo barrido de voltaje (descarga lenta con ciclos
+ * de corte) y se reporta ns por tick(), bytes del objeto y eventos
+ * registrados. Los static_assert comprueban que NoTrace es una clase vacía y
+ * que AdaptiveTXWSN es BasicAdaptiveTXWSN<NoTrace>; que NoTrace tampoco agrega
+ * código lo comprueba trace_zero_cost.sh contra una referencia sin ganchos.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/bench/trace_overhead.cpp -o trace_overhead
+ * Uso:
+ *   ./trace_overhead [ticks=2000000]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <TracePolicies.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+
+static_assert(std::is_empty<NoTrace>::value, "NoTrace debe ser una clase vacía");
+static_assert(std::is_same<AdaptiveTXWSN, BasicAdaptiveTXWSN<NoTrace>>::value,
+              "AdaptiveTXWSN debe seguir siendo BasicAdaptiveTXWSN<NoTrace>");
+
+namespace {
+
+// Evita que el compilador descarte el resultado de tick()
+volatile uint32_t sumidero = 0;
+
+/** Voltaje del tick i: rampa 4.2 V -> 3.0 V -> 4.2 V en pasos de 10 mV. */
+float voltaje(uint32_t i) {
+  const uint32_t fase = (i / 64) % 240;
+  const uint32_t mV = (fase < 120) ? 4200 - fase * 10 : 3000 + (fase - 120) * 10;
+  return mV / 1000.0f;
+}
+
+template <class Trace>
+double medir(BasicAdaptiveTXWSN<Trace>& nodo, uint32_t ticks) {
+  atx::sim::setMillis(0);
+  nodo.begin(AdaptiveTXWSN::Cfg());
+  uint32_t envios = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < ticks; ++i) {
+    if ((i & 63) == 0) nodo.setBatteryVolts(voltaje(i));
+    if (nodo.tick()) envios++;
+    atx::sim::advanceMillis(250);
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  sumidero = sumidero + envios;
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / ticks;
+}
+
+template <class Trace>
+void fila(const char* nombre, BasicAdaptiveTXWSN<Trace>& nodo, uint32_t ticks) {
+  const double ns = medir(nodo, ticks);
+  printf("%-14s %10.2f %8zu", nombre, ns, sizeof(nodo));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t ticks = (argc > 1) ? (uint32_t)atoi(argv[1]) : 2000000;
+
+  static BasicAdaptiveTXWSN<NoTrace>       sinTraza;
+  static BasicAdaptiveTXWSN<RingTrace<64>> anillo;
+  static BasicAdaptiveTXWSN<CycleTrace>    ciclos;
+  static BasicAdaptiveTXWSN<GpioTrace<4, 5>> gpio;
+  gpio.tracer().begin();
+
+  printf("%-14s %10s %8s %10s\n", "politica", "ns/tick", "bytes", "eventos");
+  fila("NoTrace", sinTraza, ticks);
+  printf(" %10s\n", "-");
+  fila("RingTrace<64>", anillo, ticks);
+  printf(" %10u\n", (unsigned)anillo.tracer().size());
+  fila("CycleTrace", ciclos, ticks);
+  uint32_t total = 0;
+  for (uint8_t e = 0; e < TRAZA_EVENTOS; ++e) total += ciclos.tracer().count((TraceEvent)e);
+  printf(" %10u\n", (unsigned)total);
+  fila("GpioTrace", gpio, ticks);
+  printf(" %10s\n", "-");
+  return 0;
+}
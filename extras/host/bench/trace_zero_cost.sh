@@ -0,0 +1,77 @@
+#!/bin/sh
+# @file trace_zero_cost.sh
+# @brief Comprueba que la política NoTrace no agrega código a tick().
+#
+# Arma una referencia sin ganchos: copia src/ y borra de AdaptiveTXWSN.h
+# todas las llamadas `Trace::on...(...)`. Compila la misma unidad mínima
+# (begin() y tick() de AdaptiveTXWSN) contra la referencia y contra la
+# librería tal cual, y falla si el código generado difiere (tamaño de .text
+# y desensamblado). Como control, la misma unidad con RingTrace<8> debe dar
+# un código distinto; si no, la comparación no estaría midiendo nada.
+#
+# Uso, desde la raíz del repositorio:
+#   sh extras/host/bench/trace_zero_cost.sh
+# (CXX, SIZE y OBJDUMP se pueden cambiar por variables de entorno.)
+# @authors Francisco Rosales, Omar Tox
+# @date 2025-09
+
+set -e
+CXX=${CXX:-g++}
+SIZE=${SIZE:-size}
+OBJDUMP=${OBJDUMP:-objdump}
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+mkdir "$DIR/ref"
+cp src/*.h "$DIR/ref/"
+sed 's/Trace::on[A-Za-z]*([^;]*);/;/g' src/AdaptiveTXWSN.h > "$DIR/ref/AdaptiveTXWSN.h"
+if [ "$(grep -c 'Trace::on' src/AdaptiveTXWSN.h)" -eq 0 ] || grep -q 'Trace::on' "$DIR/ref/AdaptiveTXWSN.h"; then
+  echo "no se pudieron quitar los ganchos de AdaptiveTXWSN.h FALLA"
+  exit 1
+fi
+
+cat > "$DIR/tick.cpp" <<'FIN'
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <TracePolicies.h>
+
+#ifdef CON_ANILLO
+typedef BasicAdaptiveTXWSN<RingTrace<8> > Nodo;
+#else
+typedef AdaptiveTXWSN Nodo;
+#endif
+Nodo txTimer;
+
+void setup() { txTimer.begin(AdaptiveTXWSN::Cfg()); }
+bool loopTick() { return txTimer.tick(); }
+FIN
+
+compilar() { # $1 = salida, $2 = directorio de la librería, resto = opciones
+  salida=$1; lib=$2; shift 2
+  "$CXX" -std=c++17 -O2 -fno-exceptions -fno-asynchronous-unwind-tables "$@" \
+    -I "$lib" -I extras/host -c "$DIR/tick.cpp" -o "$DIR/$salida.o"
+  "$SIZE" -A "$DIR/$salida.o" | awk '$1 ~ /^\.text/ { s += $2 } END { print s + 0 }' > "$DIR/$salida.tam"
+  "$OBJDUMP" -d "$DIR/$salida.o" | tail -n +4 > "$DIR/$salida.asm"
+}
+
+compilar ref "$DIR/ref"
+compilar notrace src
+compilar anillo src -DCON_ANILLO
+
+REF=$(cat "$DIR/ref.tam")
+NOTRACE=$(cat "$DIR/notrace.tam")
+ANILLO=$(cat "$DIR/anillo.tam")
+FALLA=0
+if [ "$REF" -eq "$NOTRACE" ] && cmp -s "$DIR/ref.asm" "$DIR/notrace.asm"; then
+  echo "sin ganchos: .text=$REF  NoTrace: .text=$NOTRACE  código idéntico ok"
+else
+  echo "sin ganchos: .text=$REF  NoTrace: .text=$NOTRACE  el código difiere FALLA"
+  FALLA=1
+fi
+if cmp -s "$DIR/ref.asm" "$DIR/anillo.asm"; then
+  echo "RingTrace<8>: .text=$ANILLO  igual a la referencia (control) FALLA"
+  FALLA=1
+else
+  echo "RingTrace<8>: .text=$ANILLO  distinto de la referencia (control) ok"
+fi
+exit $FALLA
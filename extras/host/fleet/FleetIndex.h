@@ -0,0 +1,200 @@
+/**
+ * @file FleetIndex.h
+ * @brief Índice de flota ordenado por instante previsto de corte.
+ * Cada nodo corre en el gateway el mismo VoltageTrend que en el dispositivo;
+ * su instante de muerte previsto (llegar a `corteVoltaje_V`) es la clave de
+ * un montículo binario indexado, de modo que cada baliza cuesta O(log n) y
+ * "¿qué K nodos mueren primero?" se responde en O(K log K), independiente
+ * del tamaño de la flota.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <StatusBeacon.h>
+#include <VoltageTrend.h>
+
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace atx {
+
+/**
+ * @class FleetIndex
+ * @brief Montículo mínimo indexado de nodos por instante previsto de corte.
+ */
+class FleetIndex {
+public:
+  static constexpr int64_t NUNCA = INT64_MAX; ///< Clave de nodos que no se están descargando.
+
+  /**
+   * @struct Cfg
+   * @brief Parámetros del índice.
+   */
+  struct Cfg {
+    uint16_t corte_mV              = 3400;      ///< `corteVoltaje_V` de la flota, en mV.
+    uint32_t intervaloTendencia_ms = 3600000UL; ///< Mismo valor que en VoltageTrend::begin() del nodo.
+    uint32_t nodosEsperados        = 100000;    ///< Para reservar memoria.
+  };
+
+  /**
+   * @struct Entry
+   * @brief Resultado de una consulta.
+   */
+  struct Entry {
+    uint32_t nodeId;
+    int64_t  muerte_s;      ///< Instante previsto de corte (s, hora del gateway) o NUNCA.
+    uint16_t mV;            ///< Voltaje suavizado.
+    int32_t  pendiente_uVh; ///< Pendiente de la tendencia.
+    bool     enCorte;       ///< Última baliza reportó isCutoff().
+  };
+
+  void begin(const Cfg& cfg) {
+    _cfg = cfg;
+    _nodos.clear();
+    _monticulo.clear();
+    _indice.clear();
+    _nodos.reserve(cfg.nodosEsperados);
+    _monticulo.reserve(cfg.nodosEsperados);
+    _indice.reserve(cfg.nodosEsperados);
+  }
+
+  /**
+   * @brief Actualiza un nodo con su baliza y reubica su clave. O(log n).
+   * @param b Baliza recibida.
+   * @param ahora_s Hora del gateway en segundos (monótona, 64 bits).
+   */
+  void onBeacon(const StatusBeacon& b, int64_t ahora_s) {
+    uint32_t i = indiceDe(b.nodeId);
+    Nodo& n = _nodos[i];
+    n.tendencia.addSample((uint32_t)(ahora_s * 1000), b.mV);
+    n.enCorte = b.cutoff;
+
+    int64_t clave;
+    if (b.cutoff) {
+      clave = (n.muerte_s != NUNCA && n.muerte_s <= ahora_s) ? n.muerte_s : ahora_s; // ya muerto: se conserva cuándo
+    } else {
+      uint32_t falta = n.tendencia.secondsTo(_cfg.corte_mV);
+      clave = (falta == VoltageTrend::SIN_PREDICCION) ? NUNCA : ahora_s + falta;
+    }
+    cambiarClave(i, clave);
+  }
+
+  /**
+   * @brief Los K nodos con muerte más próxima, en orden. O(K log K).
+   * Se recorre el montículo por menor clave con una frontera auxiliar de a lo
+   * sumo K+1 candidatos (cada extracción saca uno y agrega sus dos hijos), sin
+   * tocar el resto de la flota. Devolverlos ordenados exige Ω(K log K)
+   * comparaciones; la selección O(K) en un montículo (Frederickson) sólo da
+   * el conjunto sin orden y no compensa para los K de una consulta.
+   */
+  std::vector<Entry> topK(size_t k) const {
+    std::vector<Entry> out;
+    if (_monticulo.empty() || k == 0) return out;
+    if (k > _monticulo.size()) k = _monticulo.size();
+    out.reserve(k);
+    typedef std::pair<int64_t, uint32_t> Candidato; // (clave, posición en el montículo)
+    std::vector<Candidato> espacio;
+    espacio.reserve(k + 1);
+    std::priority_queue<Candidato, std::vector<Candidato>, std::greater<Candidato>> frontera(
+        std::greater<Candidato>(), std::move(espacio));
+    frontera.push(Candidato(_nodos[_monticulo[0]].muerte_s, 0));
+    while (!frontera.empty() && out.size() < k) {
+      uint32_t pos = frontera.top().second;
+      frontera.pop();
+      out.push_back(entrada(_monticulo[pos]));
+      for (uint32_t h = 2 * pos + 1; h <= 2 * pos + 2 && h < _monticulo.size(); ++h) {
+        frontera.push(Candidato(_nodos[_monticulo[h]].muerte_s, h));
+      }
+    }
+    return out;
+  }
+
+  /** @brief Consulta un nodo; `false` si no se conoce. */
+  bool find(uint32_t nodeId, Entry& out) const {
+    auto it = _indice.find(nodeId);
+    if (it == _indice.end()) return false;
+    out = entrada(it->second);
+    return true;
+  }
+
+  /** @brief Nodos en el índice. */
+  size_t size() const { return _monticulo.size(); }
+
+private:
+  struct Nodo {
+    uint32_t     nodeId   = 0;
+    uint32_t     posicion = 0;     ///< Posición en `_monticulo`.
+    int64_t      muerte_s = NUNCA;
+    bool         enCorte  = false;
+    VoltageTrend tendencia;
+  };
+
+  Cfg                                    _cfg;
+  std::vector<Nodo>                      _nodos;
+  std::vector<uint32_t>                  _monticulo; ///< Índices en `_nodos`, ordenados como montículo mínimo.
+  std::unordered_map<uint32_t, uint32_t> _indice;
+
+  Entry entrada(uint32_t i) const {
+    const Nodo& n = _nodos[i];
+    return Entry{ n.nodeId, n.muerte_s, n.tendencia.smoothedMv(), n.tendencia.slopeUvPerHour(), n.enCorte };
+  }
+
+  uint32_t indiceDe(uint32_t nodeId) {
+    auto it = _indice.find(nodeId);
+    if (it != _indice.end()) return it->second;
+    uint32_t i = (uint32_t)_nodos.size();
+    _nodos.emplace_back();
+    Nodo& n = _nodos.back();
+    n.nodeId = nodeId;
+    n.tendencia.begin(_cfg.intervaloTendencia_ms);
+    n.posicion = (uint32_t)_monticulo.size();
+    _monticulo.push_back(i);
+    _indice.emplace(nodeId, i);
+    return i;
+  }
+
+  void cambiarClave(uint32_t i, int64_t clave) {
+    int64_t anterior = _nodos[i].muerte_s;
+    _nodos[i].muerte_s = clave;
+    if (clave < anterior) subir(_nodos[i].posicion);
+    else if (clave > anterior) bajar(_nodos[i].posicion);
+  }
+
+  void colocar(uint32_t pos, uint32_t i) {
+    _monticulo[pos] = i;
+    _nodos[i].posicion = pos;
+  }
+
+  void subir(uint32_t pos) {
+    uint32_t i = _monticulo[pos];
+    int64_t clave = _nodos[i].muerte_s;
+    while (pos > 0) {
+      uint32_t padre = (pos - 1) / 2;
+      if (_nodos[_monticulo[padre]].muerte_s <= clave) break;
+      colocar(pos, _monticulo[padre]);
+      pos = padre;
+    }
+    colocar(pos, i);
+  }
+
+  void bajar(uint32_t pos) {
+    uint32_t i = _monticulo[pos];
+    int64_t clave = _nodos[i].muerte_s;
+    const uint32_t n = (uint32_t)_monticulo.size();
+    for (;;) {
+      uint32_t h = 2 * pos + 1;
+      if (h >= n) break;
+      if (h + 1 < n && _nodos[_monticulo[h + 1]].muerte_s < _nodos[_monticulo[h]].muerte_s) h++;
+      if (_nodos[_monticulo[h]].muerte_s >= clave) break;
+      colocar(pos, _monticulo[h]);
+      pos = h;
+    }
+    colocar(pos, i);
+  }
+};
+
+} // namespace atx
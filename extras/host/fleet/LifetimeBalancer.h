@@ -0,0 +1,175 @@
+/**
+ * @file LifetimeBalancer.h
+ * @brief Balanceo de vida útil de la flota mediante multiplicadores de período.
+ * Todos los nodos corren los mismos períodos del `Cfg`, pero los de celdas
+ * débiles o peores enlaces mueren meses antes. El gateway calcula para cada
+ * nodo un multiplicador (AdaptiveTXWSN::setPeriodMultiplier()) que iguala
+ * los instantes previstos de muerte sin bajar de una tasa mínima de datos y
+ * conservando la tasa total de la flota.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <StatusBeacon.h>
+#include <VoltageTrend.h>
+
+#include <cmath>
+#include <vector>
+
+namespace atx {
+
+/**
+ * @class LifetimeBalancer
+ * @brief Resuelve multiplicadores por bisección sobre la vida objetivo común.
+ *
+ * Modelo por nodo (a partir de su baliza v2):
+ *  - I   = consumo medio actual (µA), f = fracción de I debida a los envíos,
+ *  - m0  = multiplicador actual, T0 = vida restante prevista por VoltageTrend,
+ *  - Q   = T0 * I (carga restante),
+ *  - I(m) = I*(1-f) + I*f*m0/m, y la vida con multiplicador m es T(m) = Q / I(m).
+ * Para una vida objetivo T cada nodo necesita m(T) (acotado a [multMin, multMax]);
+ * se busca la T cuya suma de tasas 1/m(T) iguala la suma actual.
+ */
+class LifetimeBalancer {
+public:
+  /**
+   * @struct Cfg
+   * @brief Límites del balanceo.
+   */
+  struct Cfg {
+    float    multiplicadorMinimo = 0.25f; ///< Nodo más rápido: 4x la tasa nominal.
+    float    multiplicadorMaximo = 4.0f;  ///< Tasa mínima de datos: no más de 4x el período nominal.
+    uint8_t  iteraciones         = 60;    ///< Pasos de bisección (en escala logarítmica).
+  };
+
+  /**
+   * @struct NodeInput
+   * @brief Lo que el gateway sabe de un nodo.
+   */
+  struct NodeInput {
+    uint32_t nodeId           = 0;
+    uint32_t vidaRestante_s   = VoltageTrend::SIN_PREDICCION; ///< VoltageTrend::secondsTo(corte) con el multiplicador actual.
+    uint16_t consumo_uA       = 0;   ///< StatusBeacon::consumo_uA.
+    uint8_t  fraccionEnvio_q8 = 0;   ///< StatusBeacon::fraccionEnvio_q8.
+    uint16_t multiplicador_q8 = 256; ///< StatusBeacon::multiplicador_q8.
+  };
+
+  /**
+   * @struct Result
+   * @brief Resumen de la solución.
+   */
+  struct Result {
+    double   vidaObjetivo_s      = 0; ///< Vida común alcanzada por los nodos no saturados.
+    double   vidaMinimaAntes_s   = 0; ///< Peor vida prevista con los multiplicadores actuales.
+    double   vidaMinimaDespues_s = 0; ///< Peor vida prevista con los nuevos multiplicadores.
+    uint32_t balanceados         = 0; ///< Nodos con predicción que entraron al balanceo.
+    uint32_t saturados           = 0; ///< Nodos que quedaron en el multiplicador mínimo o máximo.
+  };
+
+  void begin(const Cfg& cfg) { _cfg = cfg; }
+
+  /**
+   * @brief Construye la entrada de un nodo a partir de su baliza y su tendencia.
+   */
+  static NodeInput inputFrom(const StatusBeacon& b, uint32_t vidaRestante_s) {
+    NodeInput in;
+    in.nodeId           = b.nodeId;
+    in.vidaRestante_s   = b.cutoff ? 0 : vidaRestante_s;
+    in.consumo_uA       = b.consumo_uA;
+    in.fraccionEnvio_q8 = b.fraccionEnvio_q8;
+    in.multiplicador_q8 = b.multiplicador_q8;
+    return in;
+  }
+
+  /**
+   * @brief Calcula los nuevos multiplicadores.
+   * @param nodos Entradas de la flota.
+   * @param multiplicadores_q8 Salida, uno por nodo en el mismo orden (Q8.8).
+   *        Los nodos sin predicción conservan su multiplicador.
+   */
+  Result solve(const std::vector<NodeInput>& nodos, std::vector<uint16_t>& multiplicadores_q8) {
+    const size_t n = nodos.size();
+    multiplicadores_q8.resize(n);
+    _modelo.resize(n);
+
+    Result r;
+    double tasaObjetivo = 0, vidaMin = INFINITY, tMin = INFINITY, tMax = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const NodeInput& in = nodos[i];
+      Modelo& m = _modelo[i];
+      m.m0 = in.multiplicador_q8 / 256.0;
+      m.activo = in.vidaRestante_s != VoltageTrend::SIN_PREDICCION && in.vidaRestante_s > 0 && in.consumo_uA > 0;
+      if (!m.activo) { multiplicadores_q8[i] = in.multiplicador_q8; continue; }
+      const double I = in.consumo_uA, f = in.fraccionEnvio_q8 / 255.0;
+      m.base  = I * (1.0 - f);
+      m.envio = I * f * m.m0;              // corriente de envío a multiplicador 1.0
+      m.carga = (double)in.vidaRestante_s * I;
+      tasaObjetivo += 1.0 / m.m0;
+      vidaMin = std::min(vidaMin, (double)in.vidaRestante_s);
+      tMin = std::min(tMin, vida(m, _cfg.multiplicadorMinimo));
+      tMax = std::max(tMax, vida(m, _cfg.multiplicadorMaximo));
+      r.balanceados++;
+    }
+    if (r.balanceados == 0) return r;
+    r.vidaMinimaAntes_s = vidaMin;
+
+    // tasa(T) decrece con T: bisección geométrica entre la vida más corta y la más larga alcanzables
+    double lo = std::max(tMin, 1.0), hi = std::max(tMax, lo * 1.0001);
+    for (uint8_t k = 0; k < _cfg.iteraciones; ++k) {
+      double T = std::sqrt(lo * hi);
+      if (tasa(T) > tasaObjetivo) lo = T; else hi = T;
+    }
+    r.vidaObjetivo_s = std::sqrt(lo * hi);
+
+    double vidaMinDespues = INFINITY;
+    for (size_t i = 0; i < n; ++i) {
+      const Modelo& m = _modelo[i];
+      if (!m.activo) continue;
+      double mult = multiplicadorPara(m, r.vidaObjetivo_s);
+      if (mult <= _cfg.multiplicadorMinimo || mult >= _cfg.multiplicadorMaximo) r.saturados++;
+      long q8 = lround(mult * 256.0);
+      multiplicadores_q8[i] = (uint16_t)((q8 < 1) ? 1 : (q8 > 65535) ? 65535 : q8);
+      vidaMinDespues = std::min(vidaMinDespues, vida(m, multiplicadores_q8[i] / 256.0));
+    }
+    r.vidaMinimaDespues_s = vidaMinDespues;
+    return r;
+  }
+
+  /**
+   * @brief Vida prevista de la entrada `i` del último solve() con un multiplicador dado.
+   */
+  double predictedLifetime(size_t i, double multiplicador) const {
+    return _modelo[i].activo ? vida(_modelo[i], multiplicador) : INFINITY;
+  }
+
+private:
+  struct Modelo {
+    double base   = 0;  ///< Corriente que no depende del período (µA).
+    double envio  = 0;  ///< Corriente de envío con multiplicador 1.0 (µA).
+    double carga  = 0;  ///< Carga restante (µA·s).
+    double m0     = 1;
+    bool   activo = false;
+  };
+
+  Cfg                 _cfg;
+  std::vector<Modelo> _modelo;
+
+  static double vida(const Modelo& m, double mult) { return m.carga / (m.base + m.envio / mult); }
+
+  double multiplicadorPara(const Modelo& m, double T) const {
+    const double corrientePermitida = m.carga / T;
+    if (corrientePermitida <= m.base) return _cfg.multiplicadorMaximo;
+    double mult = m.envio / (corrientePermitida - m.base);
+    return std::min(std::max(mult, (double)_cfg.multiplicadorMinimo), (double)_cfg.multiplicadorMaximo);
+  }
+
+  double tasa(double T) const {
+    double suma = 0;
+    for (const Modelo& m : _modelo) if (m.activo) suma += 1.0 / multiplicadorPara(m, T);
+    return suma;
+  }
+};
+
+} // namespace atx
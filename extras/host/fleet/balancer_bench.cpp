@@ -0,0 +1,85 @@
+/**
+ * @file balancer_bench.cpp
+ * @brief Banco de pruebas de LifetimeBalancer sobre una flota sintética.
+ * Cada nodo tiene capacidad de celda y costo de enlace (reintentos) aleatorios;
+ * su EnergyLedger se simula con los mismos costos que en el dispositivo y la
+ * baliza v2 resultante alimenta el balanceador. Se reporta la dispersión de
+ * los instantes de muerte antes y después, y el tiempo de resolución.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/fleet/balancer_bench.cpp -o balancer_bench
+ * Uso:
+ *   ./balancer_bench [nodos=100000]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include "LifetimeBalancer.h"
+#include <EnergyLedger.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+double percentil(std::vector<double> v, double p) {
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(p * (double)(v.size() - 1))];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t nNodos = (argc > 1) ? (uint32_t)strtoul(argv[1], nullptr, 10) : 100000;
+  std::mt19937 rng(2025);
+  std::uniform_real_distribution<double> capacidad_mAh(600.0, 2400.0);  // celdas débiles y sanas
+  std::uniform_int_distribution<int>     reintentos(1, 4);               // calidad de enlace
+  const uint32_t periodo_ms = 15000;                                     // todos en BATT_MID
+
+  std::vector<atx::LifetimeBalancer::NodeInput> entradas(nNodos);
+  std::vector<double> vidasAntes(nNodos);
+  for (uint32_t i = 0; i < nNodos; ++i) {
+    // Un día de operación con el libro del dispositivo para obtener consumo y fracción de envío
+    EnergyLedger::Cfg costos;
+    costos.cargaEnvio_uC = 2500u * (uint32_t)reintentos(rng);
+    EnergyLedger libro;
+    libro.begin(costos, 0);
+    for (uint32_t t = periodo_ms; t <= 86400000UL; t += periodo_ms) libro.onTick(t, true);
+
+    StatusBeacon b;
+    b.nodeId           = i;
+    b.consumo_uA       = libro.averageCurrentUa();
+    b.fraccionEnvio_q8 = libro.sendShareQ8();
+    b.multiplicador_q8 = 256;
+    // Lo que predeciría VoltageTrend: carga restante / consumo
+    double vida_s = capacidad_mAh(rng) * 3600.0 * 1000.0 / b.consumo_uA;
+    vidasAntes[i] = vida_s;
+    entradas[i] = atx::LifetimeBalancer::inputFrom(b, (uint32_t)vida_s);
+  }
+
+  atx::LifetimeBalancer balanceador;
+  balanceador.begin(atx::LifetimeBalancer::Cfg());
+  std::vector<uint16_t> multiplicadores;
+  auto t0 = std::chrono::steady_clock::now();
+  atx::LifetimeBalancer::Result r = balanceador.solve(entradas, multiplicadores);
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+  std::vector<double> vidasDespues(nNodos);
+  double tasaAntes = 0, tasaDespues = 0;
+  for (uint32_t i = 0; i < nNodos; ++i) {
+    vidasDespues[i] = balanceador.predictedLifetime(i, multiplicadores[i] / 256.0);
+    tasaAntes   += 1.0;
+    tasaDespues += 256.0 / multiplicadores[i];
+  }
+  const double dia = 86400.0;
+  printf("nodos=%u resolucion_ms=%.1f saturados=%u vida_objetivo_dias=%.1f\n",
+         nNodos, ms, r.saturados, r.vidaObjetivo_s / dia);
+  printf("antes:   min=%.1f p10=%.1f p50=%.1f p90=%.1f dias\n", r.vidaMinimaAntes_s / dia,
+         percentil(vidasAntes, 0.1) / dia, percentil(vidasAntes, 0.5) / dia, percentil(vidasAntes, 0.9) / dia);
+  printf("despues: min=%.1f p10=%.1f p50=%.1f p90=%.1f dias\n", r.vidaMinimaDespues_s / dia,
+         percentil(vidasDespues, 0.1) / dia, percentil(vidasDespues, 0.5) / dia, percentil(vidasDespues, 0.9) / dia);
+  printf("tasa_total_relativa=%.4f\n", tasaDespues / tasaAntes);
+  return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file fleet_query.cpp
+ * @brief CLI y banco de pruebas de FleetIndex: "¿qué K nodos mueren primero?".
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/fleet/fleet_query.cpp -o fleet_query
+ * Uso:
+ *   ./fleet_query bench <nodos> <dias> [K=50]
+ *       Flota sintética con descarga lineal de pendiente aleatoria; mide el costo
+ *       por baliza y por consulta y compara la predicción con la muerte real.
+ *   ./beacon_loadgen 100000 2000000 | ./fleet_query pipe [K=50] [corte_mV=3400]
+ *       Lee StatusBeacon de stdin (hora de recepción = reloj del gateway).
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include "FleetIndex.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <unistd.h>
+
+namespace {
+
+typedef std::chrono::steady_clock Reloj;
+
+double nsDesde(Reloj::time_point t0) {
+  return std::chrono::duration<double, std::nano>(Reloj::now() - t0).count();
+}
+
+void imprimir(const std::vector<atx::FleetIndex::Entry>& top, int64_t ahora_s) {
+  printf("%-4s %-8s %-8s %-12s %s\n", "#", "nodo", "mV", "uV_h", "horas_restantes");
+  for (size_t i = 0; i < top.size(); ++i) {
+    const atx::FleetIndex::Entry& e = top[i];
+    if (e.muerte_s == atx::FleetIndex::NUNCA)
+      printf("%-4zu %-8u %-8u %-12d %s\n", i + 1, e.nodeId, e.mV, e.pendiente_uVh, "-");
+    else
+      printf("%-4zu %-8u %-8u %-12d %.1f%s\n", i + 1, e.nodeId, e.mV, e.pendiente_uVh,
+             (double)(e.muerte_s - ahora_s) / 3600.0, e.enCorte ? " (corte)" : "");
+  }
+}
+
+int bench(uint32_t nNodos, double dias, size_t k) {
+  std::mt19937 rng(99);
+  std::uniform_real_distribution<float> inicio(3.7f, 4.15f), horasVida(24.0f * 5, 24.0f * 90);
+  std::normal_distribution<float> ruido(0.0f, 0.005f);
+  const uint32_t periodo_s = 600; // balizas cada 10 min por nodo
+  const float corte_V = 3.40f;
+
+  std::vector<float> v0(nNodos), pendiente_Vs(nNodos);
+  std::vector<uint8_t> seq(nNodos, 0);
+  for (uint32_t i = 0; i < nNodos; ++i) {
+    v0[i] = inicio(rng);
+    pendiente_Vs[i] = (v0[i] - corte_V) / (horasVida(rng) * 3600.0f);
+  }
+
+  atx::FleetIndex::Cfg cfg;
+  cfg.nodosEsperados = nNodos;
+  atx::FleetIndex indice;
+  indice.begin(cfg);
+
+  uint64_t actualizaciones = 0;
+  double nsTotal = 0;
+  const int64_t fin_s = (int64_t)(dias * 86400.0);
+  for (int64_t t = 0; t < fin_s; t += periodo_s) {
+    auto t0 = Reloj::now();
+    for (uint32_t i = 0; i < nNodos; ++i) {
+      // Nodos escalonados dentro del período para que no lleguen todos a la vez
+      int64_t ti = t + (int64_t)(i % periodo_s);
+      float v = v0[i] - pendiente_Vs[i] * (float)ti + ruido(rng);
+      StatusBeacon b;
+      b.nodeId = i;
+      b.seq = seq[i]++;
+      b.mV = (uint16_t)(v * 1000.0f + 0.5f);
+      b.cutoff = v < corte_V;
+      indice.onBeacon(b, ti);
+    }
+    nsTotal += nsDesde(t0);
+    actualizaciones += nNodos;
+  }
+
+  auto tq = Reloj::now();
+  const int REPETICIONES = 1000;
+  std::vector<atx::FleetIndex::Entry> top;
+  for (int r = 0; r < REPETICIONES; ++r) top = indice.topK(k);
+  const double usConsulta = nsDesde(tq) / REPETICIONES / 1000.0;
+
+  imprimir(top, fin_s);
+  double errorAbs_h = 0;
+  size_t conPrediccion = 0;
+  for (const auto& e : top) {
+    if (e.muerte_s == atx::FleetIndex::NUNCA || e.enCorte) continue;
+    double real_s = (v0[e.nodeId] - corte_V) / pendiente_Vs[e.nodeId];
+    errorAbs_h += fabs((double)e.muerte_s - real_s) / 3600.0;
+    conPrediccion++;
+  }
+  printf("nodos=%u balizas=%llu ns_por_baliza=%.1f us_por_topK=%.2f error_medio_topK_h=%.2f\n",
+         nNodos, (unsigned long long)actualizaciones, nsTotal / (double)actualizaciones, usConsulta,
+         conPrediccion ? errorAbs_h / conPrediccion : 0.0);
+  return 0;
+}
+
+int pipe(size_t k, uint16_t corte_mV) {
+  atx::FleetIndex::Cfg cfg;
+  cfg.corte_mV = corte_mV;
+  atx::FleetIndex indice;
+  indice.begin(cfg);
+  const auto inicio = Reloj::now();
+  auto ahora_s = [&] { return (int64_t)std::chrono::duration_cast<std::chrono::seconds>(Reloj::now() - inicio).count(); };
+
+  uint8_t buf[StatusBeacon::TAMANO_MAXIMO * 64];
+  size_t pendiente = 0;
+  StatusBeacon b;
+  for (;;) {
+    ssize_t r = read(0, buf + pendiente, sizeof(buf) - pendiente);
+    if (r <= 0) break;
+    size_t total = pendiente + (size_t)r, off = 0;
+    int64_t t = ahora_s();
+    while (off < total) {
+      const size_t n = StatusBeacon::frameSize(buf + off, total - off);
+      if (n == 0) { off++; continue; } // versión desconocida: resincronizar
+      if (n > total - off) break;
+      if (StatusBeacon::decode(buf + off, (uint8_t)(n < 255 ? n : 255), b)) indice.onBeacon(b, t);
+      off += n;
+    }
+    pendiente = total - off;
+    memmove(buf, buf + off, pendiente);
+  }
+  imprimir(indice.topK(k), ahora_s());
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 4 && strcmp(argv[1], "bench") == 0)
+    return bench((uint32_t)atoi(argv[2]), atof(argv[3]), (argc > 4) ? (size_t)atoi(argv[4]) : 50);
+  if (argc >= 2 && strcmp(argv[1], "pipe") == 0)
+    return pipe((argc > 2) ? (size_t)atoi(argv[2]) : 50, (argc > 3) ? (uint16_t)atoi(argv[3]) : 3400);
+  fprintf(stderr, "uso: fleet_query bench <nodos> <dias> [K]\n"
+                  "     fleet_query pipe [K] [corte_mV]\n");
+  return 2;
+}
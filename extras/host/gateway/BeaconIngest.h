@@ -0,0 +1,287 @@
+/**
+ * @file BeaconIngest.h
+ * @brief Canal de ingesta de balizas de estado para el gateway.
+ * Los lectores (socket UDP local o tubería) decodifican `StatusBeacon` y los
+ * reparten por `nodeId` entre colas MPSC sin bloqueos; cada fragmento
+ * (shard) tiene un hilo trabajador que es el único dueño del estado de sus
+ * nodos, así que la actualización no necesita candados.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <StatusBeacon.h>
+#include "MpscQueue.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace atx {
+
+/**
+ * @class BeaconIngest
+ * @brief Reparte balizas entre trabajadores fragmentados por nodo.
+ */
+class BeaconIngest {
+public:
+  /**
+   * @struct Cfg
+   * @brief Dimensionamiento del canal.
+   */
+  struct Cfg {
+    uint8_t  fragmentos       = 4;      ///< Hilos trabajadores (shards).
+    uint32_t capacidadCola    = 65536;  ///< Celdas por cola de fragmento.
+    uint32_t nodosEsperados   = 100000; ///< Para reservar las tablas de estado.
+  };
+
+  /**
+   * @struct NodeState
+   * @brief Estado por nodo mantenido por su fragmento.
+   */
+  struct NodeState {
+    uint32_t ultimaRx_ms = 0;  ///< Hora de recepción de la última baliza.
+    uint32_t balizas     = 0;  ///< Balizas recibidas.
+    uint32_t perdidas    = 0;  ///< Huecos detectados en `seq`.
+    uint32_t periodo_ms  = 0;  ///< Período anunciado.
+    uint16_t mV          = 0;  ///< Equivalente a lastVolts() en mV.
+    uint8_t  level       = 0;  ///< Equivalente a level().
+    uint8_t  seq         = 0;  ///< Última secuencia vista.
+    bool     cutoff      = false; ///< Equivalente a isCutoff().
+  };
+
+  /**
+   * @brief Crea las colas y arranca los hilos trabajadores.
+   * @param cfg Dimensionamiento.
+   */
+  void begin(const Cfg& cfg) {
+    _cfg = cfg;
+    if (_cfg.fragmentos == 0) _cfg.fragmentos = 1;
+    _corriendo.store(true);
+    for (uint8_t i = 0; i < _cfg.fragmentos; ++i) {
+      _fragmentos.emplace_back(new Fragmento(_cfg.capacidadCola));
+      _fragmentos.back()->nodos.reserve(_cfg.nodosEsperados / _cfg.fragmentos + 1);
+    }
+    for (uint8_t i = 0; i < _cfg.fragmentos; ++i) {
+      _fragmentos[i]->hilo = std::thread([this, i] { trabajar(*_fragmentos[i]); });
+    }
+  }
+
+  /**
+   * @brief Vacía las colas y detiene los trabajadores.
+   * Llamar cuando ningún productor siga encolando (lectores terminados).
+   */
+  void stop() {
+    _corriendo.store(false);
+    for (auto& f : _fragmentos) if (f->hilo.joinable()) f->hilo.join();
+  }
+
+  ~BeaconIngest() { stop(); }
+
+  /**
+   * @brief Encola una baliza ya decodificada (seguro desde cualquier hilo).
+   * Si la cola del fragmento está llena se espera (sin pérdidas).
+   */
+  void push(const StatusBeacon& b, uint32_t rx_ms) {
+    Fragmento& f = *_fragmentos[fragmentoDe(b.nodeId)];
+    Entrada e{ b, rx_ms };
+    while (!f.cola.tryPush(e)) {
+      f.esperas.fetch_add(1, std::memory_order_relaxed);
+      std::this_thread::yield();
+    }
+  }
+
+  /**
+   * @brief Decodifica un bloque con una o más balizas consecutivas (de
+   * cualquier versión y con o sin extensiones) y las encola.
+   * Una versión desconocida o una trama truncada descarta el resto del bloque.
+   * @return size_t Balizas válidas encoladas.
+   */
+  size_t pushRaw(const uint8_t* datos, size_t len, uint32_t rx_ms) {
+    size_t n = 0;
+    if (recorrer(datos, len, rx_ms, false, n) < len) _invalidas.fetch_add(1, std::memory_order_relaxed);
+    return n;
+  }
+
+  /**
+   * @brief Lee balizas de un descriptor de flujo (tubería, stdin) hasta EOF.
+   * Las tramas pueden llegar partidas entre lecturas; ante una versión
+   * desconocida se avanza un byte para resincronizar.
+   */
+  void readStream(int fd) {
+    std::vector<uint8_t> buf(StatusBeacon::TAMANO_MAXIMO * 256);
+    size_t pendiente = 0, n = 0;
+    for (;;) {
+      ssize_t r = ::read(fd, buf.data() + pendiente, buf.size() - pendiente);
+      if (r < 0 && errno == EINTR) continue;
+      if (r <= 0) break;
+      size_t total = pendiente + (size_t)r;
+      size_t util  = recorrer(buf.data(), total, ahora_ms(), true, n);
+      pendiente = total - util;
+      memmove(buf.data(), buf.data() + util, pendiente);
+    }
+  }
+
+  /**
+   * @brief Lee datagramas UDP (cada uno con 1..N balizas) con recvmmsg().
+   * Termina cuando `continuar` pasa a false (revisado tras cada lote o
+   * timeout del socket) o ante un error del socket que no sea EINTR/EAGAIN
+   * (contado en readErrors()).
+   */
+  void readUdp(int sock, const std::atomic<bool>& continuar) {
+    const unsigned LOTE = 64, MAX_DGRAMA = 1500;
+    std::vector<uint8_t> buf(LOTE * MAX_DGRAMA);
+    mmsghdr mensajes[LOTE];
+    iovec   iovs[LOTE];
+    for (unsigned i = 0; i < LOTE; ++i) {
+      iovs[i].iov_base = buf.data() + i * MAX_DGRAMA;
+      iovs[i].iov_len  = MAX_DGRAMA;
+      memset(&mensajes[i], 0, sizeof(mensajes[i]));
+      mensajes[i].msg_hdr.msg_iov    = &iovs[i];
+      mensajes[i].msg_hdr.msg_iovlen = 1;
+    }
+    while (continuar.load(std::memory_order_relaxed)) {
+      int n = recvmmsg(sock, mensajes, LOTE, MSG_WAITFORONE, nullptr);
+      if (n < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) continue;
+        _erroresLectura.fetch_add(1, std::memory_order_relaxed);
+        break;
+      }
+      uint32_t t = ahora_ms();
+      for (int i = 0; i < n; ++i) pushRaw((const uint8_t*)iovs[i].iov_base, mensajes[i].msg_len, t);
+    }
+  }
+
+  /**
+   * @brief Recorre el estado de todos los nodos. Llamar sólo con los
+   * trabajadores detenidos (tras stop()).
+   * @param fn Callable `void(uint32_t nodeId, const NodeState&)`.
+   */
+  template <class Fn>
+  void forEachNode(Fn&& fn) const {
+    for (auto& f : _fragmentos) for (auto& kv : f->nodos) fn(kv.first, kv.second);
+  }
+
+  /** @brief Balizas aplicadas al estado por todos los fragmentos. */
+  uint64_t processed() const {
+    uint64_t n = 0;
+    for (auto& f : _fragmentos) n += f->procesadas.load(std::memory_order_relaxed);
+    return n;
+  }
+
+  /** @brief Veces que un productor encontró una cola llena. */
+  uint64_t stalls() const {
+    uint64_t n = 0;
+    for (auto& f : _fragmentos) n += f->esperas.load(std::memory_order_relaxed);
+    return n;
+  }
+
+  /** @brief Registros descartados por versión o formato inválido. */
+  uint64_t invalid() const { return _invalidas.load(std::memory_order_relaxed); }
+
+  /** @brief Lectores UDP que terminaron por un error del socket. */
+  uint64_t readErrors() const { return _erroresLectura.load(std::memory_order_relaxed); }
+
+  /** @brief Hora monótona del gateway en ms. */
+  static uint32_t ahora_ms() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+private:
+  struct Entrada {
+    StatusBeacon baliza;
+    uint32_t     rx_ms;
+  };
+
+  struct Fragmento {
+    explicit Fragmento(size_t capacidad) : cola(capacidad) {}
+    MpscQueue<Entrada>                      cola;
+    std::unordered_map<uint32_t, NodeState> nodos;
+    std::thread                             hilo;
+    std::atomic<uint64_t>                   procesadas{0};
+    std::atomic<uint64_t>                   esperas{0};
+  };
+
+  Cfg                                     _cfg;
+  std::vector<std::unique_ptr<Fragmento>> _fragmentos;
+  std::atomic<bool>                       _corriendo{false};
+  std::atomic<uint64_t>                   _invalidas{0};
+  std::atomic<uint64_t>                   _erroresLectura{0};
+
+  uint32_t fragmentoDe(uint32_t nodeId) const {
+    uint32_t h = nodeId * 2654435761u; // hash multiplicativo de Knuth
+    return (uint32_t)(((uint64_t)h * _cfg.fragmentos) >> 32);
+  }
+
+  /**
+   * @brief Encola las tramas completas de `datos` avanzando por frameSize().
+   * @param flujo true: una versión desconocida avanza un byte; false: termina.
+   * @param n Se incrementa con las balizas encoladas.
+   * @return size_t Bytes consumidos (el resto es una trama incompleta).
+   */
+  size_t recorrer(const uint8_t* datos, size_t len, uint32_t rx_ms, bool flujo, size_t& n) {
+    StatusBeacon b;
+    size_t off = 0;
+    while (off < len) {
+      const size_t t = StatusBeacon::frameSize(datos + off, len - off);
+      if (t == 0) {
+        _invalidas.fetch_add(1, std::memory_order_relaxed);
+        if (!flujo) return len;
+        off++;
+        continue;
+      }
+      if (t > len - off) break;
+      if (StatusBeacon::decode(datos + off, (uint8_t)(t < 255 ? t : 255), b)) { push(b, rx_ms); n++; }
+      else _invalidas.fetch_add(1, std::memory_order_relaxed);
+      off += t;
+    }
+    return off;
+  }
+
+  void trabajar(Fragmento& f) {
+    const size_t LOTE = 256;
+    Entrada lote[LOTE];
+    for (;;) {
+      size_t n = f.cola.popBatch(lote, LOTE);
+      if (n == 0) {
+        if (!_corriendo.load(std::memory_order_acquire)) {
+          // Última pasada: nada más puede estar en vuelo tras stop()
+          if ((n = f.cola.popBatch(lote, LOTE)) == 0) return;
+        } else {
+          std::this_thread::yield();
+          continue;
+        }
+      }
+      for (size_t i = 0; i < n; ++i) aplicar(f, lote[i]);
+      f.procesadas.fetch_add(n, std::memory_order_release);
+    }
+  }
+
+  static void aplicar(Fragmento& f, const Entrada& e) {
+    const StatusBeacon& b = e.baliza;
+    NodeState& s = f.nodos[b.nodeId];
+    if (s.balizas > 0) {
+      uint8_t salto = (uint8_t)(b.seq - s.seq);
+      if (salto > 1 && salto < 128) s.perdidas += salto - 1;
+    }
+    s.balizas++;
+    s.seq         = b.seq;
+    s.mV          = b.mV;
+    s.level       = b.level;
+    s.cutoff      = b.cutoff;
+    s.periodo_ms  = b.periodo_ms;
+    s.ultimaRx_ms = e.rx_ms;
+  }
+};
+
+} // namespace atx
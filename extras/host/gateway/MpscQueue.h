@@ -0,0 +1,90 @@
+/**
+ * @file MpscQueue.h
+ * @brief Cola acotada sin bloqueos para varios productores y un consumidor.
+ * Anillo con número de secuencia por celda (esquema de D. Vyukov): los
+ * productores reservan posición con un CAS sobre la cola y el consumidor
+ * único avanza la cabeza sin operaciones atómicas de lectura-modificación.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace atx {
+
+/**
+ * @class MpscQueue
+ * @brief Cola MPSC acotada; `T` debe ser trivialmente copiable.
+ */
+template <class T>
+class MpscQueue {
+public:
+  /**
+   * @brief Reserva el anillo.
+   * @param capacidad Número de celdas; se redondea a potencia de 2.
+   */
+  explicit MpscQueue(size_t capacidad) {
+    size_t n = 2;
+    while (n < capacidad) n <<= 1;
+    _mascara = n - 1;
+    _celdas.reset(new Celda[n]);
+    for (size_t i = 0; i < n; ++i) _celdas[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Intenta encolar un elemento (seguro desde cualquier hilo).
+   * @return false Si la cola está llena.
+   */
+  bool tryPush(const T& v) {
+    size_t pos = _cola.load(std::memory_order_relaxed);
+    for (;;) {
+      Celda& c = _celdas[pos & _mascara];
+      size_t seq = c.seq.load(std::memory_order_acquire);
+      intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+      if (dif == 0) {
+        if (_cola.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          c.dato = v;
+          c.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        return false; // llena
+      } else {
+        pos = _cola.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Desencola hasta `max` elementos (sólo desde el hilo consumidor).
+   * @return size_t Elementos copiados en `out`.
+   */
+  size_t popBatch(T* out, size_t max) {
+    size_t n = 0;
+    while (n < max) {
+      Celda& c = _celdas[_cabeza & _mascara];
+      if (c.seq.load(std::memory_order_acquire) != _cabeza + 1) break;
+      out[n++] = c.dato;
+      c.seq.store(_cabeza + _mascara + 1, std::memory_order_release);
+      _cabeza++;
+    }
+    return n;
+  }
+
+private:
+  struct Celda {
+    std::atomic<size_t> seq;
+    T                   dato;
+  };
+
+  std::unique_ptr<Celda[]> _celdas;
+  size_t                   _mascara = 0;
+  alignas(64) std::atomic<size_t> _cola{0};   ///< Próxima posición a reservar (productores).
+  alignas(64) size_t              _cabeza = 0; ///< Próxima posición a leer (consumidor).
+};
+
+} // namespace atx
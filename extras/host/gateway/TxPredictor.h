@@ -0,0 +1,299 @@
+/**
+ * @file TxPredictor.h
+ * @brief Predictor (lado gateway) del próximo envío de cada nodo AdaptiveTXWSN.
+ * El período de un nodo queda determinado por su `Cfg`, su nivel y su último
+ * envío; la baliza de estado ya trae el período vigente, así que el gateway
+ * puede reflejar la máquina de estados del nodo y abrir el receptor sólo
+ * alrededor del instante previsto.
+ * Las predicciones se guardan en una rueda de temporizadores (hashed timing
+ * wheel) dimensionada para ~100k nodos con coste O(1) por actualización.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <StatusBeacon.h>
+#include <unordered_map>
+#include <vector>
+
+namespace atx {
+
+/**
+ * @class TxPredictor
+ * @brief Mantiene, por nodo, la hora prevista del próximo envío y su ventana.
+ *
+ * Flujo de uso:
+ *  - begin() una vez con la configuración.
+ *  - onBeacon() con cada baliza recibida (hora de recepción del gateway).
+ *  - advance() periódicamente; invoca `abrir(nodeId, desde_ms, hasta_ms)`
+ *    cuando llega el momento de abrir el receptor para un nodo.
+ * Si una ventana se cierra sin baliza se asume pérdida: la predicción se
+ * desplaza un período y la ventana se ensancha al doble.
+ */
+class TxPredictor {
+public:
+  /**
+   * @struct Cfg
+   * @brief Parámetros de la rueda y del modelo de incertidumbre.
+   */
+  struct Cfg {
+    uint32_t maxNodos             = 100000; ///< Capacidad reservada de nodos.
+    uint32_t ranura_ms            = 100;    ///< Granularidad de la rueda.
+    uint32_t ranuras              = 4096;   ///< Número de ranuras (potencia de 2).
+    uint32_t ventanaMinima_ms     = 50;     ///< Semiancho mínimo de la ventana de recepción.
+    uint32_t ventanaMaxima_ms     = 60000;  ///< Semiancho máximo tras pérdidas consecutivas.
+    uint16_t toleranciaDeriva_ppm = 5000;   ///< Incertidumbre inicial de un nodo sin historial (±0.5%).
+    uint8_t  perdidasMaximas      = 4;      ///< Ventanas vacías antes de dar el nodo por perdido.
+  };
+
+  /**
+   * @struct Prediction
+   * @brief Predicción vigente para un nodo.
+   */
+  struct Prediction {
+    bool     valida           = false; ///< false si el nodo está en corte, perdido o no se conoce.
+    uint32_t proximoEnvio_ms  = 0;     ///< Instante previsto (hora del gateway).
+    uint32_t incertidumbre_ms = 0;     ///< Semiancho de la ventana de recepción.
+  };
+
+  /**
+   * @brief Inicializa la rueda y reserva memoria para `cfg.maxNodos` nodos.
+   * Descarta cualquier predicción anterior.
+   * @param cfg Parámetros de operación.
+   */
+  void begin(const Cfg& cfg) {
+    _cfg = cfg;
+    uint32_t n = 1;
+    while (n < _cfg.ranuras) n <<= 1;
+    _cfg.ranuras = n;
+    _mascara = n - 1;
+    _cabezas.assign(n, NINGUNO);
+    _nodos.clear();
+    _indice.clear();
+    _nodos.reserve(_cfg.maxNodos);
+    _indice.reserve(_cfg.maxNodos);
+    _cursorIniciado = false;
+    _programados    = 0;
+  }
+
+  /**
+   * @brief Incorpora una baliza recibida y reprograma la ventana del nodo.
+   *
+   * @param b Baliza decodificada.
+   * @param rx_ms Hora del gateway a la que se recibió.
+   */
+  void onBeacon(const StatusBeacon& b, uint32_t rx_ms) {
+    uint32_t i = indiceDe(b.nodeId);
+    Nodo& n = _nodos[i];
+
+    // Error de la predicción anterior -> sesgo (deriva residual) y error absoluto medio, ambos en Q4.
+    // La predicción ya incluye el sesgo, así que el error es lo que falta por
+    // aprender: se integra (ganancia 1/4) en lugar de promediarlo.
+    if (n.activo) {
+      int32_t error = (int32_t)(rx_ms - n.prediccion_ms);
+      uint32_t errorAbs = (uint32_t)(error < 0 ? -error : error);
+      if (errorAbs < n.periodo_ms / 2) { // errores mayores son cambios de nivel, no jitter
+        n.sesgo_q4      += error * 16 / 4;
+        n.errorMedio_q4  = n.errorMedio_q4 - (n.errorMedio_q4 >> 2) + ((errorAbs << 4) >> 2);
+      }
+    } else {
+      n.sesgo_q4      = 0;
+      n.errorMedio_q4 = (uint32_t)(((uint64_t)b.periodo_ms * _cfg.toleranciaDeriva_ppm / 1000000UL) << 4);
+    }
+
+    n.nivel       = b.level;
+    n.corte       = b.cutoff;
+    n.mV          = b.mV;
+    n.seq         = b.seq;
+    n.periodo_ms  = b.periodo_ms;
+    n.ultimaRx_ms = rx_ms;
+    n.perdidas    = 0;
+
+    desenlazar(i);
+    if (b.cutoff || b.periodo_ms == 0) {
+      // En corte el nodo no vuelve a transmitir hasta recuperarse
+      n.activo = false;
+      return;
+    }
+    n.activo           = true;
+    n.prediccion_ms    = rx_ms + b.periodo_ms + (uint32_t)(n.sesgo_q4 / 16);
+    n.incertidumbre_ms = incertidumbreBase(n);
+    n.fase             = ESPERANDO_APERTURA;
+    programar(i, aperturaDe(n));
+  }
+
+  /**
+   * @brief Avanza la rueda hasta `ahora_ms` y dispara las ventanas vencidas.
+   *
+   * @param ahora_ms Hora actual del gateway.
+   * @param abrir Callable `void(uint32_t nodeId, uint32_t desde_ms, uint32_t hasta_ms)`.
+   */
+  template <class AbrirVentana>
+  void advance(uint32_t ahora_ms, AbrirVentana&& abrir) {
+    if (!_cursorIniciado) { iniciarCursor(ahora_ms); }
+    while ((int32_t)(ahora_ms - (_cursor_ms + _cfg.ranura_ms)) >= 0) {
+      const uint32_t ranura = _ranuraCursor;
+      int32_t actual = _cabezas[ranura];
+      _cabezas[ranura] = NINGUNO;
+      _ranuraCursor = (_ranuraCursor + 1) & _mascara;
+      _cursor_ms   += _cfg.ranura_ms;
+
+      while (actual != NINGUNO) {
+        Nodo& n = _nodos[actual];
+        int32_t siguiente = n.sig;
+        n.sig = n.ant = NINGUNO;
+        if (n.rondas > 0) {
+          n.rondas--;
+          enlazar((uint32_t)actual, ranura);
+        } else {
+          n.ranura = NINGUNO;
+          vencer((uint32_t)actual, abrir);
+        }
+        actual = siguiente;
+      }
+    }
+  }
+
+  /**
+   * @brief Obtiene la predicción vigente de un nodo.
+   * @param nodeId Identificador del nodo.
+   * @return Prediction Predicción (con `valida = false` si no hay).
+   */
+  Prediction predict(uint32_t nodeId) const {
+    Prediction p;
+    auto it = _indice.find(nodeId);
+    if (it == _indice.end()) return p;
+    const Nodo& n = _nodos[it->second];
+    p.valida           = n.activo;
+    p.proximoEnvio_ms  = n.prediccion_ms;
+    p.incertidumbre_ms = n.incertidumbre_ms;
+    return p;
+  }
+
+  /** @brief Nodos conocidos por el predictor. */
+  size_t nodes()     const { return _nodos.size(); }
+
+  /** @brief Nodos con una ventana programada en la rueda. */
+  size_t scheduled() const { return _programados; }
+
+private:
+  static constexpr int32_t NINGUNO = -1;
+
+  enum Fase : uint8_t { ESPERANDO_APERTURA = 0, ESPERANDO_CIERRE = 1 };
+
+  struct Nodo {
+    uint32_t nodeId           = 0;
+    uint32_t prediccion_ms    = 0;
+    uint32_t incertidumbre_ms = 0;
+    uint32_t periodo_ms       = 0;
+    uint32_t ultimaRx_ms      = 0;
+    uint32_t errorMedio_q4    = 0;  ///< Error absoluto medio de predicción (ms, Q4).
+    int32_t  sesgo_q4         = 0;  ///< Error medio con signo (ms, Q4): deriva residual aprendida.
+    uint32_t rondas           = 0;  ///< Vueltas completas que faltan en la rueda.
+    int32_t  sig              = NINGUNO;
+    int32_t  ant              = NINGUNO;
+    int32_t  ranura           = NINGUNO;
+    uint16_t mV               = 0;
+    uint8_t  nivel            = 0;
+    uint8_t  seq              = 0;
+    uint8_t  perdidas         = 0;
+    uint8_t  fase             = ESPERANDO_APERTURA;
+    bool     corte            = false;
+    bool     activo           = false;
+  };
+
+  Cfg                                    _cfg;
+  uint32_t                               _mascara = 0;
+  std::vector<int32_t>                   _cabezas;
+  std::vector<Nodo>                      _nodos;
+  std::unordered_map<uint32_t, uint32_t> _indice;
+  uint32_t                               _cursor_ms      = 0;
+  uint32_t                               _ranuraCursor   = 0;
+  bool                                   _cursorIniciado = false;
+  size_t                                 _programados    = 0;
+
+  uint32_t indiceDe(uint32_t nodeId) {
+    auto it = _indice.find(nodeId);
+    if (it != _indice.end()) return it->second;
+    uint32_t i = (uint32_t)_nodos.size();
+    _nodos.push_back(Nodo());
+    _nodos.back().nodeId = nodeId;
+    _indice.emplace(nodeId, i);
+    return i;
+  }
+
+  uint32_t incertidumbreBase(const Nodo& n) const {
+    uint32_t u = _cfg.ventanaMinima_ms + ((n.errorMedio_q4 * 2) >> 4);
+    return (u > _cfg.ventanaMaxima_ms) ? _cfg.ventanaMaxima_ms : u;
+  }
+
+  /**
+   * @brief Instante en que debe dispararse la apertura.
+   * Se adelanta una ranura para que el receptor esté listo antes de la
+   * ventana aunque advance() se llame con la granularidad de la rueda.
+   */
+  uint32_t aperturaDe(const Nodo& n) const {
+    return n.prediccion_ms - n.incertidumbre_ms - _cfg.ranura_ms;
+  }
+
+  void iniciarCursor(uint32_t ahora_ms) {
+    _cursor_ms      = ahora_ms - (ahora_ms % _cfg.ranura_ms);
+    _ranuraCursor   = (_cursor_ms / _cfg.ranura_ms) & _mascara;
+    _cursorIniciado = true;
+  }
+
+  void programar(uint32_t i, uint32_t vence_ms) {
+    if (!_cursorIniciado) iniciarCursor(vence_ms);
+    int32_t delta = (int32_t)(vence_ms - _cursor_ms);
+    uint32_t ticks = (delta <= 0) ? 0 : (uint32_t)delta / _cfg.ranura_ms;
+    Nodo& n = _nodos[i];
+    n.rondas = ticks / _cfg.ranuras;
+    enlazar(i, (_ranuraCursor + ticks) & _mascara);
+    _programados++;
+  }
+
+  void enlazar(uint32_t i, uint32_t ranura) {
+    Nodo& n = _nodos[i];
+    n.ranura = (int32_t)ranura;
+    n.ant    = NINGUNO;
+    n.sig    = _cabezas[ranura];
+    if (n.sig != NINGUNO) _nodos[n.sig].ant = (int32_t)i;
+    _cabezas[ranura] = (int32_t)i;
+  }
+
+  void desenlazar(uint32_t i) {
+    Nodo& n = _nodos[i];
+    if (n.ranura == NINGUNO) return;
+    if (n.ant != NINGUNO) _nodos[n.ant].sig = n.sig;
+    else                  _cabezas[n.ranura] = n.sig;
+    if (n.sig != NINGUNO) _nodos[n.sig].ant = n.ant;
+    n.sig = n.ant = n.ranura = NINGUNO;
+    _programados--;
+  }
+
+  template <class AbrirVentana>
+  void vencer(uint32_t i, AbrirVentana& abrir) {
+    _programados--;
+    Nodo& n = _nodos[i];
+    if (n.fase == ESPERANDO_APERTURA) {
+      abrir(n.nodeId, n.prediccion_ms - n.incertidumbre_ms, n.prediccion_ms + n.incertidumbre_ms);
+      n.fase = ESPERANDO_CIERRE;
+      programar(i, n.prediccion_ms + n.incertidumbre_ms);
+      return;
+    }
+
+    // La ventana se cerró sin baliza: se supone pérdida y se espera el siguiente envío
+    if (++n.perdidas > _cfg.perdidasMaximas) {
+      n.activo = false;
+      return;
+    }
+    n.prediccion_ms += n.periodo_ms + (uint32_t)(n.sesgo_q4 / 16);
+    uint32_t u = n.incertidumbre_ms * 2;
+    n.incertidumbre_ms = (u > _cfg.ventanaMaxima_ms) ? _cfg.ventanaMaxima_ms : u;
+    n.fase = ESPERANDO_APERTURA;
+    programar(i, aperturaDe(n));
+  }
+};
+
+} // namespace atx
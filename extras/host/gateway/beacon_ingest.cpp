@@ -0,0 +1,282 @@
+/**
+ * @file beacon_ingest.cpp
+ * @brief Gateway de ingesta: lee balizas de una tubería o de UDP local y
+ * mantiene el estado por nodo con BeaconIngest.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -pthread -I src -I extras/host extras/host/gateway/beacon_ingest.cpp -o beacon_ingest
+ * Uso:
+ *   ./beacon_loadgen 100000 20000000 | ./beacon_ingest pipe [fragmentos=4]
+ *   ./beacon_ingest udp <puerto> <segundos> [fragmentos=4] [lectores=2]
+ *   ./beacon_ingest bench <nodos> <balizas> [fragmentos=4] [productores=4]
+ *   ./beacon_ingest check   (tramas v1, v2 y v3 con extensiones mezcladas y
+ *                            bloque de NodeStats tras 60 días de operación)
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#define ADAPTIVETXWSN_STATS 1
+#include "BeaconIngest.h"
+#include <NodeStats.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <arpa/inet.h>
+
+namespace {
+
+double segundosDesde(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void resumen(atx::BeaconIngest& ingesta, double segundos) {
+  uint64_t nodos = 0, perdidas = 0, enCorte = 0;
+  uint64_t porNivel[3] = { 0, 0, 0 };
+  ingesta.forEachNode([&](uint32_t, const atx::BeaconIngest::NodeState& s) {
+    nodos++;
+    perdidas += s.perdidas;
+    if (s.cutoff) enCorte++;
+    if (s.level < 3) porNivel[s.level]++;
+  });
+  const uint64_t n = ingesta.processed();
+  printf("balizas=%llu segundos=%.3f balizas_por_s=%.0f\n",
+         (unsigned long long)n, segundos, segundos > 0 ? n / segundos : 0.0);
+  printf("nodos=%llu bajo=%llu medio=%llu alto=%llu corte=%llu perdidas_seq=%llu\n",
+         (unsigned long long)nodos, (unsigned long long)porNivel[0], (unsigned long long)porNivel[1],
+         (unsigned long long)porNivel[2], (unsigned long long)enCorte, (unsigned long long)perdidas);
+  printf("invalidas=%llu colas_llenas=%llu errores_lectura=%llu\n",
+         (unsigned long long)ingesta.invalid(), (unsigned long long)ingesta.stalls(),
+         (unsigned long long)ingesta.readErrors());
+}
+
+/**
+ * Flujo con tramas de versión 1, 2 y 3 (con 0 a 3 bloques de extensión)
+ * mezcladas: cada nodo debe terminar con su último mV y sin inválidas, tanto
+ * en un solo bloque (pushRaw) como por una tubería leída a trozos.
+ */
+int verificarTramas() {
+  const uint32_t NODOS = 1000, RONDAS = 8;
+  std::vector<uint8_t> flujo;
+  uint8_t trama[StatusBeacon::TAMANO_MAXIMO];
+  StatusBeacon b;
+  for (uint32_t r = 0; r < RONDAS; ++r) {
+    for (uint32_t id = 0; id < NODOS; ++id) {
+      b.nodeId     = id;
+      b.seq        = (uint8_t)r;
+      b.level      = (uint8_t)(id % 3);
+      b.mV         = (uint16_t)(3400 + id % 500 + r);
+      b.periodo_ms = 5000;
+      uint16_t n = b.encode(trama);
+      switch ((id + r) % 4) {
+        case 0: trama[0] = 1; n = StatusBeacon::TAMANO_V1; break;
+        case 1: trama[0] = 2; n = StatusBeacon::TAMANO_V2; break;
+        case 2: break;
+        default:
+          for (uint8_t k = 0; k < 1 + id % 3; ++k) {
+            const uint8_t largo = (uint8_t)(5 + 13 * k);
+            trama[n] = (uint8_t)(0x80 + k);
+            trama[n + 1] = largo;
+            memset(trama + n + 2, 0xA5, largo);
+            n += StatusBeacon::addExtension(trama, (uint8_t)(2 + largo));
+          }
+      }
+      flujo.insert(flujo.end(), trama, trama + n);
+    }
+  }
+
+  auto comprobar = [&](atx::BeaconIngest& ingesta, const char* via) {
+    uint32_t malos = 0;
+    ingesta.forEachNode([&](uint32_t id, const atx::BeaconIngest::NodeState& s) {
+      if (s.mV != 3400 + id % 500 + RONDAS - 1 || s.balizas != RONDAS || s.perdidas != 0) malos++;
+    });
+    const bool ok = ingesta.processed() == (uint64_t)NODOS * RONDAS && ingesta.invalid() == 0 && malos == 0;
+    printf("%s: bytes=%zu balizas=%llu invalidas=%llu nodos_mal=%u %s\n", via, flujo.size(),
+           (unsigned long long)ingesta.processed(), (unsigned long long)ingesta.invalid(), malos, ok ? "ok" : "FALLA");
+    return ok;
+  };
+
+  atx::BeaconIngest::Cfg cfg;
+  cfg.nodosEsperados = NODOS;
+  atx::BeaconIngest enBloque;
+  enBloque.begin(cfg);
+  enBloque.pushRaw(flujo.data(), flujo.size(), 0);
+  enBloque.stop();
+  const bool okBloque = comprobar(enBloque, "bloque");
+
+  int fds[2];
+  if (::pipe(fds) != 0) { perror("pipe"); return 1; }
+  atx::BeaconIngest porTuberia;
+  porTuberia.begin(cfg);
+  std::thread escritor([&] {
+    // Trozos de tamaño impar para partir tramas entre lecturas
+    for (size_t off = 0, paso = 7; off < flujo.size(); off += paso, paso = paso * 5 % 997 + 1) {
+      const size_t n = std::min(paso, flujo.size() - off);
+      if (write(fds[1], flujo.data() + off, n) != (ssize_t)n) break;
+    }
+    close(fds[1]);
+  });
+  porTuberia.readStream(fds[0]);
+  escritor.join();
+  close(fds[0]);
+  porTuberia.stop();
+  const bool okTuberia = comprobar(porTuberia, "tuberia");
+  return (okBloque && okTuberia) ? 0 : 1;
+}
+
+/**
+ * NodeStats durante 60 días en ALTO (pasa los 49.7 días en que desborda un
+ * contador de ms de 32 bits), anexado a una baliza detrás de otro bloque de
+ * extensión: el gateway debe encontrarlo con findExtension() y leer el
+ * tiempo completo.
+ */
+bool verificarEstadisticas() {
+  const uint32_t PASO_MS = 61237;
+  const uint64_t DURACION_MS = 60ULL * 86400000ULL;
+  atx::sim::setMillis(0);
+  AdaptiveTXWSN nodo;
+  nodo.begin(AdaptiveTXWSN::Cfg());
+  NodeStats stats;
+  stats.begin(NodeStats::Cfg(), millis());
+  uint64_t transcurrido = 0;
+  nodo.setBatteryVolts(4.0f);
+  nodo.tick();
+  stats.update(nodo, millis());
+  while (transcurrido + PASO_MS <= DURACION_MS) {
+    atx::sim::advanceMillis(PASO_MS);
+    transcurrido += PASO_MS;
+    nodo.setBatteryVolts(4.0f);
+    nodo.tick();
+    stats.update(nodo, millis());
+  }
+  const uint32_t esperado_s = (uint32_t)(transcurrido / 1000);
+
+  uint8_t trama[StatusBeacon::TAMANO_MAXIMO];
+  StatusBeacon b;
+  b.nodeId = 7;
+  uint16_t n = b.encode(trama);
+  trama[n] = 0x80;
+  trama[n + 1] = 3;
+  memset(trama + n + 2, 0, 3);
+  n += StatusBeacon::addExtension(trama, 5);
+  n += StatusBeacon::addExtension(trama, stats.encode(trama + n));
+
+  uint8_t largo = 0;
+  const uint8_t* bloque = StatusBeacon::findExtension(trama, n, NodeStats::TIPO, largo);
+  NodeStats::Resumen r;
+  const bool leido = bloque && NodeStats::decode(bloque, largo, r);
+  const bool ok = StatusBeacon::frameSize(trama, n) == n && leido &&
+                  stats.secondsInLevel(AdaptiveTXWSN::BATT_HIGH) == esperado_s &&
+                  r.segundos == esperado_s && r.fraccion_q8[AdaptiveTXWSN::BATT_HIGH] == 255;
+  printf("estadisticas: trama=%u bytes segundos=%lu esperado=%lu %s\n", (unsigned)n,
+         (unsigned long)(leido ? r.segundos : 0), (unsigned long)esperado_s, ok ? "ok" : "FALLA");
+  return ok;
+}
+
+int usoIncorrecto() {
+  fprintf(stderr,
+          "uso: beacon_ingest pipe [fragmentos]\n"
+          "     beacon_ingest udp <puerto> <segundos> [fragmentos] [lectores]\n"
+          "     beacon_ingest bench <nodos> <balizas> [fragmentos] [productores]\n"
+          "     beacon_ingest check\n");
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) return usoIncorrecto();
+  const char* modo = argv[1];
+  atx::BeaconIngest::Cfg cfg;
+  atx::BeaconIngest ingesta;
+
+  if (strcmp(modo, "check") == 0) {
+    const int r = verificarTramas();
+    return (verificarEstadisticas() && r == 0) ? 0 : 1;
+  }
+
+  if (strcmp(modo, "pipe") == 0) {
+    if (argc > 2) cfg.fragmentos = (uint8_t)atoi(argv[2]);
+    ingesta.begin(cfg);
+    auto t0 = std::chrono::steady_clock::now();
+    ingesta.readStream(0);
+    ingesta.stop();
+    resumen(ingesta, segundosDesde(t0));
+    return 0;
+  }
+
+  if (strcmp(modo, "udp") == 0) {
+    if (argc < 4) return usoIncorrecto();
+    const uint16_t puerto   = (uint16_t)atoi(argv[2]);
+    const double   segundos = atof(argv[3]);
+    if (argc > 4) cfg.fragmentos = (uint8_t)atoi(argv[4]);
+    const int lectores = (argc > 5) ? atoi(argv[5]) : 2;
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    int rcvbuf = 64 << 20;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    timeval espera = { 0, 100000 }; // permite revisar `continuar` cada 100 ms
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &espera, sizeof(espera));
+    sockaddr_in dir;
+    memset(&dir, 0, sizeof(dir));
+    dir.sin_family      = AF_INET;
+    dir.sin_port        = htons(puerto);
+    dir.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(sock, (sockaddr*)&dir, sizeof(dir)) != 0) { perror("bind"); return 1; }
+
+    ingesta.begin(cfg);
+    std::atomic<bool> continuar{true};
+    std::vector<std::thread> hilos;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < lectores; ++i) hilos.emplace_back([&] { ingesta.readUdp(sock, continuar); });
+    std::this_thread::sleep_for(std::chrono::duration<double>(segundos));
+    continuar.store(false);
+    for (auto& h : hilos) h.join();
+    ingesta.stop();
+    close(sock);
+    resumen(ingesta, segundosDesde(t0));
+    return 0;
+  }
+
+  if (strcmp(modo, "bench") == 0) {
+    // Sin E/S: mide el canal (decodificación + colas + fragmentos) con productores en memoria
+    if (argc < 4) return usoIncorrecto();
+    const uint32_t nodos   = (uint32_t)strtoul(argv[2], nullptr, 10);
+    const uint64_t balizas = strtoull(argv[3], nullptr, 10);
+    if (argc > 4) cfg.fragmentos = (uint8_t)atoi(argv[4]);
+    const unsigned productores = (argc > 5) ? (unsigned)atoi(argv[5]) : 4;
+    cfg.nodosEsperados = nodos;
+
+    // Bloque de balizas pre-codificadas que cada productor recorre en bucle
+    const uint32_t POR_BLOQUE = 64;
+    ingesta.begin(cfg);
+    std::vector<std::thread> hilos;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned p = 0; p < productores; ++p) {
+      hilos.emplace_back([&, p] {
+        uint8_t bloque[POR_BLOQUE * StatusBeacon::TAMANO];
+        StatusBeacon b;
+        uint64_t mias = balizas / productores + (p < balizas % productores ? 1 : 0);
+        uint32_t id = p;
+        for (uint64_t hechas = 0; hechas < mias; hechas += POR_BLOQUE) {
+          uint32_t k = (uint32_t)std::min<uint64_t>(POR_BLOQUE, mias - hechas);
+          for (uint32_t j = 0; j < k; ++j) {
+            b.nodeId     = id % nodos;
+            b.seq        = (uint8_t)((hechas + j) / nodos);
+            b.level      = (uint8_t)(id % 3);
+            b.mV         = (uint16_t)(3400 + id % 800);
+            b.periodo_ms = 5000;
+            b.encode(bloque + j * StatusBeacon::TAMANO);
+            id += productores;
+          }
+          ingesta.pushRaw(bloque, k * StatusBeacon::TAMANO, (uint32_t)hechas);
+        }
+      });
+    }
+    for (auto& h : hilos) h.join();
+    ingesta.stop();
+    resumen(ingesta, segundosDesde(t0));
+    return 0;
+  }
+
+  return usoIncorrecto();
+}
@@ -0,0 +1,107 @@
+/**
+ * @file beacon_loadgen.cpp
+ * @brief Generador de carga: simula una flota de nodos AdaptiveTXWSN que
+ * envían StatusBeacon, hacia stdout (tubería) o UDP local.
+ * Cada nodo descarga su batería linealmente y cambia de nivel con los
+ * umbrales del `Cfg` por defecto, así que las balizas son realistas.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/gateway/beacon_loadgen.cpp -o beacon_loadgen
+ * Uso:
+ *   ./beacon_loadgen <nodos> <balizas>                         (a stdout)
+ *   ./beacon_loadgen <nodos> <balizas> udp <puerto> [por_datagrama=64]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <StatusBeacon.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+struct NodoSimulado {
+  uint16_t mV;
+  uint8_t  seq;
+  uint8_t  nivel;
+};
+
+/** Nivel con los umbrales por defecto de AdaptiveTXWSN::Cfg (sin histéresis). */
+uint8_t nivelDe(uint16_t mV) {
+  return (mV >= 3900) ? AdaptiveTXWSN::BATT_HIGH : (mV >= 3600) ? AdaptiveTXWSN::BATT_MID : AdaptiveTXWSN::BATT_LOW;
+}
+
+bool escribirTodo(int fd, const uint8_t* p, size_t n) {
+  while (n > 0) {
+    ssize_t w = write(fd, p, n);
+    if (w <= 0) return false;
+    p += w;
+    n -= (size_t)w;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "uso: beacon_loadgen <nodos> <balizas> [udp <puerto> [por_datagrama]]\n");
+    return 2;
+  }
+  const uint32_t nNodos   = (uint32_t)strtoul(argv[1], nullptr, 10);
+  const uint64_t nBalizas = strtoull(argv[2], nullptr, 10);
+  const bool     udp      = (argc > 4 && strcmp(argv[3], "udp") == 0);
+  const uint32_t porLote  = udp ? ((argc > 5) ? (uint32_t)atoi(argv[5]) : 64) : 4096;
+  const uint32_t periodos[3] = { 120000, 15000, 5000 };
+
+  int sock = -1;
+  sockaddr_in dir;
+  if (udp) {
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&dir, 0, sizeof(dir));
+    dir.sin_family      = AF_INET;
+    dir.sin_port        = htons((uint16_t)atoi(argv[4]));
+    dir.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  }
+
+  std::vector<NodoSimulado> nodos(nNodos);
+  for (uint32_t i = 0; i < nNodos; ++i) {
+    nodos[i].mV    = (uint16_t)(3400 + (i * 7919u) % 800);
+    nodos[i].seq   = 0;
+    nodos[i].nivel = nivelDe(nodos[i].mV);
+  }
+
+  std::vector<uint8_t> lote(porLote * StatusBeacon::TAMANO);
+  StatusBeacon b;
+  uint64_t enviadas = 0;
+  uint32_t i = 0;
+  while (enviadas < nBalizas) {
+    uint32_t k = 0;
+    for (; k < porLote && enviadas < nBalizas; ++k, ++enviadas) {
+      NodoSimulado& n = nodos[i];
+      if (n.mV > 3300 && (n.seq & 0x0F) == 0) n.mV--; // descarga lenta
+      n.nivel      = nivelDe(n.mV);
+      b.nodeId     = i;
+      b.seq        = n.seq++;
+      b.level      = n.nivel;
+      b.cutoff     = n.mV < 3400;
+      b.mV         = n.mV;
+      b.periodo_ms = periodos[n.nivel];
+      b.encode(lote.data() + k * StatusBeacon::TAMANO);
+      if (++i == nNodos) i = 0;
+    }
+    const size_t bytes = k * StatusBeacon::TAMANO;
+    if (udp) {
+      sendto(sock, lote.data(), bytes, 0, (sockaddr*)&dir, sizeof(dir));
+    } else if (!escribirTodo(1, lote.data(), bytes)) {
+      return 1;
+    }
+  }
+  if (sock >= 0) close(sock);
+  return 0;
+}
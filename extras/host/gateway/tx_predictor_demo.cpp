@@ -0,0 +1,159 @@
+/**
+ * @file tx_predictor_demo.cpp
+ * @brief Simula una flota de nodos y mide qué tan bien TxPredictor acota sus envíos.
+ * Cada nodo transmite con el período de su nivel, con deriva residual de
+ * reloj, jitter del loop y pérdidas de paquetes. Se reporta la fracción de
+ * balizas que caen dentro de la ventana abierta, el ciclo de trabajo del
+ * receptor y el costo por actualización.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/gateway/tx_predictor_demo.cpp -o tx_predictor_demo
+ * Uso:
+ *   ./tx_predictor_demo [nodos=100000] [horas=1]
+ *   ./tx_predictor_demo sesgo   (comprueba que se aprende un sesgo fijo a ±1 ms)
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include "TxPredictor.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+
+namespace {
+
+struct NodoSimulado {
+  uint32_t periodo_ms;
+  int32_t  derivaResidual_ppm;
+  uint8_t  nivel;
+  uint8_t  seq;
+  uint32_t ventanaDesde_ms;
+  uint32_t ventanaHasta_ms;
+};
+
+struct Envio {
+  uint32_t t_ms;
+  uint32_t nodo;
+  bool operator>(const Envio& o) const { return t_ms > o.t_ms; }
+};
+
+/**
+ * Un nodo que llega siempre `sesgo_ms` después de lo anunciado (deriva sin
+ * compensar, dentro de `toleranciaDeriva_ppm`) debe quedar predicho a ±1 ms
+ * tras unas decenas de balizas.
+ */
+int verificarSesgo() {
+  const int32_t  derivas_ppm[] = { -5000, -2000, -250, 0, 300, 1000, 3700, 5000 };
+  const uint32_t periodos[]    = { 5000, 15000, 120000 };
+  int fallas = 0;
+  for (uint32_t periodo : periodos) {
+    for (int32_t ppm : derivas_ppm) {
+      const int32_t sesgo = (int32_t)((int64_t)periodo * ppm / 1000000);
+      atx::TxPredictor predictor;
+      predictor.begin(atx::TxPredictor::Cfg());
+      StatusBeacon b;
+      b.nodeId = 7;
+      b.periodo_ms = periodo;
+      uint32_t t = 1000;
+      int32_t aprendido = 0;
+      for (uint8_t k = 0; k < 60; ++k) {
+        b.seq = k;
+        predictor.advance(t, [](uint32_t, uint32_t, uint32_t) {});
+        predictor.onBeacon(b, t);
+        aprendido = (int32_t)(predictor.predict(b.nodeId).proximoEnvio_ms - (t + periodo));
+        t += periodo + (uint32_t)sesgo;
+      }
+      const bool ok = abs(aprendido - sesgo) <= 1;
+      if (!ok) fallas++;
+      printf("periodo_ms=%u sesgo_ms=%d aprendido_ms=%d %s\n", periodo, sesgo, aprendido, ok ? "ok" : "FALLA");
+    }
+  }
+  return fallas ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc > 1 && strcmp(argv[1], "sesgo") == 0) return verificarSesgo();
+
+  const uint32_t nNodos = (argc > 1) ? (uint32_t)strtoul(argv[1], nullptr, 10) : 100000;
+  const double   horas  = (argc > 2) ? atof(argv[2]) : 1.0;
+  const uint32_t fin_ms = (uint32_t)(horas * 3600000.0);
+
+  std::mt19937 rng(12345);
+  std::uniform_int_distribution<int>      nivelAleatorio(0, 2);
+  std::uniform_int_distribution<int32_t>  deriva(-200, 200);  // tras compensar con DriftEstimator
+  std::uniform_int_distribution<uint32_t> jitter(0, 20);      // latencia del loop() del nodo
+  std::uniform_real_distribution<double>  perdida(0.0, 1.0);
+  const uint32_t periodos[3] = { 120000, 15000, 5000 };       // Cfg por defecto: BAJO, MEDIO, ALTO
+
+  std::vector<NodoSimulado> nodos(nNodos);
+  std::priority_queue<Envio, std::vector<Envio>, std::greater<Envio>> cola;
+  for (uint32_t i = 0; i < nNodos; ++i) {
+    NodoSimulado& n = nodos[i];
+    n.nivel = (uint8_t)nivelAleatorio(rng);
+    n.periodo_ms = periodos[n.nivel];
+    n.derivaResidual_ppm = deriva(rng);
+    n.seq = 0;
+    n.ventanaDesde_ms = n.ventanaHasta_ms = 0;
+    cola.push({ (uint32_t)(rng() % n.periodo_ms), i });
+  }
+
+  atx::TxPredictor::Cfg cfg;
+  cfg.maxNodos = nNodos;
+  atx::TxPredictor predictor;
+  predictor.begin(cfg);
+
+  uint64_t recibidas = 0, enVentana = 0, ventanas = 0, msReceptorAbierto = 0;
+  double   nsActualizacion = 0;
+  auto abrir = [&](uint32_t id, uint32_t desde, uint32_t hasta) {
+    nodos[id].ventanaDesde_ms = desde;
+    nodos[id].ventanaHasta_ms = hasta;
+    ventanas++;
+    msReceptorAbierto += hasta - desde;
+  };
+
+  uint8_t buf[StatusBeacon::TAMANO];
+  while (!cola.empty() && cola.top().t_ms < fin_ms) {
+    Envio e = cola.top();
+    cola.pop();
+    NodoSimulado& n = nodos[e.nodo];
+    predictor.advance(e.t_ms, abrir);
+
+    // Próximo envío según el reloj del nodo (con deriva y jitter)
+    uint32_t siguiente = e.t_ms + n.periodo_ms
+                       + (uint32_t)((int64_t)n.periodo_ms * n.derivaResidual_ppm / 1000000)
+                       + jitter(rng);
+    cola.push({ siguiente, e.nodo });
+    if (perdida(rng) < 0.02) continue;
+
+    StatusBeacon b;
+    b.nodeId = e.nodo;
+    b.seq = n.seq++;
+    b.level = n.nivel;
+    b.mV = 3800;
+    b.periodo_ms = n.periodo_ms;
+    b.encode(buf);
+
+    StatusBeacon rx;
+    auto t0 = std::chrono::steady_clock::now();
+    StatusBeacon::decode(buf, sizeof(buf), rx);
+    predictor.onBeacon(rx, e.t_ms);
+    nsActualizacion += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+    recibidas++;
+    if ((int32_t)(e.t_ms - n.ventanaDesde_ms) >= 0 && (int32_t)(n.ventanaHasta_ms - e.t_ms) >= 0) enVentana++;
+  }
+
+  const uint64_t primeras = nNodos; // la primera baliza de cada nodo no tiene predicción previa
+  printf("nodos=%u horas=%.2f balizas=%llu\n", nNodos, horas, (unsigned long long)recibidas);
+  printf("en_ventana=%.4f\n", recibidas > primeras ? (double)enVentana / (double)(recibidas - primeras) : 0.0);
+  printf("ventana_media_ms=%.1f\n", ventanas ? (double)msReceptorAbierto / (double)ventanas : 0.0);
+  printf("ciclo_trabajo_receptor_por_nodo=%.5f\n", (double)msReceptorAbierto / ((double)fin_ms * nNodos));
+  printf("ns_por_actualizacion=%.1f\n", recibidas ? nsActualizacion / (double)recibidas : 0.0);
+  printf("programados=%zu\n", predictor.scheduled());
+  return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ * @file NodeEnv.h
+ * @brief Entorno de un nodo con cosecha solar para entrenar y evaluar políticas de período.
+ * Modela la celda (carga y voltaje lineal en el estado de carga), un panel
+ * con ciclo diurno y nubosidad diaria, y un enlace de tres calidades con
+ * reintentos. Cada paso es un intervalo de decisión; dentro del paso los
+ * envíos y la edad de la información (AoI) se integran de forma exacta.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <QTablePolicy.h>
+
+#include <cmath>
+#include <random>
+
+namespace atx {
+namespace rl {
+
+/**
+ * @struct Site
+ * @brief Parámetros de un sitio de despliegue.
+ */
+struct Site {
+  float    capacidad_mAh  = 1000.0f;
+  float    cosechaPico_uA = 1500.0f; ///< Corriente del panel a mediodía con cielo despejado.
+  float    nubosidad      = 0.5f;    ///< Reducción diaria máxima de la cosecha (0 = siempre despejado).
+  float    enlaceRegular  = 0.3f;    ///< Fracción del tiempo con enlace regular (ETX 2).
+  float    enlaceMalo     = 0.1f;    ///< Fracción del tiempo con enlace malo (ETX 4).
+  uint32_t semilla        = 1;
+
+  /** @brief Sitio aleatorio de la distribución de entrenamiento y prueba. */
+  static Site random(std::mt19937& rng) {
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    Site s;
+    s.capacidad_mAh  = 300.0f + 1700.0f * u(rng);
+    s.cosechaPico_uA = 3000.0f * u(rng) * u(rng);   // muchos sitios con poca cosecha
+    s.nubosidad      = 0.9f * u(rng);
+    s.enlaceMalo     = 0.3f * u(rng);
+    s.enlaceRegular  = (1.0f - s.enlaceMalo) * 0.6f * u(rng);
+    s.semilla        = rng();
+    return s;
+  }
+};
+
+/**
+ * @struct StepInfo
+ * @brief Resultado de un paso.
+ */
+struct StepInfo {
+  bool     enCorte    = false; ///< Estado al final del paso.
+  uint32_t envios     = 0;
+  double   aoiMedia_s = 0;     ///< Edad media de la información durante el paso.
+};
+
+/**
+ * @class NodeEnv
+ * @brief Un nodo en un sitio, paso a paso.
+ */
+class NodeEnv {
+public:
+  static const uint32_t PASO_S = 900; ///< Intervalo de decisión (15 min).
+
+  float    voltajeVacio_V     = 3.30f;
+  float    voltajeLleno_V     = 4.15f;
+  float    corte_V            = 3.40f;
+  float    corrienteReposo_uA = 15.0f;
+  float    cargaEnvio_uC      = 2500.0f; ///< Por intento; se multiplica por el ETX.
+
+  void reset(const Site& sitio, float socInicial, uint32_t horaInicial_s = 0) {
+    _sitio = sitio;
+    _rng.seed(sitio.semilla);
+    _capacidad_uC = sitio.capacidad_mAh * 3600.0 * 1000.0;
+    _carga_uC = _capacidad_uC * socInicial;
+    _t_s = horaInicial_s;
+    _ultimaEntrega_s = (double)horaInicial_s;
+    _proximoEnvio_s = (double)horaInicial_s;
+    _enlace = 0;
+    _factorDia = 1.0;
+    _dia = 0xFFFFFFFFUL;
+    _enCorte = voltaje() < corte_V;
+  }
+
+  /**
+   * @brief Avanza un intervalo transmitiendo con `periodo_ms` (salvo en corte).
+   */
+  StepInfo step(uint32_t periodo_ms) {
+    StepInfo info;
+    const double t0 = _t_s, t1 = _t_s + PASO_S;
+    const double periodo_s = std::max(1.0, periodo_ms / 1000.0);
+    const double etx = (_enlace == 0) ? 1.0 : (_enlace == 1) ? 2.0 : 4.0;
+    double aoi = 0, t = t0;
+
+    if (_proximoEnvio_s < t0) _proximoEnvio_s = t0;
+    if (_enCorte) {
+      _proximoEnvio_s = t1; // sin envíos; se reprograma al salir del corte
+    } else if (_proximoEnvio_s > t0 + periodo_s) {
+      _proximoEnvio_s = t0 + periodo_s; // un período más corto entra en vigor de inmediato
+    }
+    while (_proximoEnvio_s < t1) {
+      const double te = _proximoEnvio_s;
+      aoi += integralEdad(t, te);
+      _ultimaEntrega_s = te;
+      t = te;
+      info.envios++;
+      _proximoEnvio_s = te + periodo_s;
+    }
+    aoi += integralEdad(t, t1);
+    info.aoiMedia_s = aoi / PASO_S;
+
+    _carga_uC -= corrienteReposo_uA * PASO_S + info.envios * cargaEnvio_uC * etx;
+    _carga_uC += cosechaMedia_uA(t0) * PASO_S;
+    if (_carga_uC < 0) _carga_uC = 0;
+    if (_carga_uC > _capacidad_uC) _carga_uC = _capacidad_uC;
+
+    _t_s += PASO_S;
+    cambiarEnlace();
+    _enCorte = voltaje() < corte_V;
+    info.enCorte = _enCorte;
+    return info;
+  }
+
+  // --- Observaciones ---
+  float    voltaje() const { return voltajeVacio_V + (voltajeLleno_V - voltajeVacio_V) * (float)(_carga_uC / _capacidad_uC); }
+  uint16_t mV() const { return (uint16_t)(voltaje() * 1000.0f + 0.5f); }
+  bool     enCorte() const { return _enCorte; }
+  uint8_t  enlace() const { return _enlace; }
+  uint32_t ahora_s() const { return _t_s; }
+
+  /** @brief Franja de cosecha por hora del día: 0 noche, 1 mañana, 2 mediodía, 3 tarde. */
+  uint8_t franja() const {
+    const uint32_t h = (_t_s / 3600) % 24;
+    return (h < 6 || h >= 18) ? 0 : (h < 10) ? 1 : (h < 14) ? 2 : 3;
+  }
+
+private:
+  Site         _sitio;
+  std::mt19937 _rng;
+  double       _capacidad_uC    = 1;
+  double       _carga_uC        = 0;
+  uint32_t     _t_s             = 0;
+  double       _ultimaEntrega_s = 0;
+  double       _proximoEnvio_s  = 0;
+  uint8_t      _enlace          = 0;
+  double       _factorDia       = 1;
+  uint32_t     _dia             = 0;
+  bool         _enCorte         = false;
+
+  double integralEdad(double a, double b) const {
+    const double ea = a - _ultimaEntrega_s, eb = b - _ultimaEntrega_s;
+    return (eb * eb - ea * ea) / 2.0;
+  }
+
+  double cosechaMedia_uA(double t0) {
+    const uint32_t dia = (uint32_t)(t0 / 86400.0);
+    if (dia != _dia) {
+      _dia = dia;
+      std::uniform_real_distribution<double> u(0.0, 1.0);
+      _factorDia = 1.0 - _sitio.nubosidad * u(_rng);
+    }
+    const double h = std::fmod(t0 + PASO_S / 2.0, 86400.0) / 3600.0;
+    if (h < 6.0 || h > 18.0) return 0.0;
+    return _sitio.cosechaPico_uA * _factorDia * std::sin(M_PI * (h - 6.0) / 12.0);
+  }
+
+  void cambiarEnlace() {
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    if (u(_rng) >= 0.05f) return; // el enlace cambia en promedio cada 5 h
+    float x = u(_rng);
+    _enlace = (x < _sitio.enlaceMalo) ? 2 : (x < _sitio.enlaceMalo + _sitio.enlaceRegular) ? 1 : 0;
+  }
+};
+
+} // namespace rl
+} // namespace atx
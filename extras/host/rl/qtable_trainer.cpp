@@ -0,0 +1,247 @@
+/**
+ * @file qtable_trainer.cpp
+ * @brief Entrena la tabla de QTablePolicy en NodeEnv con varios hilos, la
+ * exporta como encabezado PROGMEM y la compara contra los tres niveles.
+ *
+ * Cada generación, cada hilo parte de la tabla compartida, corre episodios
+ * en sitios aleatorios propios (Q-learning tabular, ε-greedy) y devuelve su
+ * tabla con las visitas por celda; el hilo principal promedia ponderando
+ * por visitas.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -pthread -I src -I extras/host extras/host/rl/qtable_trainer.cpp -o qtable_trainer
+ * Uso:
+ *   ./qtable_trainer train [hilos=4] [generaciones=40] [salida=src/QTableDefault.h]
+ *   ./qtable_trainer eval  [sitios=200] [dias=120]
+ *       Compara niveles del `Cfg`, QTABLA_DEFECTO y QTABLA_DEFECTO con ajuste en el sitio.
+ *   ./qtable_trainer check
+ *       Verifica que el ajuste en el sitio acumula errores TD menores que 2^n.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include "NodeEnv.h"
+#include <AdaptiveTXWSN.h>
+#include <QTableDefault.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using atx::rl::NodeEnv;
+using atx::rl::Site;
+using atx::rl::StepInfo;
+
+const int S = QTablePolicy::NUM_ESTADOS, A = QTablePolicy::ACCIONES;
+
+struct Tabla {
+  double   q[S][A] = {};
+  uint64_t visitas[S][A] = {};
+};
+
+// --- Entrenamiento ---
+
+void entrenarHilo(const Tabla& base, Tabla& out, uint32_t semilla, int episodios, double epsilon) {
+  const QTablePolicy::Cfg cfg;
+  const double gamma = cfg.descuento_q8 / 256.0, alfa = 0.05;
+  std::mt19937 rng(semilla);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  out = base;
+  memset(out.visitas, 0, sizeof(out.visitas));
+  NodeEnv env;
+  for (int e = 0; e < episodios; ++e) {
+    env.reset(Site::random(rng), (float)(0.2 + 0.8 * u(rng)), (uint32_t)(u(rng) * 86400.0));
+    uint8_t s = QTablePolicy::stateOf(cfg, env.mV(), env.franja(), env.enlace());
+    for (int paso = 0; paso < 30 * 96; ++paso) {
+      int a = 0;
+      if (u(rng) < epsilon) {
+        a = (int)(u(rng) * A) % A;
+      } else {
+        for (int b = 1; b < A; ++b) if (out.q[s][b] >= out.q[s][a]) a = b; // empates: período largo
+      }
+      StepInfo info = env.step(cfg.periodos_ms[a]);
+      const double r = QTablePolicy::reward(cfg, s, cfg.periodos_ms[a], info.enCorte);
+      const uint8_t s2 = QTablePolicy::stateOf(cfg, env.mV(), env.franja(), env.enlace());
+      double maxQ = out.q[s2][0];
+      for (int b = 1; b < A; ++b) maxQ = std::max(maxQ, out.q[s2][b]);
+      out.q[s][a] += alfa * (r + gamma * maxQ - out.q[s][a]);
+      out.visitas[s][a]++;
+      s = s2;
+    }
+  }
+}
+
+Tabla entrenar(int hilos, int generaciones) {
+  Tabla compartida;
+  std::vector<Tabla> locales(hilos);
+  for (int g = 0; g < generaciones; ++g) {
+    const double epsilon = std::max(0.02, 0.3 * (1.0 - (double)g / generaciones));
+    std::vector<std::thread> ts;
+    for (int h = 0; h < hilos; ++h)
+      ts.emplace_back(entrenarHilo, std::cref(compartida), std::ref(locales[h]), (uint32_t)(g * 7919 + h * 104729 + 1), 8, epsilon);
+    for (auto& t : ts) t.join();
+    for (int s = 0; s < S; ++s)
+      for (int a = 0; a < A; ++a) {
+        uint64_t n = 0;
+        double suma = 0;
+        for (const Tabla& l : locales) { n += l.visitas[s][a]; suma += l.q[s][a] * l.visitas[s][a]; }
+        if (n > 0) compartida.q[s][a] = suma / n;
+        compartida.visitas[s][a] += n;
+      }
+    fprintf(stderr, "generacion %d/%d epsilon=%.2f\n", g + 1, generaciones, epsilon);
+  }
+  return compartida;
+}
+
+void exportar(const Tabla& t, const char* ruta, int hilos, int generaciones) {
+  FILE* f = fopen(ruta, "w");
+  if (!f) { perror(ruta); exit(1); }
+  fprintf(f, "/**\n"
+             " * @file QTableDefault.h\n"
+             " * @brief Tabla Q por defecto para QTablePolicy (generada, no editar a mano).\n"
+             " * Entrenada con extras/host/rl/qtable_trainer.cpp (train %d %d) sobre la\n"
+             " * distribución de sitios de NodeEnv; regenerarla si cambian los períodos,\n"
+             " * la cuantización del estado o la recompensa de QTablePolicy.\n"
+             " * @authors Francisco Rosales, Omar Tox\n"
+             " * @date 2025-09\n"
+             " */\n\n"
+             "#pragma once\n"
+             "#include <Arduino.h>\n"
+             "#include \"QTablePolicy.h\"\n\n"
+             "/// Estado = (SOC * FRANJAS + franja) * ENLACES + enlace; fila = acciones (período corto a largo).\n"
+             "static const int16_t QTABLA_DEFECTO[QTablePolicy::NUM_ESTADOS * QTablePolicy::ACCIONES] PROGMEM = {\n",
+          hilos, generaciones);
+  for (int s = 0; s < S; ++s) {
+    fprintf(f, "  ");
+    for (int a = 0; a < A; ++a) {
+      long v = lround(t.q[s][a]);
+      v = (v < -32768) ? -32768 : (v > 32767) ? 32767 : v;
+      fprintf(f, "%6ld,", v);
+    }
+    fprintf(f, "  // soc %d franja %d enlace %d\n", s / (QTablePolicy::FRANJAS * QTablePolicy::ENLACES),
+            (s / QTablePolicy::ENLACES) % QTablePolicy::FRANJAS, s % QTablePolicy::ENLACES);
+  }
+  fprintf(f, "};\n");
+  fclose(f);
+}
+
+// --- Evaluación ---
+
+struct Metricas {
+  double disponibilidad = 0;  ///< Fracción del tiempo fuera de corte.
+  double primerCorte_d  = 0;  ///< Día del primer corte (o el horizonte).
+  double aoi_s          = 0;  ///< Edad media de la información fuera de corte.
+  double enviosDia      = 0;
+};
+
+template <class Politica>
+Metricas evaluar(const std::vector<Site>& sitios, int dias, Politica crear) {
+  Metricas m;
+  for (const Site& sitio : sitios) {
+    NodeEnv env;
+    env.reset(sitio, 0.8f, 0);
+    auto elegir = crear();
+    uint32_t pasosArriba = 0, envios = 0;
+    double aoiArriba = 0, primerCorte = -1;
+    const int pasos = dias * 96;
+    for (int k = 0; k < pasos; ++k) {
+      const bool arriba = !env.enCorte();
+      StepInfo info = env.step(elegir(env));
+      if (arriba) { pasosArriba++; aoiArriba += info.aoiMedia_s; }
+      if (info.enCorte && primerCorte < 0) primerCorte = k / 96.0;
+      envios += info.envios;
+    }
+    m.disponibilidad += (double)pasosArriba / pasos;
+    m.primerCorte_d  += (primerCorte < 0) ? dias : primerCorte;
+    m.aoi_s          += pasosArriba ? aoiArriba / pasosArriba : 0.0;
+    m.enviosDia      += (double)envios / dias;
+  }
+  const double n = (double)sitios.size();
+  m.disponibilidad /= n; m.primerCorte_d /= n; m.aoi_s /= n; m.enviosDia /= n;
+  return m;
+}
+
+void imprimir(const char* nombre, const Metricas& m) {
+  printf("%-22s %10.1f%% %12.1f %10.1f %10.0f\n", nombre, 100.0 * m.disponibilidad, m.primerCorte_d, m.aoi_s, m.enviosDia);
+}
+
+void comparar(int nSitios, int dias, const int16_t* tabla, const char* nombreTabla) {
+  std::mt19937 rng(20250901); // sitios de prueba distintos a los de entrenamiento
+  std::vector<Site> sitios;
+  for (int i = 0; i < nSitios; ++i) sitios.push_back(Site::random(rng));
+
+  printf("%-22s %11s %12s %10s %10s\n", "politica", "disponible", "1er_corte_d", "AoI_s", "envios/d");
+  imprimir("niveles Cfg", evaluar(sitios, dias, [] {
+    auto nodo = std::make_shared<AdaptiveTXWSN>();
+    nodo->begin(AdaptiveTXWSN::Cfg());
+    return [nodo](const NodeEnv& env) {
+      nodo->setBatteryVolts(env.voltaje());
+      nodo->tick();
+      return nodo->currentPeriod();
+    };
+  }));
+  for (int ajuste = 0; ajuste < 2; ++ajuste) {
+    char nombre[64];
+    snprintf(nombre, sizeof(nombre), "%s%s", nombreTabla, ajuste ? "+ajuste" : "");
+    imprimir(nombre, evaluar(sitios, dias, [&] {
+      auto nodo = std::make_shared<AdaptiveTXWSN>();
+      auto pol = std::make_shared<QTablePolicy>();
+      auto buf = std::make_shared<std::vector<int16_t>>(S * A);
+      nodo->begin(AdaptiveTXWSN::Cfg());
+      pol->begin(QTablePolicy::Cfg(), tabla);
+      if (ajuste) pol->enableFineTuning(buf->data());
+      return [nodo, pol, buf](const NodeEnv& env) {
+        nodo->setPeriodOverride(pol->decide(env.mV(), env.franja(), env.enlace(), env.enCorte()));
+        nodo->setBatteryVolts(env.voltaje());
+        nodo->tick();
+        return nodo->currentPeriod();
+      };
+    }));
+  }
+}
+
+/** Errores TD de 2 unidades (< 2^corrimiento) deben mover el ajuste. */
+bool verificarAjuste() {
+  static int16_t ceros[S * A] = {};
+  int16_t buf[S * A];
+  QTablePolicy pol;
+  pol.begin(QTablePolicy::Cfg(), ceros);
+  pol.enableFineTuning(buf);
+  for (int k = 0; k < 64; ++k) pol.learn(0, 0, -2, 1);
+  const int16_t v = pol.value(0, 0);
+  const bool ok = (v == -2) && pol.value(0, 1) == 0;
+  printf("ajuste con error TD de -2: Q=%d  %s\n", v, ok ? "ok" : "FALLA");
+  return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 2 && strcmp(argv[1], "train") == 0) {
+    const int hilos = (argc > 2) ? atoi(argv[2]) : 4;
+    const int generaciones = (argc > 3) ? atoi(argv[3]) : 40;
+    const char* salida = (argc > 4) ? argv[4] : "src/QTableDefault.h";
+    Tabla t = entrenar(hilos, generaciones);
+    exportar(t, salida, hilos, generaciones);
+    std::vector<int16_t> q(S * A);
+    for (int s = 0; s < S; ++s)
+      for (int a = 0; a < A; ++a) q[s * A + a] = (int16_t)std::max(-32768L, std::min(32767L, lround(t.q[s][a])));
+    fprintf(stderr, "tabla escrita en %s\n", salida);
+    comparar(100, 120, q.data(), "tabla entrenada");
+    return 0;
+  }
+  if (argc >= 2 && strcmp(argv[1], "eval") == 0) {
+    comparar((argc > 2) ? atoi(argv[2]) : 200, (argc > 3) ? atoi(argv[3]) : 120, QTABLA_DEFECTO, "QTABLA_DEFECTO");
+    return 0;
+  }
+  if (argc >= 2 && strcmp(argv[1], "check") == 0) return verificarAjuste() ? 0 : 1;
+  fprintf(stderr, "uso: qtable_trainer train [hilos] [generaciones] [salida.h]\n"
+                  "     qtable_trainer eval [sitios] [dias]\n"
+                  "     qtable_trainer check\n");
+  return 2;
+}
@@ -0,0 +1,322 @@
+/**
+ * @file BatteryModels.h
+ * @brief Modelos de batería para el simulador: curva de voltaje en circuito
+ * abierto por química, capacidad ideal, ley de Peukert y modelo cinético de
+ * dos pozos (KiBaM, Manwell y McGowan) con efecto de tasa y de recuperación,
+ * más resistencia interna con polarización (caída al transmitir) y
+ * dependencia de la temperatura.
+ *
+ * Entre eventos la batería sólo entrega la corriente de reposo, así que su
+ * estado se calcula en forma cerrada en cualquier instante: Battery cumple el
+ * concepto de modelo de voltaje de SkipAhead (`volts()` y `crossing()`) y se
+ * descuenta cada envío desde el observador de envíos, sin volver a pasos
+ * fijos. En un loop() paso a paso se usa igual: `setBatteryVolts(bat.volts(t))`
+ * y `bat.onSend(t)` cuando tick() devuelve true.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "SkipAhead.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace atx {
+namespace sim {
+
+/**
+ * @struct OcvCurve
+ * @brief Voltaje en circuito abierto en 11 puntos de estado de carga (0 %, 10 %, ..., 100 %).
+ */
+struct OcvCurve {
+  const char* nombre;
+  float       v[11];
+
+  /** @brief Interpolación lineal; `soc` se satura a [0, 1]. */
+  float volts(double soc) const {
+    if (soc <= 0.0) return v[0];
+    if (soc >= 1.0) return v[10];
+    const double x = soc * 10.0;
+    const int i = (int)x;
+    return (float)(v[i] + (v[i + 1] - v[i]) * (x - i));
+  }
+};
+
+/// Rampa lineal de 3.30 V a 4.20 V (la aproximación habitual de las simulaciones).
+static const OcvCurve CURVA_LINEAL  = { "lineal",  { 3.30f, 3.39f, 3.48f, 3.57f, 3.66f, 3.75f, 3.84f, 3.93f, 4.02f, 4.11f, 4.20f } };
+/// Celda LiPo/Li-ion 1S típica a 25 °C (codo abajo del 10 %).
+static const OcvCurve CURVA_LIPO    = { "lipo",    { 3.27f, 3.61f, 3.69f, 3.71f, 3.73f, 3.75f, 3.79f, 3.84f, 3.92f, 4.03f, 4.18f } };
+/// Celda LiFePO4: meseta casi plana entre 20 % y 90 %.
+static const OcvCurve CURVA_LIFEPO4 = { "lifepo4", { 2.50f, 3.00f, 3.20f, 3.25f, 3.27f, 3.28f, 3.29f, 3.30f, 3.32f, 3.35f, 3.60f } };
+
+/**
+ * @struct CellCfg
+ * @brief Parámetros de la celda, de la carga del nodo y del sitio.
+ */
+struct CellCfg {
+  const OcvCurve* curva                    = &CURVA_LIPO;
+  float           capacidad_mAh            = 500.0f;             ///< Capacidad nominal a 25 °C y baja corriente.
+  float           corrienteReposo_uA       = 19.0f;              ///< Media entre envíos: reposo más lecturas de batería.
+  uint32_t        cargaEnvio_uC            = 2500;               ///< Carga de una transmisión.
+  float           corrienteEnvio_mA        = 50.0f;              ///< Corriente de la radio al transmitir.
+  // KiBaM
+  float           fraccionDisponible       = 0.166f;             ///< c: fracción de la carga en el pozo disponible.
+  float           difusion_1_h             = 0.0122f;            ///< k: constante de difusión entre pozos (1/h).
+  // Peukert
+  float           exponentePeukert         = 1.05f;              ///< 1: sin efecto de tasa.
+  float           corrienteNominal_mA      = 25.0f;              ///< Corriente de la capacidad nominal (C/20).
+  // Resistencia interna a 25 °C
+  float           rOhmica_ohm              = 0.15f;
+  float           rPolarizacion_ohm        = 0.10f;
+  float           tauPolarizacion_s        = 20.0f;              ///< Constante de tiempo de la rama RC.
+  float           bArrhenius_K             = 3000.0f;            ///< R(T) = R25 · exp(B · (1/T - 1/298.15 K)).
+  // Sitio
+  float           temperaturaMedia_C       = 25.0f;
+  float           temperaturaAmplitud_C    = 0.0f;               ///< Variación diaria (senoidal, mínima a `horaMinima`).
+  float           horaMinima               = 4.0f;
+  float           perdidaCapacidadPorGrado = 0.006f;             ///< Fracción de capacidad inaccesible por °C bajo 25 °C.
+  float           tensionMinima_V          = 3.00f;              ///< Apagado del regulador: se registra si un envío la perfora.
+  // Búsqueda de cruces
+  uint32_t        pasoBusqueda_ms          = 60000UL;            ///< Muestreo de volts() en crossing() (luego bisección).
+  uint64_t        horizonteBusqueda_ms     = 2ULL * 86400000ULL; ///< Sin cruce en este plazo: SIN_CRUCE.
+};
+
+// ----------------------------------------------------------------- Pozos
+//
+// Un pozo lleva la carga y cumple:
+//  - `void begin(const CellCfg&)`: celda llena;
+//  - `void draw(double corriente_uA, double dt_s)`: corriente constante durante dt;
+//  - `void pulse(double carga_uC, double corriente_mA)`: pulso corto (un envío);
+//  - `double soc() const`: estado de carga que ve la curva OCV, en [0, 1].
+// Se copian para evaluar instantes futuros sin tocar el estado.
+
+/** @brief Contador de Coulomb: la capacidad no depende de la corriente. */
+class IdealWell {
+public:
+  void begin(const CellCfg& c) {
+    _capacidad_uC = c.capacidad_mAh * 3.6e6;
+    _q_uC = _capacidad_uC;
+  }
+
+  void draw(double corriente_uA, double dt_s) { _q_uC = std::max(0.0, _q_uC - corriente_uA * dt_s); }
+
+  void pulse(double carga_uC, double) { _q_uC = std::max(0.0, _q_uC - carga_uC); }
+
+  double soc() const { return _q_uC / _capacidad_uC; }
+
+private:
+  double _capacidad_uC = 1.0;
+  double _q_uC         = 0.0;
+};
+
+/**
+ * @brief Ley de Peukert: por encima de la corriente nominal cada µC entregado
+ * cuesta (I / I_nominal)^(n - 1) µC de capacidad. Por debajo no se aplica
+ * (la ley extrapolada daría capacidad de sobra a corrientes de µA).
+ */
+class PeukertWell {
+public:
+  void begin(const CellCfg& c) {
+    _base.begin(c);
+    _n = c.exponentePeukert;
+    _nominal_mA = c.corrienteNominal_mA;
+  }
+
+  void draw(double corriente_uA, double dt_s) { _base.draw(corriente_uA * factor(corriente_uA / 1000.0), dt_s); }
+
+  void pulse(double carga_uC, double corriente_mA) { _base.pulse(carga_uC * factor(corriente_mA), corriente_mA); }
+
+  double soc() const { return _base.soc(); }
+
+private:
+  IdealWell _base;
+  double    _n          = 1.0;
+  double    _nominal_mA = 1.0;
+
+  double factor(double corriente_mA) const {
+    return (corriente_mA <= _nominal_mA) ? 1.0 : std::pow(corriente_mA / _nominal_mA, _n - 1.0);
+  }
+};
+
+/**
+ * @brief KiBaM: la carga disponible (fracción c) alimenta la carga y se
+ * repone desde la ligada con flujo k · (h2 - h1). A corriente alta el pozo
+ * disponible se vacía antes de que llegue la ligada (efecto de tasa) y en
+ * reposo vuelve a subir (recuperación). El voltaje sigue al pozo disponible.
+ */
+class KineticWell {
+public:
+  void begin(const CellCfg& c) {
+    _capacidad_uC = c.capacidad_mAh * 3.6e6;
+    _c = c.fraccionDisponible;
+    _kp = c.difusion_1_h / 3600.0 / (_c * (1.0 - _c));
+    _y1 = _c * _capacidad_uC;
+    _y2 = (1.0 - _c) * _capacidad_uC;
+  }
+
+  /** Solución cerrada de Manwell y McGowan para corriente constante. */
+  void draw(double corriente_uA, double dt_s) {
+    if (dt_s <= 0.0) return;
+    const double x = _kp * dt_s;
+    const double unoMenosE = -std::expm1(-x);
+    const double e = 1.0 - unoMenosE;
+    const double rampa = (x - unoMenosE) / _kp;
+    const double y0 = _y1 + _y2;
+    const double y1 = _y1 * e + (y0 * _kp * _c - corriente_uA) * unoMenosE / _kp - corriente_uA * _c * rampa;
+    const double y2 = _y2 * e + y0 * (1.0 - _c) * unoMenosE - corriente_uA * (1.0 - _c) * rampa;
+    _y1 = std::max(0.0, y1);
+    _y2 = std::max(0.0, y2);
+  }
+
+  /** El pulso dura ms frente a horas de difusión: sale todo del pozo disponible. */
+  void pulse(double carga_uC, double) { _y1 = std::max(0.0, _y1 - carga_uC); }
+
+  double soc() const { return _y1 / (_c * _capacidad_uC); }
+
+  /** @brief Carga que queda en el pozo ligado (inaccesible si el disponible se vacía). */
+  double boundUc() const { return _y2; }
+
+private:
+  double _capacidad_uC = 1.0;
+  double _c            = 0.5;
+  double _kp           = 0.0; ///< k' = k / (c (1 - c)), en 1/s.
+  double _y1           = 0.0;
+  double _y2           = 0.0;
+};
+
+// --------------------------------------------------------------- Batería
+
+/**
+ * @class Battery
+ * @brief Voltaje en bornes de una celda con el pozo `Pozo`: OCV del estado de
+ * carga (restando la capacidad que el frío vuelve inaccesible) menos la caída
+ * óhmica de la corriente de reposo y la tensión de la rama de polarización,
+ * cargada por cada envío y descargándose con `tauPolarizacion_s`.
+ */
+template <class Pozo = KineticWell>
+class Battery {
+public:
+  /**
+   * @brief Celda llena en `t0_ms`.
+   * @param cfg Parámetros.
+   * @param t0_ms Instante inicial.
+   */
+  void begin(const CellCfg& cfg, uint64_t t0_ms = 0) {
+    _cfg = cfg;
+    _pozo = Pozo();
+    _pozo.begin(cfg);
+    _t_ms = t0_ms;
+    _polarizacion_V = 0.0;
+    _entregado_uC = 0.0;
+    _minimoEnEnvio_V = 99.0f;
+    _primerApagado_ms = 0;
+    _envios = 0;
+  }
+
+  /**
+   * @brief Descuenta un envío en `t_ms` (no anterior al último evento).
+   * @return Voltaje en bornes durante la transmisión.
+   */
+  float onSend(uint64_t t_ms) {
+    advance(t_ms);
+    const double corriente_mA = _cfg.corrienteEnvio_mA;
+    const double duracion_s = _cfg.cargaEnvio_uC / (corriente_mA * 1000.0);
+    const double temp_C = temperature(t_ms);
+    const float bajoCarga = (float)(volts(t_ms) - corriente_mA / 1000.0 * resistencia(_cfg.rOhmica_ohm, temp_C));
+    _pozo.pulse(_cfg.cargaEnvio_uC, corriente_mA);
+    const double e = std::exp(-duracion_s / _cfg.tauPolarizacion_s);
+    _polarizacion_V = _polarizacion_V * e +
+                      corriente_mA / 1000.0 * resistencia(_cfg.rPolarizacion_ohm, temp_C) * (1.0 - e);
+    _entregado_uC += _cfg.cargaEnvio_uC;
+    _envios++;
+    if (bajoCarga < _minimoEnEnvio_V) _minimoEnEnvio_V = bajoCarga;
+    if (bajoCarga < _cfg.tensionMinima_V && _primerApagado_ms == 0) _primerApagado_ms = t_ms;
+    return bajoCarga;
+  }
+
+  /** @brief Lleva el estado a `t_ms` con la corriente de reposo (no hace falta llamarlo: volts() lo calcula). */
+  void advance(uint64_t t_ms) {
+    if (t_ms <= _t_ms) return;
+    const double dt_s = (t_ms - _t_ms) / 1000.0;
+    _pozo.draw(_cfg.corrienteReposo_uA, dt_s);
+    _polarizacion_V *= std::exp(-dt_s / _cfg.tauPolarizacion_s);
+    _entregado_uC += _cfg.corrienteReposo_uA * dt_s;
+    _t_ms = t_ms;
+  }
+
+  /** @brief Voltaje en bornes en reposo en `t_ms` (instantes anteriores al último evento: el de ese evento). */
+  float volts(uint64_t t_ms) const {
+    Pozo p = _pozo;
+    double polarizacion_V = _polarizacion_V;
+    if (t_ms > _t_ms) {
+      const double dt_s = (t_ms - _t_ms) / 1000.0;
+      p.draw(_cfg.corrienteReposo_uA, dt_s);
+      polarizacion_V *= std::exp(-dt_s / _cfg.tauPolarizacion_s);
+    }
+    const double temp_C = temperature(t_ms);
+    const double accesible = 1.0 - _cfg.perdidaCapacidadPorGrado * std::max(0.0, 25.0 - temp_C);
+    const double soc = (accesible > 0.0) ? 1.0 - (1.0 - p.soc()) / accesible : 0.0;
+    return (float)(_cfg.curva->volts(soc) -
+                   _cfg.corrienteReposo_uA * 1e-6 * resistencia(_cfg.rOhmica_ohm, temp_C) - polarizacion_V);
+  }
+
+  /**
+   * @brief Primer instante en [desde_ms, hasta_ms] en que volts() cruza el
+   * umbral (concepto de SkipAhead): muestreo cada `pasoBusqueda_ms` y
+   * bisección. El voltaje no es monótono (recuperación, temperatura), así
+   * que una excursión más corta que el paso de búsqueda puede no verse.
+   */
+  uint64_t crossing(uint64_t desde_ms, uint64_t hasta_ms, float umbral_V, bool bajando) const {
+    if (cumple(volts(desde_ms), umbral_V, bajando)) return desde_ms;
+    const uint64_t fin = std::min(hasta_ms, desde_ms + _cfg.horizonteBusqueda_ms);
+    uint64_t a = desde_ms;
+    while (a < fin) {
+      const uint64_t b = std::min(fin, a + _cfg.pasoBusqueda_ms);
+      if (cumple(volts(b), umbral_V, bajando)) {
+        uint64_t lo = a, hi = b; // lo no cumple, hi cumple
+        while (hi - lo > 1) {
+          const uint64_t m = lo + (hi - lo) / 2;
+          if (cumple(volts(m), umbral_V, bajando)) hi = m; else lo = m;
+        }
+        return hi;
+      }
+      a = b;
+    }
+    return SIN_CRUCE;
+  }
+
+  /** @brief Temperatura del sitio en `t_ms` (°C). */
+  double temperature(uint64_t t_ms) const {
+    const double hora = std::fmod(t_ms / 3600000.0, 24.0);
+    return _cfg.temperaturaMedia_C - _cfg.temperaturaAmplitud_C * std::cos(2.0 * M_PI * (hora - _cfg.horaMinima) / 24.0);
+  }
+
+  // ---------------- Getters
+  const CellCfg& cfg() const { return _cfg; }
+  const Pozo& well() const { return _pozo; }
+  double deliveredUc() const { return _entregado_uC; }          ///< Carga entregada hasta el último evento.
+  float minSendVolts() const { return _minimoEnEnvio_V; }       ///< Menor voltaje en bornes durante un envío.
+  uint64_t firstBrownoutMs() const { return _primerApagado_ms; } ///< Primer envío bajo `tensionMinima_V` (0 si no hubo).
+  uint32_t sends() const { return _envios; }
+
+private:
+  CellCfg  _cfg;
+  Pozo     _pozo;
+  uint64_t _t_ms             = 0;   ///< Último evento.
+  double   _polarizacion_V   = 0.0; ///< Tensión de la rama RC en `_t_ms`.
+  double   _entregado_uC     = 0.0;
+  float    _minimoEnEnvio_V  = 99.0f;
+  uint64_t _primerApagado_ms = 0;
+  uint32_t _envios           = 0;
+
+  double resistencia(double r25_ohm, double temp_C) const {
+    return r25_ohm * std::exp(_cfg.bArrhenius_K * (1.0 / (temp_C + 273.15) - 1.0 / 298.15));
+  }
+
+  static bool cumple(float v, float umbral_V, bool bajando) { return bajando ? (v < umbral_V) : (v >= umbral_V); }
+};
+
+} // namespace sim
+} // namespace atx
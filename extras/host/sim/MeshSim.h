@@ -0,0 +1,329 @@
+/**
+ * @file MeshSim.h
+ * @brief Simulador de una red multi-salto de nodos AdaptiveTXWSN hacia un gateway.
+ * Cada nodo corre su AdaptiveTXWSN, VoltageTrend, RoutingCost y EnergyLedger
+ * reales bajo el reloj virtual; el simulador sólo modela la batería (carga
+ * restante y voltaje lineal en el estado de carga), la topología por alcance
+ * de radio y el costo en carga de transmitir, recibir y escuchar. En cada baliza de ruteo los
+ * nodos eligen padre por costo de camino mínimo (Dijkstra con pesos en los
+ * nodos), con conteo de saltos o con el costo consciente de la batería.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <EnergyLedger.h>
+#include <RoutingCost.h>
+#include <VoltageTrend.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace atx {
+namespace sim {
+
+/**
+ * @struct MeshCfg
+ * @brief Parámetros de la red simulada.
+ */
+struct MeshCfg {
+  uint32_t nodos              = 150;
+  float    lado_m             = 1000.0f;  ///< Área cuadrada; el gateway está en el centro.
+  float    alcance_m          = 170.0f;   ///< Alcance de radio (disco unitario).
+  float    capacidadMin_mAh   = 800.0f;
+  float    capacidadMax_mAh   = 2400.0f;
+  float    voltajeVacio_V     = 3.30f;    ///< Voltaje con la celda vacía (lineal en el estado de carga).
+  float    voltajeLleno_V     = 4.15f;    ///< Voltaje con la celda llena.
+  uint32_t cargaEnvio_uC      = 2500;     ///< Transmitir un paquete (propio o reenviado).
+  uint32_t cargaRecepcion_uC  = 1500;     ///< Recibir un paquete de un hijo.
+  uint16_t corrienteReposo_uA = 15;
+  uint16_t corrienteRx_uA     = 5000;     ///< Radio en recepción.
+  float    cicloEscuchaRelevo = 0.02f;    ///< Fracción del tiempo que escucha un nodo con hijos.
+  uint32_t pasoRuteo_ms       = 600000UL; ///< Intervalo entre balizas de ruteo (y paso de simulación).
+  uint16_t histeresisPadre_q8 = 2048;     ///< Ventaja mínima (ocho saltos) para abandonar el padre actual.
+  uint16_t histeresisRelativa_q8 = 64;    ///< Ventaja mínima como fracción del mejor camino (Q0.8, 64 = 25 %).
+  uint32_t permanenciaPadre_ms = 86400000UL; ///< Tiempo mínimo con un padre vivo antes de cambiarlo por costo (1 día).
+  float    dias               = 730.0f;   ///< Horizonte máximo.
+  uint32_t semilla            = 7;
+  bool     costoConsciente    = true;     ///< false: conteo de saltos (todos los nodos cuestan UN_SALTO).
+  bool     relevoEnPeriodo    = false;    ///< true: cada nodo pasa EnergyLedger::relayCurrentUa() a setRelayCurrentUa().
+  AdaptiveTXWSN::Cfg nodo;                ///< Configuración común de los nodos (`pinAdcBateria` se ignora).
+  RoutingCost::Cfg   costo;
+};
+
+/**
+ * @struct MeshResult
+ * @brief Vida de la red: instantes en que se pierde una fracción de los nodos
+ * (en corte o sin camino al gateway) y paquetes entregados.
+ */
+struct MeshResult {
+  double   primeraPerdida_dias = -1;  ///< Primer nodo perdido (-1 si no ocurrió).
+  double   perdida10_dias      = -1;  ///< 10 % de los nodos perdidos.
+  double   perdida50_dias      = -1;  ///< 50 % de los nodos perdidos.
+  uint64_t generados           = 0;   ///< Paquetes propios generados por nodos fuera de corte.
+  uint64_t entregados          = 0;   ///< Paquetes que llegaron al gateway.
+  uint32_t cambiosPadre        = 0;   ///< Cambios de padre (estabilidad del ruteo).
+  uint32_t nodosConectados     = 0;   ///< Nodos alcanzables al inicio.
+};
+
+/**
+ * @class MeshSim
+ * @brief Red de nodos con batería y ruteo por costo de camino.
+ */
+class MeshSim {
+public:
+  static constexpr uint32_t GATEWAY = 0xFFFFFFFFUL; ///< "Padre" de los nodos a un salto.
+  static constexpr uint32_t NINGUNO = 0xFFFFFFFEUL; ///< Sin camino.
+
+  /**
+   * @brief Genera la topología y los nodos (misma semilla = misma red).
+   */
+  void begin(const MeshCfg& cfg) {
+    _cfg = cfg;
+    std::mt19937 rng(cfg.semilla);
+    std::uniform_real_distribution<float> pos(0.0f, cfg.lado_m), cap(cfg.capacidadMin_mAh, cfg.capacidadMax_mAh);
+    const uint32_t n = cfg.nodos;
+    _nodos.assign(n, Nodo());
+    std::vector<float> x(n), y(n);
+    for (uint32_t i = 0; i < n; ++i) {
+      x[i] = pos(rng);
+      y[i] = pos(rng);
+      _nodos[i].capacidad_uC = cap(rng) * 3600.0f * 1000.0f;
+      _nodos[i].carga_uC     = _nodos[i].capacidad_uC;
+    }
+    const float cx = cfg.lado_m / 2, cy = cfg.lado_m / 2, r2 = cfg.alcance_m * cfg.alcance_m;
+    for (uint32_t i = 0; i < n; ++i) {
+      Nodo& a = _nodos[i];
+      a.alGateway = (x[i] - cx) * (x[i] - cx) + (y[i] - cy) * (y[i] - cy) <= r2;
+      for (uint32_t j = 0; j < n; ++j)
+        if (j != i && (x[i] - x[j]) * (x[i] - x[j]) + (y[i] - y[j]) * (y[i] - y[j]) <= r2) a.vecinos.push_back(j);
+    }
+
+    AdaptiveTXWSN::Cfg c = cfg.nodo;
+    c.pinAdcBateria = -1;
+    EnergyLedger::Cfg costos;
+    costos.corrienteReposo_uA  = cfg.corrienteReposo_uA;
+    costos.cargaEnvio_uC       = cfg.cargaEnvio_uC;
+    costos.cargaReenvio_uC     = cfg.cargaEnvio_uC + cfg.cargaRecepcion_uC;
+    costos.corrienteEscucha_uA = cfg.corrienteRx_uA;
+    _corte_mV = (uint16_t)(c.corteVoltaje_V * 1000.0f + 0.5f);
+    setMillis(0);
+    for (Nodo& a : _nodos) {
+      a.nodo = AdaptiveTXWSN();
+      a.nodo.begin(c);
+      a.tendencia.begin();
+      a.libro.begin(costos, 0);
+      a.ruteo.begin(cfg.costo, a.libro, 0);
+    }
+  }
+
+  /**
+   * @brief Ejecuta la simulación hasta perder el 90 % de los nodos o agotar el horizonte.
+   */
+  MeshResult run() {
+    MeshResult r;
+    const uint32_t n = (uint32_t)_nodos.size();
+    const uint64_t fin_ms = (uint64_t)(_cfg.dias * 86400000.0);
+    const double paso_s = _cfg.pasoRuteo_ms / 1000.0;
+    std::vector<uint16_t> propio(n), camino(n);
+    std::vector<uint32_t> orden;
+    std::vector<double> trafico(n);
+    std::vector<uint32_t> hijos(n);
+    bool primerPaso = true;
+
+    for (uint64_t t_ms = 0; t_ms <= fin_ms; t_ms += _cfg.pasoRuteo_ms) {
+      const uint32_t ahora = (uint32_t)t_ms;
+      setMillis(ahora);
+
+      // 1) Estado de energía de cada nodo con su propio código
+      for (Nodo& a : _nodos) {
+        float v = voltaje(a);
+        a.nodo.setBatteryVolts(v);
+        a.libro.onTick(ahora, false);
+        if (_cfg.relevoEnPeriodo) a.nodo.setRelayCurrentUa(a.libro.relayCurrentUa(), a.libro.sendChargeUc());
+        a.nodo.tick();
+        a.tendencia.addSample(ahora, (uint16_t)(v * 1000.0f + 0.5f));
+      }
+
+      // 2) Costo propio que anuncia cada nodo
+      for (uint32_t i = 0; i < n; ++i) {
+        Nodo& a = _nodos[i];
+        uint16_t consciente = a.ruteo.update(a.nodo, a.libro, a.tendencia.secondsTo(_corte_mV), ahora);
+        propio[i] = a.nodo.isCutoff() ? RoutingCost::INALCANZABLE
+                  : _cfg.costoConsciente ? consciente : RoutingCost::UN_SALTO;
+      }
+
+      // 3) Ruteo y orden de reenvío (de las hojas al gateway)
+      r.cambiosPadre += rutear(propio, camino, orden, t_ms);
+      uint32_t perdidos = 0;
+      for (uint32_t i = 0; i < n; ++i)
+        if (_nodos[i].nodo.isCutoff() || _nodos[i].padre == NINGUNO) perdidos++;
+      if (primerPaso) { r.nodosConectados = n - perdidos; primerPaso = false; }
+      const double dias = t_ms / 86400000.0;
+      if (perdidos > 0 && r.primeraPerdida_dias < 0) r.primeraPerdida_dias = dias;
+      if (perdidos * 10 >= n && r.perdida10_dias < 0) r.perdida10_dias = dias;
+      if (perdidos * 2 >= n && r.perdida50_dias < 0) r.perdida50_dias = dias;
+      if (perdidos * 10 >= n * 9) break;
+
+      // 4) Tráfico del paso y su costo en carga
+      std::fill(trafico.begin(), trafico.end(), 0.0);
+      std::fill(hijos.begin(), hijos.end(), 0);
+      for (uint32_t i = 0; i < n; ++i)
+        if (_nodos[i].padre < n) hijos[_nodos[i].padre]++;
+      for (uint32_t i = 0; i < n; ++i) {
+        Nodo& a = _nodos[i];
+        a.carga_uC -= _cfg.corrienteReposo_uA * paso_s;
+        if (hijos[i] > 0) {
+          const uint32_t escucha_ms = (uint32_t)(_cfg.pasoRuteo_ms * _cfg.cicloEscuchaRelevo);
+          a.carga_uC -= _cfg.corrienteRx_uA * (escucha_ms / 1000.0);
+          a.libro.onListen(escucha_ms);
+        }
+        if (a.nodo.isCutoff()) continue;
+        a.pendientes += (double)_cfg.pasoRuteo_ms / (double)a.nodo.currentPeriod();
+        double generados = std::floor(a.pendientes);
+        a.pendientes -= generados;
+        r.generados += (uint64_t)generados;
+        if (a.padre != NINGUNO) trafico[i] += generados;
+      }
+      for (auto it = orden.rbegin(); it != orden.rend(); ++it) {
+        const uint32_t i = *it;
+        Nodo& a = _nodos[i];
+        a.carga_uC -= trafico[i] * _cfg.cargaEnvio_uC;
+        if (a.padre == GATEWAY) { r.entregados += (uint64_t)trafico[i]; continue; }
+        Nodo& p = _nodos[a.padre];
+        p.carga_uC -= trafico[i] * _cfg.cargaRecepcion_uC;
+        p.libro.onForward((uint16_t)std::min(trafico[i], 65535.0));
+        trafico[a.padre] += trafico[i];
+      }
+      for (Nodo& a : _nodos) if (a.carga_uC < 0) a.carga_uC = 0;
+    }
+    return r;
+  }
+
+private:
+  struct Nodo {
+    AdaptiveTXWSN         nodo = AdaptiveTXWSN();
+    VoltageTrend          tendencia;
+    RoutingCost           ruteo;
+    EnergyLedger          libro;
+    double                capacidad_uC = 0;
+    double                carga_uC     = 0;
+    double                pendientes   = 0;       ///< Fracción de paquete acumulada.
+    uint32_t              padre        = NINGUNO;
+    uint64_t              desdePadre_ms = 0;      ///< Instante del último cambio de padre.
+    bool                  alGateway    = false;
+    std::vector<uint32_t> vecinos;
+  };
+
+  MeshCfg           _cfg;
+  std::vector<Nodo> _nodos;
+  uint16_t          _corte_mV = 3400;
+
+  float voltaje(const Nodo& a) const {
+    float soc = (float)(a.carga_uC / a.capacidad_uC);
+    return _cfg.voltajeVacio_V + (_cfg.voltajeLleno_V - _cfg.voltajeVacio_V) * soc;
+  }
+
+  /**
+   * Dijkstra desde el gateway: camino[v] = accumulate(min camino del vecino, propio[v]).
+   * Cada nodo conserva su padre si su camino no supera al mejor en más de la
+   * histéresis. `orden` queda en orden de extracción (padres antes que hijos).
+   * @return Número de cambios de padre.
+   */
+  uint32_t rutear(const std::vector<uint16_t>& propio, std::vector<uint16_t>& camino, std::vector<uint32_t>& orden,
+                  uint64_t t_ms) {
+    const uint32_t n = (uint32_t)_nodos.size();
+    std::fill(camino.begin(), camino.end(), RoutingCost::INALCANZABLE);
+    orden.clear();
+    typedef std::pair<uint16_t, uint32_t> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> cola;
+    for (uint32_t i = 0; i < n; ++i) {
+      if (_nodos[i].alGateway && propio[i] != RoutingCost::INALCANZABLE) {
+        camino[i] = RoutingCost::accumulate(0, propio[i]);
+        cola.push(Item(camino[i], i));
+      }
+    }
+    std::vector<uint8_t> hecho(n, 0);
+    while (!cola.empty()) {
+      Item it = cola.top();
+      cola.pop();
+      const uint32_t u = it.second;
+      if (hecho[u] || it.first != camino[u]) continue;
+      hecho[u] = 1;
+      orden.push_back(u);
+      for (uint32_t v : _nodos[u].vecinos) {
+        if (hecho[v] || propio[v] == RoutingCost::INALCANZABLE) continue;
+        uint16_t c = RoutingCost::accumulate(camino[u], propio[v]);
+        if (c < camino[v]) { camino[v] = c; cola.push(Item(c, v)); }
+      }
+    }
+
+    // Mejor padre entre los vecinos resueltos antes que el nodo (el árbol que
+    // forman es acíclico aunque los caminos saturen). El padre actual se
+    // conserva mientras siga vivo y no lo supere el mejor en más de la
+    // histéresis, o si aún no cumple `permanenciaPadre_ms`.
+    std::vector<uint32_t> rango(n, NINGUNO), mejorPadre(n, NINGUNO), elegido(n, NINGUNO);
+    for (uint32_t k = 0; k < (uint32_t)orden.size(); ++k) rango[orden[k]] = k;
+    for (uint32_t i = 0; i < n; ++i) {
+      Nodo& a = _nodos[i];
+      if (!hecho[i]) continue;
+      uint32_t mejor = RoutingCost::INALCANZABLE;
+      if (a.alGateway) { mejorPadre[i] = GATEWAY; mejor = 0; }
+      for (uint32_t v : a.vecinos)
+        if (rango[v] < rango[i] && camino[v] < mejor) { mejor = camino[v]; mejorPadre[i] = v; }
+      elegido[i] = mejorPadre[i];
+      const uint32_t actual = a.padre;
+      if (actual == NINGUNO || actual == mejorPadre[i]) continue;
+      if (actual != GATEWAY && !hecho[actual]) continue;
+      const uint32_t cActual = (actual == GATEWAY) ? 0 : camino[actual];
+      uint32_t margen = (mejor * _cfg.histeresisRelativa_q8) >> 8;
+      if (margen < _cfg.histeresisPadre_q8) margen = _cfg.histeresisPadre_q8;
+      const bool reciente = t_ms - a.desdePadre_ms < _cfg.permanenciaPadre_ms;
+      if (reciente || cActual <= mejor + margen) elegido[i] = actual;
+    }
+
+    // Un padre conservado puede cerrar un ciclo: los nodos que no llegan al
+    // gateway siguiendo `elegido` toman su mejor padre (que sí llega).
+    std::vector<uint8_t> estado(n, 0); // 0 sin visitar, 1 en curso, 2 llega, 3 no llega
+    std::vector<uint32_t> pila;
+    for (uint32_t i = 0; i < n; ++i) {
+      uint32_t u = i;
+      while (u < n && estado[u] == 0 && hecho[u]) { estado[u] = 1; pila.push_back(u); u = elegido[u]; }
+      const uint8_t fin = (u == GATEWAY || (u < n && estado[u] == 2)) ? 2 : 3;
+      for (uint32_t w : pila) estado[w] = fin;
+      pila.clear();
+    }
+    for (uint32_t i = 0; i < n; ++i)
+      if (hecho[i] && estado[i] == 3) elegido[i] = mejorPadre[i];
+
+    uint32_t cambios = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+      Nodo& a = _nodos[i];
+      const uint32_t nuevo = elegido[i];
+      if (nuevo != a.padre && a.padre != NINGUNO && nuevo != NINGUNO) cambios++;
+      if (nuevo != a.padre) a.desdePadre_ms = t_ms;
+      a.padre = nuevo;
+    }
+
+    // Con padres conservados el orden de Dijkstra ya no es el del árbol:
+    // se rehace en anchura desde el gateway (padres antes que hijos).
+    std::vector<std::vector<uint32_t>> hijos(n);
+    orden.clear();
+    for (uint32_t i = 0; i < n; ++i) {
+      if (_nodos[i].padre == GATEWAY) orden.push_back(i);
+      else if (_nodos[i].padre < n) hijos[_nodos[i].padre].push_back(i);
+    }
+    for (size_t k = 0; k < orden.size(); ++k)
+      for (uint32_t h : hijos[orden[k]]) orden.push_back(h);
+    return cambios;
+  }
+};
+
+} // namespace sim
+} // namespace atx
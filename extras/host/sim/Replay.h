@@ -0,0 +1,170 @@
+/**
+ * @file Replay.h
+ * @brief Motor de reproducción: ejecuta AdaptiveTXWSN sobre una traza de voltaje
+ * con el reloj virtual de `extras/host/Arduino.h`.
+ * Entre dos muestras el voltaje se mantiene constante (retención de orden
+ * cero) y tick() se llama cada `paso_ms`, igual que lo haría el loop() del
+ * nodo. Se acumulan las métricas que usamos para comparar configuraciones.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+
+namespace atx {
+namespace sim {
+
+/**
+ * @struct Sample
+ * @brief Una muestra de la traza: instante (ms, relativo al inicio) y voltaje.
+ */
+struct Sample {
+  uint32_t t_ms;
+  float    volts;
+};
+
+/**
+ * @struct ReplayResult
+ * @brief Métricas acumuladas durante la reproducción.
+ */
+struct ReplayResult {
+  uint32_t envios             = 0;  ///< Veces que tick() devolvió true.
+  uint32_t msPorNivel[3]      = {}; ///< Tiempo (ms) en cada Level fuera de corte.
+  uint32_t msEnCorte          = 0;  ///< Tiempo (ms) con isCutoff() = true.
+  uint32_t cambiosNivel       = 0;  ///< Transiciones de Level (rebotes incluidos).
+  uint32_t entradasCorte      = 0;  ///< Veces que se entró en corte.
+  uint32_t silencioMaximo_ms  = 0;  ///< Mayor intervalo entre envíos consecutivos.
+  uint32_t ultimoEnvio_ms     = 0;  ///< Instante del último envío.
+  uint32_t duracion_ms        = 0;  ///< Tiempo simulado total.
+};
+
+/**
+ * @class Replay
+ * @brief Alimenta una instancia de AdaptiveTXWSN con muestras de voltaje.
+ *
+ * Uso: begin(), luego feed() por cada muestra en orden temporal (puede venir
+ * de un archivo, del almacén de series o de un modelo), y result() al final.
+ */
+class Replay {
+public:
+  /**
+   * @brief Reinicia el reloj virtual y el nodo.
+   * @param cfg Configuración del nodo a evaluar (se fuerza `pinAdcBateria = -1`).
+   * @param paso_ms Intervalo entre llamadas a tick() (período del loop()).
+   */
+  void begin(const AdaptiveTXWSN::Cfg& cfg, uint32_t paso_ms = 100) {
+    AdaptiveTXWSN::Cfg c = cfg;
+    c.pinAdcBateria = -1;
+    _cfg = c;
+    _paso_ms = (paso_ms == 0) ? 1 : paso_ms;
+    _resultado = ReplayResult();
+    _iniciado = false;
+    _ticks = 0;
+    setMillis(0);
+    _nodo = AdaptiveTXWSN(); // begin() no reinicia corte ni voltaje inyectado
+    _nodo.begin(c);
+  }
+
+  /**
+   * @brief Avanza la simulación hasta el instante de la muestra y aplica su voltaje.
+   * @param m Muestra; `t_ms` debe ser no decreciente.
+   * @param enEnvio Callable `void(uint32_t t_ms, const AdaptiveTXWSN&)` invocado en cada envío.
+   */
+  template <class AlEnviar>
+  void feed(const Sample& m, AlEnviar&& enEnvio) {
+    if (!_iniciado) {
+      _t_ms = m.t_ms;
+      setMillis(_t_ms);
+      _nodo.setBatteryVolts(m.volts);
+      _iniciado = true;
+      paso(enEnvio);
+      return;
+    }
+    while ((int32_t)(m.t_ms - (_t_ms + _paso_ms)) >= 0) {
+      _t_ms += _paso_ms;
+      setMillis(_t_ms);
+      paso(enEnvio);
+    }
+    _nodo.setBatteryVolts(m.volts);
+  }
+
+  /**
+   * @brief Deja el nodo en `nivel` antes de la primera muestra, como un nodo
+   * que ya venía funcionando (tras begin() arranca en BATT_HIGH y baja un
+   * nivel por tick()). Los tick() de ajuste ocurren antes de `t_ms`, no
+   * cuentan en las métricas y su envío vence antes de `t_ms`, así que el
+   * primer tick() de feed() envía con el período de `nivel`.
+   * Llamar entre begin() y el primer feed().
+   * @param t_ms Instante de la primera muestra.
+   * @param nivel Nivel en que estaba el nodo.
+   * @param volts Voltaje de la primera muestra.
+   */
+  void settle(uint32_t t_ms, AdaptiveTXWSN::Level nivel, float volts) {
+    const AdaptiveTXWSN::Cfg& c = _cfg;
+    float objetivo;
+    switch (nivel) {
+      case AdaptiveTXWSN::BATT_HIGH: objetivo = c.umbralAlto_V * (1.0f + 2.0f * c.fraccionHisteresis); break;
+      case AdaptiveTXWSN::BATT_MID:  objetivo = 0.5f * (c.umbralMedio_V + c.umbralAlto_V); break;
+      default:                       objetivo = 0.5f * (c.corteVoltaje_V + c.umbralMedio_V * (1.0f - c.fraccionHisteresis)); break;
+    }
+    const uint32_t periodoMax = max(c.periodoAlto_ms, max(c.periodoMedio_ms, c.periodoBajo_ms));
+    uint32_t t = t_ms - periodoMax - 4 * _paso_ms;
+    _nodo.setBatteryVolts(objetivo);
+    for (uint8_t i = 0; i < 3; ++i, t += _paso_ms) { setMillis(t); _nodo.tick(); }
+    _nodo.setBatteryVolts(volts);
+    setMillis(t);
+    _nodo.tick();
+  }
+
+  /** @brief Igual que feed() pero sin observador de envíos. */
+  void feed(const Sample& m) { feed(m, [](uint32_t, const AdaptiveTXWSN&) {}); }
+
+  /** @brief Métricas acumuladas hasta el último tick(). */
+  const ReplayResult& result() const { return _resultado; }
+
+  /** @brief Acceso al nodo simulado (para inspeccionar su estado). */
+  const AdaptiveTXWSN& node() const { return _nodo; }
+
+  /** @brief Instante del último tick() simulado. */
+  uint32_t now() const { return _t_ms; }
+
+private:
+  AdaptiveTXWSN      _nodo     = AdaptiveTXWSN();
+  AdaptiveTXWSN::Cfg _cfg;
+  ReplayResult       _resultado;
+  uint32_t           _paso_ms  = 100;
+  uint32_t           _t_ms     = 0;
+  uint32_t           _ticks    = 0;
+  bool               _iniciado = false;
+
+  template <class AlEnviar>
+  void paso(AlEnviar& enEnvio) {
+    const AdaptiveTXWSN::Level nivelAntes = _nodo.level();
+    const bool corteAntes = _nodo.isCutoff();
+    const bool envia = _nodo.tick();
+
+    // El estado que dejó el tick() anterior se mantuvo durante todo el paso
+    if (_ticks++ > 0) {
+      if (corteAntes) _resultado.msEnCorte += _paso_ms;
+      else            _resultado.msPorNivel[nivelAntes] += _paso_ms;
+      _resultado.duracion_ms += _paso_ms;
+    }
+
+    if (_nodo.level() != nivelAntes) _resultado.cambiosNivel++;
+    if (_nodo.isCutoff() && !corteAntes) _resultado.entradasCorte++;
+    if (envia) {
+      if (_resultado.envios > 0) {
+        uint32_t silencio = _t_ms - _resultado.ultimoEnvio_ms;
+        if (silencio > _resultado.silencioMaximo_ms) _resultado.silencioMaximo_ms = silencio;
+      }
+      _resultado.envios++;
+      _resultado.ultimoEnvio_ms = _t_ms;
+      enEnvio(_t_ms, _nodo);
+    }
+  }
+};
+
+} // namespace sim
+} // namespace atx
@@ -0,0 +1,209 @@
+/**
+ * @file Scenarios.h
+ * @brief Conjunto fijo y versionado de escenarios de descarga para comparar
+ * configuraciones y cambios de la librería siempre contra lo mismo.
+ *
+ * Cada escenario es una celda (curva de voltaje en circuito abierto según el
+ * estado de carga, capacidad) más los efectos del sitio: ruido del ADC,
+ * caída por resistencia interna al transmitir, noches frías, cosecha solar y
+ * un apagón. La carga se descuenta con EnergyLedger según lo que el nodo
+ * hace de verdad (reposo, muestras y envíos), así que la vida depende de la
+ * configuración evaluada. Todo es determinista (semilla por escenario).
+ * Un escenario grabado (`grabado`) toma el voltaje de una traza medida; su
+ * carga se contabiliza pero no modifica el voltaje.
+ *
+ * Cambiar un escenario, agregar uno o cambiar las columnas de la tabla obliga
+ * a subir SCENARIO_SUITE_VERSION: las tablas sólo se comparan entre sí con la
+ * misma versión.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <EnergyLedger.h>
+#include "BatteryModels.h"
+#include "SkipAhead.h"
+
+#include <cmath>
+#include <random>
+
+namespace atx {
+namespace sim {
+
+/// Versión del conjunto de escenarios (columna `version` de la tabla).
+/// 2: columna `aoi_medio_s` antes de `vida_dias`.
+static const uint16_t SCENARIO_SUITE_VERSION = 2;
+
+/**
+ * @struct Scenario
+ * @brief Celda y sitio de un escenario. Los efectos en cero no se aplican.
+ */
+struct Scenario {
+  const char*     nombre;
+  const OcvCurve* curva;
+  const PiecewiseVoltage* grabado = nullptr; ///< Traza medida: reemplaza curva y efectos.
+  float    capacidad_mAh   = 500.0f;
+  uint32_t dias            = 180;      ///< Horizonte.
+  uint32_t semilla         = 1;
+  float    ruido_V         = 0.0f;     ///< Desvío del ruido del ADC en cada lectura.
+  float    caidaTx_V       = 0.0f;     ///< Caída (I_tx · R interna) en la lectura que sigue a un envío.
+  float    frio_V          = 0.0f;     ///< Caída máxima a la madrugada por temperatura (senoidal diaria).
+  float    solar_mA        = 0.0f;     ///< Corriente de carga al mediodía (media onda de 6 a 18 h).
+  float    apagonCaida_V   = 0.0f;     ///< Caída durante el apagón (carga externa o fuente que se cae).
+  float    apagonDia       = 0.0f;     ///< Inicio del apagón (días).
+  uint32_t apagonMin       = 0;        ///< Duración del apagón (min).
+  bool     umbralesPropios = false;    ///< La química exige sus umbrales (ver abajo).
+  float    alto_V          = 0.0f;     ///< Si `umbralesPropios`: reemplaza umbralAlto_V.
+  float    medio_V         = 0.0f;     ///< Si `umbralesPropios`: reemplaza umbralMedio_V.
+  float    corte_V         = 0.0f;     ///< Si `umbralesPropios`: reemplaza corteVoltaje_V.
+};
+
+/**
+ * @brief Escenarios de la versión SCENARIO_SUITE_VERSION, en el orden de la tabla.
+ * @param n Salida: cantidad de escenarios.
+ */
+inline const Scenario* scenarioSuite(size_t& n) {
+  static Scenario s[8];
+  static bool listo = false;
+  if (!listo) {
+    s[0].nombre = "lineal";      s[0].curva = &CURVA_LINEAL;  s[0].semilla = 1;
+    s[1].nombre = "lipo";        s[1].curva = &CURVA_LIPO;    s[1].semilla = 2;
+    // Umbrales sobre la meseta: con los de LiPo la celda estaría siempre en corte
+    s[2].nombre = "lifepo4";     s[2].curva = &CURVA_LIFEPO4; s[2].semilla = 3;
+    s[2].umbralesPropios = true; s[2].alto_V = 3.30f; s[2].medio_V = 3.22f; s[2].corte_V = 3.00f;
+    s[3].nombre = "ruido_adc";   s[3].curva = &CURVA_LIPO;    s[3].semilla = 4; s[3].ruido_V = 0.015f;
+    s[4].nombre = "caida_tx";    s[4].curva = &CURVA_LIPO;    s[4].semilla = 5; s[4].caidaTx_V = 0.075f;
+    s[5].nombre = "noche_fria";  s[5].curva = &CURVA_LIPO;    s[5].semilla = 6; s[5].frio_V = 0.12f;
+    s[6].nombre = "solar";       s[6].curva = &CURVA_LIPO;    s[6].semilla = 7; s[6].capacidad_mAh = 300.0f;
+    s[6].solar_mA = 1.2f;
+    s[7].nombre = "apagon";      s[7].curva = &CURVA_LIPO;    s[7].semilla = 8; s[7].apagonCaida_V = 0.70f;
+    s[7].apagonDia = 10.0f;      s[7].apagonMin = 45;
+    listo = true;
+  }
+  n = sizeof(s) / sizeof(s[0]);
+  return s;
+}
+
+/**
+ * @struct ScenarioResult
+ * @brief Métricas de un escenario (una fila de la tabla).
+ */
+struct ScenarioResult {
+  uint32_t envios            = 0;
+  uint64_t carga_uC          = 0;     ///< Carga consumida según EnergyLedger (hasta la muerte, si murió).
+  uint64_t msPorNivel[3]     = {};    ///< Tiempo en cada Level fuera de corte.
+  uint64_t msEnCorte         = 0;
+  uint32_t cambiosNivel      = 0;
+  uint32_t rebotes           = 0;     ///< Cambios de nivel revertidos en menos de 10 min.
+  uint32_t entradasCorte     = 0;
+  uint64_t silencioMaximo_ms = 0;     ///< Mayor intervalo entre envíos consecutivos.
+  double   aoiMedio_s        = 0;     ///< Edad media del último dato en el gateway mientras el nodo vive.
+  uint64_t vida_ms           = 0;     ///< Última entrada en corte, si el nodo terminó en corte.
+  bool     murio             = false; ///< false: la vida supera el horizonte.
+  uint64_t duracion_ms       = 0;
+};
+
+/**
+ * @brief Corre un escenario con la configuración dada, llamando a tick() cada `paso_ms`.
+ * @param e Escenario.
+ * @param cfg Configuración evaluada (umbrales reemplazados si el escenario los fija).
+ * @param paso_ms Período del loop() simulado.
+ * @param costos Costos de energía del nodo.
+ */
+inline ScenarioResult runScenario(const Scenario& e, const AdaptiveTXWSN::Cfg& cfg, uint32_t paso_ms = 1000,
+                                  const EnergyLedger::Cfg& costos = EnergyLedger::Cfg()) {
+  static const uint64_t VENTANA_REBOTE_ms = 600000ULL;
+  AdaptiveTXWSN::Cfg c = cfg;
+  c.pinAdcBateria = -1;
+  if (e.umbralesPropios) {
+    c.umbralAlto_V   = e.alto_V;
+    c.umbralMedio_V  = e.medio_V;
+    c.corteVoltaje_V = e.corte_V;
+  }
+
+  std::mt19937 rng(e.semilla);
+  std::normal_distribution<float> ruido(0.0f, 1.0f);
+
+  setMillis(0);
+  AdaptiveTXWSN nodo;
+  nodo.begin(c);
+  EnergyLedger libro;
+  libro.begin(costos, 0);
+
+  ScenarioResult r;
+  const double capacidad_uC = e.capacidad_mAh * 3.6e6;
+  const uint64_t fin_ms = (uint64_t)e.dias * 86400000ULL;
+  const uint64_t apagonIni_ms = (uint64_t)(e.apagonDia * 86400000.0);
+  const uint64_t apagonFin_ms = apagonIni_ms + (uint64_t)e.apagonMin * 60000ULL;
+  double carga_uC = capacidad_uC;
+  uint64_t consumidoPrevio_uC = 0, consumidoAlCorte_uC = 0;
+  bool envioPrevio = false;
+  bool hayEnvio = false;
+  uint64_t ultimoEnvio_ms = 0, ultimoCambio_ms = 0;
+  int8_t nivelPrevioAlCambio = -1;
+  double areaEdad = 0.0; // integral de la edad (ms²)
+
+  for (uint64_t t = 0; t <= fin_ms; t += paso_ms) {
+    if (t > 0) {
+      if (nodo.isCutoff()) r.msEnCorte += paso_ms;
+      else                 r.msPorNivel[nodo.level()] += paso_ms;
+      r.duracion_ms += paso_ms;
+    }
+    const double dia = t / 86400000.0;
+    const double hora = (dia - std::floor(dia)) * 24.0;
+    if (e.solar_mA > 0.0f && hora > 6.0 && hora < 18.0) {
+      carga_uC += e.solar_mA * 1000.0 * std::sin(M_PI * (hora - 6.0) / 12.0) * (paso_ms / 1000.0);
+      if (carga_uC > capacidad_uC) carga_uC = capacidad_uC;
+    }
+
+    float v = e.grabado ? e.grabado->volts(t) : e.curva->volts(carga_uC / capacidad_uC);
+    if (e.ruido_V > 0.0f)  v += e.ruido_V * ruido(rng);
+    if (envioPrevio)       v -= e.caidaTx_V;
+    if (e.frio_V > 0.0f)   v -= e.frio_V * (float)(0.5 + 0.5 * std::cos(2.0 * M_PI * (hora - 4.0) / 24.0));
+    if (t >= apagonIni_ms && t < apagonFin_ms) v -= e.apagonCaida_V;
+
+    setMillis((uint32_t)t);
+    const AdaptiveTXWSN::Level antes = nodo.level();
+    const bool corteAntes = nodo.isCutoff();
+    nodo.setBatteryVolts(v);
+    const bool envia = nodo.tick();
+    libro.onTick((uint32_t)t, envia);
+    const uint64_t consumido = libro.totalUc();
+    carga_uC -= (double)(consumido - consumidoPrevio_uC);
+    if (carga_uC < 0.0) carga_uC = 0.0;
+    consumidoPrevio_uC = consumido;
+    envioPrevio = envia;
+
+    if (nodo.level() != antes) {
+      r.cambiosNivel++;
+      if (nivelPrevioAlCambio == (int8_t)nodo.level() && t - ultimoCambio_ms < VENTANA_REBOTE_ms) r.rebotes++;
+      nivelPrevioAlCambio = (int8_t)antes;
+      ultimoCambio_ms = t;
+    }
+    if (nodo.isCutoff() && !corteAntes) {
+      r.entradasCorte++;
+      r.vida_ms = t;
+      consumidoAlCorte_uC = consumido;
+    }
+    if (envia) {
+      if (hayEnvio && t - ultimoEnvio_ms > r.silencioMaximo_ms) r.silencioMaximo_ms = t - ultimoEnvio_ms;
+      if (hayEnvio) areaEdad += 0.5 * (double)(t - ultimoEnvio_ms) * (double)(t - ultimoEnvio_ms);
+      hayEnvio = true;
+      ultimoEnvio_ms = t;
+      r.envios++;
+    }
+  }
+  r.murio = nodo.isCutoff();
+  r.carga_uC = r.murio ? consumidoAlCorte_uC : libro.totalUc();
+  if (!r.murio) r.vida_ms = r.duracion_ms;
+  if (hayEnvio && r.vida_ms > ultimoEnvio_ms) {
+    areaEdad += 0.5 * (double)(r.vida_ms - ultimoEnvio_ms) * (double)(r.vida_ms - ultimoEnvio_ms);
+  }
+  if (r.vida_ms > 0) r.aoiMedio_s = areaEdad / (double)r.vida_ms / 1000.0;
+  return r;
+}
+
+} // namespace sim
+} // namespace atx
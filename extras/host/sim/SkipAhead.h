@@ -0,0 +1,335 @@
+/**
+ * @file SkipAhead.h
+ * @brief Simulación por eventos de AdaptiveTXWSN: en lugar de llamar a tick()
+ * en cada paso del loop(), calcula el próximo instante en que algo cambia
+ * (vence el envío, el voltaje cruza un umbral de histéresis o el de corte) y
+ * lleva el reloj virtual directo ahí. El costo pasa a ser O(envíos + cambios
+ * de estado) en lugar de O(tiempo simulado / paso).
+ *
+ * El resultado es el mismo que llamar a tick() cada `paso_ms` con el voltaje
+ * del modelo en ese instante: los eventos se redondean a la grilla del loop()
+ * y cada cruce se confirma evaluando el modelo en la grilla. Requiere las
+ * políticas por defecto de AdaptiveTXWSN (el filtro no debe tener estado y la
+ * clasificación es la de HysteresisClassifier).
+ *
+ * Un modelo de voltaje cumple el concepto:
+ *  - `float volts(uint64_t t_ms)`: voltaje en `t_ms`;
+ *  - `uint64_t crossing(uint64_t desde_ms, uint64_t hasta_ms, float umbral_V, bool bajando)`:
+ *    primer instante en [desde_ms, hasta_ms] en que el voltaje queda por
+ *    debajo de `umbral_V` (`bajando`) o en o por encima (`!bajando`),
+ *    `desde_ms` si ya lo está, o `SIN_CRUCE` si no ocurre antes de `hasta_ms`
+ *    (el simulador nunca busca más allá del próximo envío). Puede adelantarse
+ *    o atrasarse unos ms por redondeo.
+ * El modelo puede cambiar en el observador de envíos (p. ej. descontar la
+ * carga del envío): el próximo cruce se recalcula después de cada evento.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace atx {
+namespace sim {
+
+/// Valor de `crossing()` cuando el voltaje no vuelve a cruzar el umbral.
+static const uint64_t SIN_CRUCE = 0xFFFFFFFFFFFFFFFFULL;
+
+/**
+ * @class LinearDischarge
+ * @brief Voltaje que varía a pendiente constante: v(t) = v0 + pendiente · t.
+ */
+class LinearDischarge {
+public:
+  /**
+   * @param v0_V Voltaje en t = 0.
+   * @param pendiente_V_h Pendiente en V/h (negativa al descargar).
+   */
+  LinearDischarge(float v0_V, float pendiente_V_h) : _v0(v0_V), _pendiente(pendiente_V_h / 3.6e6) {}
+
+  float volts(uint64_t t_ms) const { return (float)(_v0 + _pendiente * (double)t_ms); }
+
+  uint64_t crossing(uint64_t desde_ms, uint64_t hasta_ms, float umbral_V, bool bajando) const {
+    const float v = volts(desde_ms);
+    if (bajando ? (v < umbral_V) : (v >= umbral_V)) return desde_ms;
+    if (bajando ? (_pendiente >= 0.0) : (_pendiente <= 0.0)) return SIN_CRUCE;
+    const double t = ((double)umbral_V - _v0) / _pendiente;
+    if (t > (double)hasta_ms) return SIN_CRUCE;
+    return (t <= (double)desde_ms) ? desde_ms : (uint64_t)t;
+  }
+
+private:
+  double _v0;
+  double _pendiente; ///< V/ms.
+};
+
+/**
+ * @class PiecewiseVoltage
+ * @brief Voltaje lineal a tramos entre vértices (t, V) en orden creciente de
+ * tiempo; constante antes del primero y después del último. Sirve para
+ * curvas de descarga tabuladas y para trazas medidas.
+ */
+class PiecewiseVoltage {
+public:
+  /** @brief Agrega un vértice; `t_ms` debe ser mayor que el del anterior. */
+  void add(uint64_t t_ms, float volts) { _vertices.push_back(Vertice{ t_ms, volts }); }
+
+  void clear() { _vertices.clear(); }
+
+  size_t size() const { return _vertices.size(); }
+
+  /** @brief Instante del último vértice (0 si no hay). */
+  uint64_t lastMs() const { return _vertices.empty() ? 0 : _vertices.back().t_ms; }
+
+  float volts(uint64_t t_ms) const {
+    if (_vertices.empty()) return 0.0f;
+    const size_t i = tramo(t_ms);
+    if (i + 1 >= _vertices.size() || t_ms <= _vertices[i].t_ms) return _vertices[i].v;
+    const Vertice& a = _vertices[i];
+    const Vertice& b = _vertices[i + 1];
+    return (float)(a.v + (double)(b.v - a.v) * (double)(t_ms - a.t_ms) / (double)(b.t_ms - a.t_ms));
+  }
+
+  uint64_t crossing(uint64_t desde_ms, uint64_t hasta_ms, float umbral_V, bool bajando) const {
+    if (_vertices.empty()) return SIN_CRUCE;
+    if (cumple(volts(desde_ms), umbral_V, bajando)) return desde_ms;
+    for (size_t i = tramo(desde_ms); i + 1 < _vertices.size() && _vertices[i].t_ms <= hasta_ms; ++i) {
+      const Vertice& a = _vertices[i];
+      const Vertice& b = _vertices[i + 1];
+      if (!cumple(b.v, umbral_V, bajando)) continue;
+      // a no cumple (o es anterior a desde_ms, que no cumple): cruce dentro del tramo
+      const double t = (double)a.t_ms + ((double)umbral_V - a.v) / ((double)b.v - a.v) * (double)(b.t_ms - a.t_ms);
+      return (t <= (double)desde_ms) ? desde_ms : (uint64_t)t;
+    }
+    return SIN_CRUCE;
+  }
+
+private:
+  struct Vertice {
+    uint64_t t_ms;
+    float    v;
+  };
+  std::vector<Vertice> _vertices;
+
+  static bool cumple(float v, float umbral_V, bool bajando) { return bajando ? (v < umbral_V) : (v >= umbral_V); }
+
+  /** Índice del último vértice con t <= t_ms (0 si t_ms es anterior al primero). */
+  size_t tramo(uint64_t t_ms) const {
+    size_t lo = 0, hi = _vertices.size();
+    while (hi - lo > 1) {
+      const size_t m = (lo + hi) / 2;
+      if (_vertices[m].t_ms <= t_ms) lo = m; else hi = m;
+    }
+    return lo;
+  }
+};
+
+/**
+ * @struct SkipResult
+ * @brief Métricas de SkipAhead (mismas definiciones que ReplayResult, en 64
+ * bits para simular años).
+ */
+struct SkipResult {
+  uint32_t envios             = 0;  ///< Veces que tick() devolvió true.
+  uint64_t msPorNivel[3]      = {}; ///< Tiempo (ms) en cada Level fuera de corte.
+  uint64_t msEnCorte          = 0;  ///< Tiempo (ms) con isCutoff() = true.
+  uint32_t cambiosNivel       = 0;  ///< Transiciones de Level.
+  uint32_t entradasCorte      = 0;  ///< Veces que se entró en corte.
+  uint64_t primerCorte_ms     = 0;  ///< Instante de la primera entrada en corte (0 si no hubo).
+  uint64_t silencioMaximo_ms  = 0;  ///< Mayor intervalo entre envíos consecutivos.
+  uint64_t ultimoEnvio_ms     = 0;  ///< Instante del último envío.
+  uint64_t duracion_ms        = 0;  ///< Tiempo simulado total.
+  uint64_t ticks              = 0;  ///< tick() ejecutados (uno por evento).
+};
+
+/**
+ * @class SkipAhead
+ * @brief Avanza AdaptiveTXWSN de evento en evento sobre un modelo de voltaje.
+ *
+ * Uso: begin(), luego run() con el modelo y el horizonte (puede llamarse
+ * varias veces con horizontes crecientes) y result(). nextEventMs() dice
+ * cuándo será el próximo tick() que cambie algo, sin avanzar.
+ */
+class SkipAhead {
+public:
+  /**
+   * @brief Reinicia el reloj virtual y el nodo; el primer tick() ocurre en `t0_ms`.
+   * @param cfg Configuración del nodo (se fuerza `pinAdcBateria = -1`).
+   * @param paso_ms Período del loop(): los tick() caen en t0 + k·paso.
+   * @param t0_ms Instante inicial.
+   */
+  void begin(const AdaptiveTXWSN::Cfg& cfg, uint32_t paso_ms = 100, uint64_t t0_ms = 0) {
+    AdaptiveTXWSN::Cfg c = cfg;
+    c.pinAdcBateria = -1;
+    _paso_ms = (paso_ms == 0) ? 1 : paso_ms;
+    _resultado = SkipResult();
+    _iniciado = false;
+    _t_ms = t0_ms;
+    setMillis((uint32_t)t0_ms);
+    _nodo = AdaptiveTXWSN(); // begin() no reinicia corte ni voltaje inyectado
+    _nodo.begin(c);
+
+    // Mismos umbrales y misma aritmética en float que HysteresisClassifier
+    const float diferencialAlto_V  = c.umbralAlto_V  * c.fraccionHisteresis;
+    const float diferencialMedio_V = c.umbralMedio_V * c.fraccionHisteresis;
+    _altoBaja_V  = c.umbralAlto_V  - diferencialAlto_V;
+    _altoSube_V  = c.umbralAlto_V  + diferencialAlto_V;
+    _medioBaja_V = c.umbralMedio_V - diferencialMedio_V;
+    _medioSube_V = c.umbralMedio_V + diferencialMedio_V;
+    _corte_V     = c.corteVoltaje_V;
+  }
+
+  /**
+   * @brief Simula hasta `hasta_ms` (inclusive) saltando entre eventos.
+   * @param modelo Modelo de voltaje (ver el concepto arriba).
+   * @param hasta_ms Horizonte.
+   * @param enEnvio Callable `void(uint64_t t_ms, AdaptiveTXWSN&)` en cada envío;
+   * puede cambiar el período del nodo (períodos, multiplicador, relevo,
+   * deriva) o el modelo, pero no los umbrales.
+   */
+  template <class Modelo, class AlEnviar>
+  void run(Modelo& modelo, uint64_t hasta_ms, AlEnviar&& enEnvio) {
+    if (!_iniciado) {
+      _iniciado = true;
+      paso(modelo, enEnvio);
+    }
+    for (;;) {
+      const uint64_t t = nextEventMs(modelo);
+      if (t > hasta_ms) {
+        if (hasta_ms > _contado_ms) contar(hasta_ms - _contado_ms);
+        return;
+      }
+      contar(t - _contado_ms);
+      _t_ms = t;
+      setMillis((uint32_t)t);
+      paso(modelo, enEnvio);
+    }
+  }
+
+  /** @brief Igual que run() pero sin observador de envíos. */
+  template <class Modelo>
+  void run(Modelo& modelo, uint64_t hasta_ms) { run(modelo, hasta_ms, [](uint64_t, AdaptiveTXWSN&) {}); }
+
+  /**
+   * @brief Próximo instante de la grilla del loop() en que tick() cambia algo
+   * (vence el envío, se cruza un umbral de nivel o el de corte) con el modelo
+   * dado; SIN_CRUCE si en corte el voltaje no vuelve a subir. Antes del primer
+   * run() es `t0_ms`. run() avanza de uno de estos instantes al siguiente.
+   */
+  template <class Modelo>
+  uint64_t nextEventMs(Modelo& modelo) {
+    if (!_iniciado) return _t_ms;
+    if (_nodo.isCutoff()) return cruce(modelo, _corte_V, false, SIN_CRUCE);
+
+    // Vencimiento del envío (millis() de 32 bits: diferencia con signo)
+    const int32_t falta = (int32_t)(_nodo.scheduler().nextMs() - (uint32_t)_t_ms);
+    uint64_t t = enGrilla((falta <= 0) ? _t_ms : _t_ms + (uint64_t)falta);
+
+    t = cruce(modelo, _corte_V, true, t);
+    switch (_nodo.level()) {
+      case AdaptiveTXWSN::BATT_HIGH:
+        t = cruce(modelo, _altoBaja_V, true, t);
+        break;
+      case AdaptiveTXWSN::BATT_MID:
+        t = cruce(modelo, _altoSube_V, false, t);
+        t = cruce(modelo, _medioBaja_V, true, t);
+        break;
+      default:
+        t = cruce(modelo, _medioSube_V, false, t);
+        break;
+    }
+    return t;
+  }
+
+  /** @brief Métricas acumuladas hasta el horizonte del último run(). */
+  const SkipResult& result() const { return _resultado; }
+
+  /** @brief Acceso al nodo simulado. */
+  AdaptiveTXWSN& node() { return _nodo; }
+
+  /** @brief Instante del último tick() simulado. */
+  uint64_t now() const { return _t_ms; }
+
+private:
+  AdaptiveTXWSN _nodo        = AdaptiveTXWSN();
+  SkipResult    _resultado;
+  uint32_t      _paso_ms     = 100;
+  uint64_t      _t_ms        = 0; ///< Último tick().
+  uint64_t      _contado_ms  = 0; ///< Tiempo ya repartido entre los estados.
+  bool          _iniciado    = false;
+  float         _altoBaja_V  = 0.0f;
+  float         _altoSube_V  = 0.0f;
+  float         _medioBaja_V = 0.0f;
+  float         _medioSube_V = 0.0f;
+  float         _corte_V     = 0.0f;
+
+  /** Reparte `d` ms al estado que dejó el último tick(). */
+  void contar(uint64_t d) {
+    if (_nodo.isCutoff()) _resultado.msEnCorte += d;
+    else                  _resultado.msPorNivel[_nodo.level()] += d;
+    _resultado.duracion_ms += d;
+    _contado_ms += d;
+  }
+
+  template <class Modelo, class AlEnviar>
+  void paso(Modelo& modelo, AlEnviar& enEnvio) {
+    if (_resultado.ticks == 0) _contado_ms = _t_ms;
+    const AdaptiveTXWSN::Level nivelAntes = _nodo.level();
+    const bool corteAntes = _nodo.isCutoff();
+    _nodo.setBatteryVolts(modelo.volts(_t_ms));
+    const bool envia = _nodo.tick();
+    _resultado.ticks++;
+
+    if (_nodo.level() != nivelAntes) _resultado.cambiosNivel++;
+    if (_nodo.isCutoff() && !corteAntes) {
+      if (_resultado.entradasCorte++ == 0) _resultado.primerCorte_ms = _t_ms;
+    }
+    if (envia) {
+      if (_resultado.envios > 0) {
+        const uint64_t silencio = _t_ms - _resultado.ultimoEnvio_ms;
+        if (silencio > _resultado.silencioMaximo_ms) _resultado.silencioMaximo_ms = silencio;
+      }
+      _resultado.envios++;
+      _resultado.ultimoEnvio_ms = _t_ms;
+      enEnvio(_t_ms, _nodo);
+    }
+  }
+
+  /** Primer instante de la grilla del loop() posterior al último tick() y >= t. */
+  uint64_t enGrilla(uint64_t t) const {
+    if (t <= _t_ms) return _t_ms + _paso_ms;
+    return _t_ms + (t - _t_ms + _paso_ms - 1) / _paso_ms * _paso_ms;
+  }
+
+  /**
+   * Primer instante de la grilla hasta `limite` en que el voltaje del modelo
+   * cumple el cruce, evaluado igual que lo haría tick(); si no hay, `limite`.
+   */
+  template <class Modelo>
+  uint64_t cruce(Modelo& modelo, float umbral_V, bool bajando, uint64_t limite) const {
+    uint64_t desde = _t_ms + 1;
+    for (;;) {
+      if (desde >= limite) return limite;
+      const uint64_t t = modelo.crossing(desde, limite, umbral_V, bajando);
+      if (t == SIN_CRUCE || t >= limite) return limite;
+      uint64_t g = enGrilla(t);
+      // El modelo pudo atrasarse por redondeo: retroceder mientras ya cumplía
+      while (g - _paso_ms > _t_ms && cumple(modelo.volts(g - _paso_ms), umbral_V, bajando)) g -= _paso_ms;
+      // O adelantarse (o tocar el umbral entre dos puntos de la grilla): buscar de nuevo
+      for (uint8_t k = 0; k < 4; ++k, g += _paso_ms) {
+        if (g >= limite) return limite;
+        if (cumple(modelo.volts(g), umbral_V, bajando)) return g;
+      }
+      desde = g;
+    }
+  }
+
+  static bool cumple(float v, float umbral_V, bool bajando) { return bajando ? (v < umbral_V) : (v >= umbral_V); }
+};
+
+} // namespace sim
+} // namespace atx
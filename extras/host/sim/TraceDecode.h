@@ -0,0 +1,134 @@
+/**
+ * @file TraceDecode.h
+ * @brief Decodifica volcados de BinaryTrace y los convierte en entrada del
+ * motor Replay para reproducir en el host lo que hizo un nodo en el campo.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <BinaryTrace.h>
+#include <sim/Replay.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace atx {
+namespace sim {
+
+/**
+ * @struct TraceRecord
+ * @brief Un evento decodificado con su instante reconstruido.
+ *
+ * Tras un registro REINICIO el tiempo sigue desde el último instante anterior
+ * (la duración del apagado no queda registrada).
+ */
+struct TraceRecord {
+  uint32_t t_ms;   ///< Instante reconstruido (millis() del nodo, sin apagados).
+  uint8_t  evento; ///< TraceEvent o BinaryTraceFormat::REINICIO.
+  uint16_t dato;   ///< Ver TraceEvent.
+};
+
+/**
+ * @brief Busca el primer volcado válido en `buf` (puede venir mezclado con
+ * texto del puerto serie) y lo decodifica.
+ * @param buf Bytes capturados.
+ * @param len Cantidad de bytes.
+ * @param salida Registros del más viejo al más nuevo.
+ * @return true Si se encontró un volcado con suma de control correcta.
+ */
+inline bool decodeTrace(const uint8_t* buf, size_t len, std::vector<TraceRecord>& salida) {
+  for (size_t i = 0; i + 13 <= len; ++i) {
+    if (buf[i] != 'A' || buf[i + 1] != 'T' || buf[i + 2] != 'X' || buf[i + 3] != 'B') continue;
+    const uint8_t* p = buf + i + 4;
+    if (p[0] != BinaryTraceFormat::VERSION) continue;
+    const uint16_t n = (uint16_t)(p[1] | (p[2] << 8));
+    const size_t cuerpo = 7 + (size_t)n * BinaryTraceFormat::REGISTRO;
+    if (i + 4 + cuerpo + 2 > len) continue;
+
+    uint8_t s1 = 0, s2 = 0;
+    for (size_t k = 0; k < cuerpo; ++k) {
+      s1 = (uint8_t)((s1 + p[k]) % 255);
+      s2 = (uint8_t)((s2 + s1) % 255);
+    }
+    if (p[cuerpo] != s1 || p[cuerpo + 1] != s2) continue;
+
+    uint32_t t = (uint32_t)p[3] | ((uint32_t)p[4] << 8) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 24);
+    salida.clear();
+    salida.reserve(n);
+    const uint8_t* r = p + 7;
+    for (uint16_t k = 0; k < n; ++k, r += BinaryTraceFormat::REGISTRO) {
+      const uint32_t unidades = (uint32_t)r[1] | ((uint32_t)r[2] << 8);
+      t += unidades << (r[0] >> 4);
+      salida.push_back(TraceRecord{ t, (uint8_t)(r[0] & 0x0F), (uint16_t)(r[3] | (r[4] << 8)) });
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Muestras de voltaje (retención de orden cero) para Replay.
+ *
+ * Las mediciones y los eventos de corte aportan voltaje. Si hay envíos, la
+ * serie arranca en el primer envío con el último voltaje conocido, así el
+ * primer tick() de Replay (que siempre envía) cae donde cayó el del nodo.
+ * Los tiempos quedan relativos a ese inicio.
+ * @param registros Salida de decodeTrace().
+ * @param inicio_ms Instante (de los registros) que corresponde a t = 0.
+ */
+inline std::vector<Sample> traceSamples(const std::vector<TraceRecord>& registros, uint32_t& inicio_ms) {
+  std::vector<Sample> muestras;
+  bool hayEnvio = false;
+  for (const TraceRecord& r : registros) {
+    if (r.evento == TRAZA_ENVIO_DEBIDO) { inicio_ms = r.t_ms; hayEnvio = true; break; }
+  }
+  float voltios = -1.0f;
+  bool primero = true;
+  for (const TraceRecord& r : registros) {
+    const bool conVoltaje = r.evento == TRAZA_MUESTRA_FIN || r.evento == TRAZA_CORTE_ENTRADA
+                         || r.evento == TRAZA_CORTE_SALIDA;
+    if (!hayEnvio && primero && conVoltaje) { inicio_ms = r.t_ms; }
+    if ((int32_t)(r.t_ms - inicio_ms) < 0) {
+      if (conVoltaje) voltios = r.dato / 1000.0f;
+      continue;
+    }
+    if (primero) {
+      if (voltios < 0 && !conVoltaje) continue; // todavía no hay voltaje
+      muestras.push_back(Sample{ 0, conVoltaje ? r.dato / 1000.0f : voltios });
+      primero = false;
+      if (conVoltaje) continue;
+    }
+    if (conVoltaje) muestras.push_back(Sample{ r.t_ms - inicio_ms, r.dato / 1000.0f });
+  }
+  return muestras;
+}
+
+/**
+ * @brief Nivel en que estaba el nodo en `inicio_ms`, para Replay::settle().
+ * Se toma del último cambio de nivel hasta ese instante, si no del primero
+ * posterior (su nivel anterior) y si no del período del primer envío.
+ * @return int8_t Level, o -1 si la traza no lo permite deducir.
+ */
+inline int8_t traceInitialLevel(const std::vector<TraceRecord>& registros, uint32_t inicio_ms,
+                                const AdaptiveTXWSN::Cfg& cfg) {
+  int8_t nivel = -1;
+  for (const TraceRecord& r : registros) {
+    if (r.evento != TRAZA_CAMBIO_NIVEL) continue;
+    if ((int32_t)(r.t_ms - inicio_ms) <= 0) { nivel = (int8_t)(r.dato & 0xFF); continue; }
+    return (nivel >= 0) ? nivel : (int8_t)(r.dato >> 8);
+  }
+  if (nivel >= 0) return nivel;
+  for (const TraceRecord& r : registros) {
+    if (r.evento != TRAZA_ENVIO_DEBIDO) continue;
+    if (r.dato == cfg.periodoAlto_ms / 1000)  return AdaptiveTXWSN::BATT_HIGH;
+    if (r.dato == cfg.periodoMedio_ms / 1000) return AdaptiveTXWSN::BATT_MID;
+    if (r.dato == cfg.periodoBajo_ms / 1000)  return AdaptiveTXWSN::BATT_LOW;
+    break;
+  }
+  return -1;
+}
+
+} // namespace sim
+} // namespace atx
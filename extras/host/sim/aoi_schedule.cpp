@@ -0,0 +1,186 @@
+/**
+ * @file aoi_schedule.cpp
+ * @brief Compara períodos fijos contra AoIScheduler con el mismo presupuesto
+ * de energía, sobre un canal con ráfagas de pérdidas (Gilbert-Elliott).
+ *
+ * Dos escenarios:
+ *  - presupuesto fijo: período P constante (15 s, 1 min, 5 min) contra el modo
+ *    AoI con presupuesto P, durante `dias`;
+ *  - batería: celda sin cosecha con los niveles del `Cfg`; el modo AoI usa
+ *    currentPeriod() como presupuesto. Corre hasta el corte.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/sim/aoi_schedule.cpp -o aoi_schedule
+ * Uso:
+ *   ./aoi_schedule [dias=7] [semillas=5] [perdidaBuena=0.1] [perdidaMala=0.9]
+ *   ./aoi_schedule check   (promedio de AgeOfInformation a través de la vuelta de millis())
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <AoIScheduler.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+namespace {
+
+/** Canal de dos estados que cambia por segundo; pérdida por intento según el estado. */
+struct Canal {
+  double pBuenoAMalo  = 1.0 / 1200; ///< Ráfagas malas cada ~20 min...
+  double pMaloABueno  = 1.0 / 120;  ///< ...de ~2 min.
+  double perdidaBuena = 0.1;
+  double perdidaMala  = 0.9;
+  bool   malo         = false;
+  std::mt19937 rngEstado, rngPerdida;
+
+  void begin(uint32_t semilla) { rngEstado.seed(semilla); rngPerdida.seed(semilla * 7919u + 1); malo = false; }
+  void segundo() {
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    malo = malo ? (u(rngEstado) >= pMaloABueno) : (u(rngEstado) < pBuenoAMalo);
+  }
+  bool entrega() {
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    return u(rngPerdida) >= (malo ? perdidaMala : perdidaBuena);
+  }
+};
+
+struct Resultado {
+  double aoi_s       = 0;
+  double picoMedio_s = 0;
+  double picoMax_s   = 0;
+  double intentosDia = 0;
+  double vida_d      = 0;
+};
+
+/** Celda lineal entre vacío y lleno, sin cosecha (mismo modelo que rl/NodeEnv.h). */
+struct Celda {
+  double capacidad_uC, carga_uC;
+  explicit Celda(double mAh) : capacidad_uC(mAh * 3.6e6), carga_uC(mAh * 3.6e6) {}
+  float voltaje() const { return 3.30f + 0.85f * (float)(carga_uC / capacidad_uC); }
+};
+
+/**
+ * @param aoi true: AoIScheduler; false: tick() de AdaptiveTXWSN.
+ * @param periodoFijo_ms 0 = niveles del `Cfg` con batería; si no, período constante y batería llena.
+ */
+Resultado simular(bool aoi, uint32_t periodoFijo_ms, uint32_t semilla, uint32_t dias, const Canal& plantilla) {
+  Canal canal = plantilla;
+  canal.begin(semilla);
+  atx::sim::setMillis(0);
+
+  AdaptiveTXWSN nodo;
+  nodo.begin(AdaptiveTXWSN::Cfg());
+  if (periodoFijo_ms) nodo.setPeriods(periodoFijo_ms, periodoFijo_ms, periodoFijo_ms);
+  AoIScheduler sched;
+  sched.begin(AoIScheduler::Cfg(), 0);
+  AgeOfInformation edad;
+  edad.begin(0);
+
+  Celda celda(300.0);
+  uint32_t intentos = 0, s = 0;
+  const uint32_t limite_s = periodoFijo_ms ? dias * 86400UL : 365UL * 86400UL;
+  for (; s < limite_s; ++s) {
+    const uint32_t ahora = millis();
+    nodo.setBatteryVolts(periodoFijo_ms ? 4.0f : celda.voltaje());
+    const bool tickEnvio = nodo.tick();
+    if (nodo.isCutoff()) break;
+    const bool enviar = aoi ? sched.shouldSend(ahora, nodo.currentPeriod()) : tickEnvio;
+    if (enviar) {
+      intentos++;
+      celda.carga_uC -= 2500.0;
+      if (canal.entrega()) {
+        edad.onDelivered(ahora, ahora);
+        sched.onDelivered(ahora, ahora);
+      }
+    }
+    celda.carga_uC -= 15.0;
+    canal.segundo();
+    atx::sim::advanceMillis(1000);
+  }
+  const uint32_t fin = millis();
+  const AgeOfInformation& a = aoi ? sched.aoi() : edad;
+  Resultado r;
+  r.aoi_s       = a.averageAgeMs(fin) / 1000.0;
+  r.picoMedio_s = a.averagePeakAgeMs() / 1000.0;
+  r.picoMax_s   = a.maxPeakAgeMs() / 1000.0;
+  r.vida_d      = s / 86400.0;
+  r.intentosDia = r.vida_d > 0 ? intentos / r.vida_d : 0;
+  return r;
+}
+
+Resultado promedio(bool aoi, uint32_t periodo_ms, uint32_t semillas, uint32_t dias, const Canal& canal) {
+  Resultado m;
+  for (uint32_t k = 1; k <= semillas; ++k) {
+    Resultado r = simular(aoi, periodo_ms, k, dias, canal);
+    m.aoi_s += r.aoi_s / semillas;
+    m.picoMedio_s += r.picoMedio_s / semillas;
+    m.picoMax_s += r.picoMax_s / semillas;
+    m.intentosDia += r.intentosDia / semillas;
+    m.vida_d += r.vida_d / semillas;
+  }
+  return m;
+}
+
+void imprimir(const char* escenario, const char* politica, const Resultado& r) {
+  printf("%-12s %-8s %9.1f %10.1f %10.1f %11.0f %8.1f\n", escenario, politica,
+         r.aoi_s, r.picoMedio_s, r.picoMax_s, r.intentosDia, r.vida_d);
+}
+
+/**
+ * Entrega cada 60 s con 1 s de retardo de generación durante 60 días: la
+ * edad va de 1 s a 61 s, así que el promedio debe quedar en 31 s en cada
+ * consulta diaria, también después de que millis() da la vuelta. Se arranca
+ * en 0 (vuelta el día 49.7) y a 10 días del final del rango (vuelta el día 10).
+ */
+int verificar() {
+  const uint32_t inicios[] = { 0, 0xFFFFFFFFu - 10UL * 86400000UL };
+  uint32_t fallas = 0;
+  for (uint32_t inicio : inicios) {
+    AgeOfInformation edad;
+    edad.begin(inicio);
+    uint32_t peor_ms = 0, diaPeor = 0;
+    for (uint32_t k = 1; k <= 60UL * 1440; ++k) {
+      const uint32_t ahora = inicio + k * 60000UL;
+      edad.onDelivered(ahora, ahora - 1000);
+      if (k % 1440 == 0) {
+        const uint32_t prom = edad.averageAgeMs(ahora);
+        const uint32_t error = (prom > 31000) ? prom - 31000 : 31000 - prom;
+        if (error > peor_ms) { peor_ms = error; diaPeor = k / 1440; }
+      }
+    }
+    const bool ok = peor_ms <= 500;
+    if (!ok) fallas++;
+    printf("inicio=%lu promedio=%lu ms (esperado 31000) peor_error=%lu ms dia=%lu %s\n", (unsigned long)inicio,
+           (unsigned long)edad.averageAgeMs(inicio + 60UL * 86400000UL), (unsigned long)peor_ms,
+           (unsigned long)diaPeor, ok ? "ok" : "FALLA");
+  }
+  return fallas ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc > 1 && strcmp(argv[1], "check") == 0) return verificar();
+  const uint32_t dias     = (argc > 1) ? (uint32_t)atoi(argv[1]) : 7;
+  const uint32_t semillas = (argc > 2) ? (uint32_t)atoi(argv[2]) : 5;
+  Canal canal;
+  if (argc > 3) canal.perdidaBuena = atof(argv[3]);
+  if (argc > 4) canal.perdidaMala  = atof(argv[4]);
+
+  printf("%-12s %-8s %9s %10s %10s %11s %8s\n", "escenario", "politica", "AoI_s", "pico_s", "picoMax_s", "intentos/d", "vida_d");
+  const uint32_t periodos[] = { 15000, 60000, 300000 };
+  for (uint32_t p : periodos) {
+    char nombre[24];
+    snprintf(nombre, sizeof(nombre), "P=%lus", (unsigned long)(p / 1000));
+    imprimir(nombre, "fijo", promedio(false, p, semillas, dias, canal));
+    imprimir(nombre, "AoI", promedio(true, p, semillas, dias, canal));
+  }
+  imprimir("bateria", "niveles", promedio(false, 0, semillas, dias, canal));
+  imprimir("bateria", "AoI", promedio(true, 0, semillas, dias, canal));
+  return 0;
+}
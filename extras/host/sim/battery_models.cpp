@@ -0,0 +1,178 @@
+/**
+ * @file battery_models.cpp
+ * @brief Vida del nodo según el modelo de batería (BatteryModels.h), con la
+ * configuración por defecto y distintos `periodoAlto_ms`: rampa lineal de
+ * voltaje en la corriente media, contador de Coulomb sobre la curva LiPo,
+ * Peukert, KiBaM y KiBaM en un sitio frío. Todo por eventos con SkipAhead;
+ * la fila `verificacion` repite KiBaM en frío con tick() en cada paso del
+ * loop() y compara envíos y vida.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/sim/battery_models.cpp -o battery_models
+ * Uso:
+ *   ./battery_models [dias=730] [paso_ms=1000] [verificar=1]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <sim/BatteryModels.h>
+#include <sim/SkipAhead.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+using atx::sim::Battery;
+using atx::sim::CellCfg;
+
+struct Fila {
+  double   vida_dias     = 0; ///< Primera entrada en corte (horizonte si no hubo).
+  uint32_t envios        = 0;
+  double   entregado_mAh = 0; ///< Carga entregada hasta el corte.
+  double   socAlCorte    = 0; ///< Estado de carga del pozo (el disponible, en KiBaM) al corte.
+  float    minimoTx_V    = 0; ///< Menor voltaje en bornes durante un envío.
+  uint64_t ticks         = 0;
+  double   s             = 0;
+};
+
+double segundosDesde(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/** Por eventos: corre hasta el horizonte y se queda con el primer corte. */
+template <class Pozo>
+Fila porEventos(const CellCfg& celda, const AdaptiveTXWSN::Cfg& cfg, uint64_t hasta_ms, uint32_t paso_ms) {
+  auto t0 = std::chrono::steady_clock::now();
+  Battery<Pozo> bat;
+  bat.begin(celda);
+  atx::sim::SkipAhead sim;
+  sim.begin(cfg, paso_ms);
+  Fila f;
+  bool corte = false;
+  // De a un día: al primer corte se mide y se termina (lo que pasa después del corte no cuenta)
+  for (uint64_t t = 86400000ULL; !corte; t += 86400000ULL) {
+    const uint64_t h = std::min(t, hasta_ms);
+    sim.run(bat, h, [&](uint64_t te, AdaptiveTXWSN&) {
+      if (sim.result().entradasCorte > 0) return;
+      bat.onSend(te);
+      f.envios++;
+    });
+    corte = sim.result().entradasCorte > 0;
+    if (h == hasta_ms) break;
+  }
+  const atx::sim::SkipResult& r = sim.result();
+  const uint64_t fin_ms = corte ? r.primerCorte_ms : hasta_ms;
+  bat.advance(fin_ms);
+  f.vida_dias = fin_ms / 86400000.0;
+  f.entregado_mAh = bat.deliveredUc() / 3.6e6;
+  f.socAlCorte = bat.well().soc();
+  f.minimoTx_V = bat.minSendVolts();
+  f.ticks = r.ticks;
+  f.s = segundosDesde(t0);
+  return f;
+}
+
+/** Referencia: tick() en cada paso del loop() hasta el primer corte. */
+template <class Pozo>
+Fila pasoAPaso(const CellCfg& celda, const AdaptiveTXWSN::Cfg& cfg, uint64_t hasta_ms, uint32_t paso_ms) {
+  auto t0 = std::chrono::steady_clock::now();
+  Battery<Pozo> bat;
+  bat.begin(celda);
+  atx::sim::setMillis(0);
+  AdaptiveTXWSN nodo;
+  AdaptiveTXWSN::Cfg c = cfg;
+  c.pinAdcBateria = -1;
+  nodo.begin(c);
+  Fila f;
+  uint64_t t = 0;
+  for (; t <= hasta_ms; t += paso_ms) {
+    atx::sim::setMillis((uint32_t)t);
+    nodo.setBatteryVolts(bat.volts(t));
+    const bool envia = nodo.tick();
+    f.ticks++;
+    if (envia) {
+      bat.onSend(t);
+      f.envios++;
+    }
+    if (nodo.isCutoff()) break;
+  }
+  const uint64_t fin_ms = std::min(t, hasta_ms);
+  bat.advance(fin_ms);
+  f.vida_dias = fin_ms / 86400000.0;
+  f.entregado_mAh = bat.deliveredUc() / 3.6e6;
+  f.socAlCorte = bat.well().soc();
+  f.minimoTx_V = bat.minSendVolts();
+  f.s = segundosDesde(t0);
+  return f;
+}
+
+/** La aproximación habitual: rampa 4.20 → 3.30 V en capacidad / corriente media en nivel alto. */
+Fila rampaLineal(const CellCfg& celda, const AdaptiveTXWSN::Cfg& cfg, uint64_t hasta_ms, uint32_t paso_ms) {
+  auto t0 = std::chrono::steady_clock::now();
+  const double media_uA = celda.corrienteReposo_uA + celda.cargaEnvio_uC * 1000.0 / cfg.periodoAlto_ms;
+  const double horas = celda.capacidad_mAh * 1000.0 / media_uA;
+  atx::sim::LinearDischarge rampa(4.20f, (float)(-0.90 / horas));
+  atx::sim::SkipAhead sim;
+  sim.begin(cfg, paso_ms);
+  sim.run(rampa, hasta_ms);
+  const atx::sim::SkipResult& r = sim.result();
+  Fila f;
+  const uint64_t fin_ms = (r.entradasCorte > 0) ? r.primerCorte_ms : hasta_ms;
+  f.vida_dias = fin_ms / 86400000.0;
+  f.envios = r.envios;
+  f.entregado_mAh = media_uA * fin_ms / 3.6e9;
+  f.socAlCorte = (rampa.volts(fin_ms) - 3.30) / 0.90;
+  f.minimoTx_V = 0.0f;
+  f.ticks = r.ticks;
+  f.s = segundosDesde(t0);
+  return f;
+}
+
+void imprimir(uint32_t periodoAlto_ms, const char* modelo, const Fila& f) {
+  printf("%u,%s,%.2f,%u,%.1f,%.3f,%.3f,%llu,%.3f\n", periodoAlto_ms, modelo, f.vida_dias, f.envios, f.entregado_mAh,
+         f.socAlCorte, f.minimoTx_V, (unsigned long long)f.ticks, f.s);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t dias      = (argc > 1) ? (uint32_t)atoi(argv[1]) : 730;
+  const uint32_t paso_ms   = (argc > 2) ? (uint32_t)atoi(argv[2]) : 1000;
+  const bool     verificar = (argc > 3) ? atoi(argv[3]) != 0 : true;
+  const uint64_t hasta_ms  = (uint64_t)dias * 86400000ULL;
+
+  CellCfg celda;
+  CellCfg frio = celda;
+  frio.temperaturaMedia_C    = 2.0f;
+  frio.temperaturaAmplitud_C = 8.0f;
+
+  printf("# dias=%u paso_ms=%u capacidad_mAh=%.0f reposo_uA=%.0f envio_uC=%u envio_mA=%.0f c=%.3f k_1_h=%.4f peukert=%.2f\n",
+         dias, paso_ms, celda.capacidad_mAh, celda.corrienteReposo_uA, celda.cargaEnvio_uC, celda.corrienteEnvio_mA,
+         celda.fraccionDisponible, celda.difusion_1_h, celda.exponentePeukert);
+  printf("periodo_alto_ms,modelo,vida_dias,envios,entregado_mAh,soc_al_corte,minimo_tx_V,ticks,s\n");
+  const uint32_t PERIODOS[3] = { 5000, 15000, 60000 };
+  for (uint32_t p : PERIODOS) {
+    AdaptiveTXWSN::Cfg cfg;
+    cfg.periodoAlto_ms = p;
+    if (cfg.periodoMedio_ms < p) cfg.periodoMedio_ms = p;
+    imprimir(p, "rampa_lineal", rampaLineal(celda, cfg, hasta_ms, paso_ms));
+    imprimir(p, "coulomb",      porEventos<atx::sim::IdealWell>(celda, cfg, hasta_ms, paso_ms));
+    imprimir(p, "peukert",      porEventos<atx::sim::PeukertWell>(celda, cfg, hasta_ms, paso_ms));
+    imprimir(p, "kibam",        porEventos<atx::sim::KineticWell>(celda, cfg, hasta_ms, paso_ms));
+    imprimir(p, "kibam_frio",   porEventos<atx::sim::KineticWell>(frio, cfg, hasta_ms, paso_ms));
+  }
+  if (verificar) {
+    AdaptiveTXWSN::Cfg cfg;
+    const Fila e = porEventos<atx::sim::KineticWell>(frio, cfg, hasta_ms, paso_ms);
+    const Fila r = pasoAPaso<atx::sim::KineticWell>(frio, cfg, hasta_ms, paso_ms);
+    imprimir(cfg.periodoAlto_ms, "verificacion_paso_a_paso", r);
+    printf("# verificacion kibam_frio: envios %u/%u vida %.4f/%.4f dias (eventos/paso a paso) %.0fx mas rapido\n",
+           e.envios, r.envios, e.vida_dias, r.vida_dias, e.s > 0 ? r.s / e.s : 0.0);
+  }
+  return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file cluster_rotation.cpp
+ * @brief Equidad de la rotación y vida de la red con ClusterHead.
+ * Red de un salto a clústeres con celdas heterogéneas; cada ronda todos los
+ * nodos vivos ejecutan ClusterHead::elect() con su residuo (voltaje lineal
+ * en el estado de carga) y pagan el costo de cabeza o de miembro. Se compara
+ * LEACH clásico con la época ponderada por energía, con y sin el promedio
+ * difundido por el gateway.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/sim/cluster_rotation.cpp -o cluster_rotation
+ * Uso:
+ *   ./cluster_rotation [nodos=1000,10000,100000] [rondasPorEpoca=20]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <ClusterHead.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Modelo de radio de primer orden, en unidades de carga por ronda
+const double COSTO_MIEMBRO   = 1.0;   ///< Envío corto a la cabeza.
+const double COSTO_RX        = 0.5;   ///< Cabeza: recibir a cada miembro.
+const double COSTO_LARGO     = 10.0;  ///< Cabeza: envío agregado al gateway.
+const double COSTO_DIRECTO   = 10.0;  ///< Ronda sin cabezas: cada nodo va directo al gateway.
+const uint16_t CORTE_MV = 3400, LLENO_MV = 4150;
+
+struct Resultado {
+  uint32_t fnd = 0, hnd = 0, lnd = 0;  ///< Rondas hasta la primera, mitad y 90 % de muertes.
+  double   cabezasMedia = 0, cabezasDesv = 0; ///< Cabezas por ronda relativas a vivos / N (ideal 1.0).
+  double   jain = 0;                    ///< Equidad de turnos por unidad de capacidad hasta FND.
+  double   nsPorEleccion = 0;
+};
+
+enum Modo { LEACH = 0, PONDERADO = 1, PONDERADO_PROMEDIO = 2 };
+
+Resultado simular(uint32_t n, uint16_t rondasPorEpoca, Modo modo) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> capacidad(400.0, 1600.0);
+  std::vector<double> cap(n), carga(n);
+  std::vector<uint32_t> turnos(n, 0);
+  std::vector<ClusterHead> ch(n);
+  ClusterHead::Cfg cfg;
+  cfg.rondasPorEpoca  = rondasPorEpoca;
+  cfg.semilla         = 0xC0FFEE;
+  cfg.ponderarEnergia = modo != LEACH;
+  for (uint32_t i = 0; i < n; ++i) {
+    cap[i] = carga[i] = capacidad(rng);
+    ch[i].begin(cfg, i);
+  }
+
+  Resultado r;
+  std::vector<uint8_t> esCabeza(n), residuo(n);
+  double sumaCabezas = 0, sumaCabezas2 = 0, nsTotal = 0;
+  uint64_t elecciones = 0;
+  uint32_t rondas = 0, muertos = 0;
+  for (uint32_t ronda = 0; muertos * 10 < n * 9; ++ronda) {
+    // Residuo que el nodo estima con su voltaje
+    uint32_t vivos = 0, sumaResiduo = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+      if (carga[i] <= 0) { residuo[i] = 0; continue; }
+      uint16_t mV = (uint16_t)(CORTE_MV + (LLENO_MV - CORTE_MV) * (carga[i] / cap[i]));
+      residuo[i] = ClusterHead::residualQ8(mV, CORTE_MV, LLENO_MV);
+      sumaResiduo += residuo[i];
+      vivos++;
+    }
+    uint8_t promedio = vivos ? (uint8_t)std::max<uint32_t>(1, sumaResiduo / vivos) : 1;
+
+    uint32_t cabezas = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < n; ++i) {
+      if (carga[i] <= 0) { esCabeza[i] = 0; continue; }
+      if (modo == PONDERADO_PROMEDIO) ch[i].setNetworkAverageQ8(promedio);
+      esCabeza[i] = ch[i].elect((uint16_t)ronda, residuo[i]);
+      cabezas += esCabeza[i];
+      elecciones++;
+    }
+    nsTotal += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+    const double miembrosPorCabeza = cabezas ? (double)(vivos - cabezas) / cabezas : 0.0;
+    for (uint32_t i = 0; i < n; ++i) {
+      if (carga[i] <= 0) continue;
+      if (cabezas == 0)      carga[i] -= COSTO_DIRECTO;
+      else if (esCabeza[i]) { carga[i] -= COSTO_LARGO + COSTO_RX * miembrosPorCabeza; turnos[i]++; }
+      else                   carga[i] -= COSTO_MIEMBRO;
+      if (carga[i] <= 0) muertos++;
+    }
+    const double relativo = vivos ? cabezas * (double)rondasPorEpoca / vivos : 0.0;
+    sumaCabezas += relativo;
+    sumaCabezas2 += relativo * relativo;
+    rondas++;
+    if (muertos > 0 && r.fnd == 0) {
+      r.fnd = ronda + 1;
+      // Índice de Jain de los turnos por unidad de capacidad, mientras todos viven
+      double s = 0, s2 = 0;
+      for (uint32_t i = 0; i < n; ++i) {
+        double x = turnos[i] / cap[i];
+        s += x;
+        s2 += x * x;
+      }
+      r.jain = (s2 > 0) ? s * s / (n * s2) : 0;
+    }
+    if (muertos * 2 >= n && r.hnd == 0) r.hnd = ronda + 1;
+    if (ronda >= 65535) break;
+  }
+  r.lnd = rondas;
+  r.cabezasMedia = sumaCabezas / rondas;
+  r.cabezasDesv = std::sqrt(std::max(0.0, sumaCabezas2 / rondas - r.cabezasMedia * r.cabezasMedia));
+  r.nsPorEleccion = nsTotal / (double)elecciones;
+  return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::vector<uint32_t> tamanos;
+  if (argc > 1) {
+    for (char* p = argv[1]; *p;) {
+      tamanos.push_back((uint32_t)strtoul(p, &p, 10));
+      if (*p == ',') ++p;
+    }
+  } else {
+    tamanos = { 1000, 10000, 100000 };
+  }
+  const uint16_t epoca = (argc > 2) ? (uint16_t)atoi(argv[2]) : 20;
+  const char* nombres[3] = { "LEACH", "ponderado", "ponderado+prom" };
+
+  printf("%-8s %-15s %7s %7s %7s %10s %8s %8s\n", "nodos", "modo", "FND", "HND", "90%", "cabezas", "jain", "ns/elec");
+  for (uint32_t n : tamanos) {
+    for (int m = 0; m < 3; ++m) {
+      Resultado r = simular(n, epoca, (Modo)m);
+      printf("%-8u %-15s %7u %7u %7u %6.2f±%-4.2f %8.3f %8.1f\n", n, nombres[m], r.fnd, r.hnd, r.lnd,
+             r.cabezasMedia, r.cabezasDesv, r.jain, r.nsPorEleccion);
+    }
+  }
+  return 0;
+}
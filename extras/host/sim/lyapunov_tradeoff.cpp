@@ -0,0 +1,118 @@
+/**
+ * @file lyapunov_tradeoff.cpp
+ * @brief Curva vida-contra-edad de LyapunovScheduler barriendo V, con los
+ * niveles con histéresis de AdaptiveTXWSN como referencia.
+ *
+ * Nodo con celda lineal (mismo modelo que rl/NodeEnv.h) y panel solar con
+ * ciclo diurno y nubosidad diaria, simulado segundo a segundo. Ambas
+ * políticas respetan el corte de AdaptiveTXWSN; el controlador recibe la
+ * cosecha real con setIncomeUa().
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/sim/lyapunov_tradeoff.cpp -o lyapunov_tradeoff
+ * Uso:
+ *   ./lyapunov_tradeoff [dias=180] [capacidad_mAh=300] [cosechaPico_uA]
+ *       Sin cosechaPico_uA corre tres sitios: sin cosecha, 150 µA y 600 µA.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <LyapunovScheduler.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+struct Resultado {
+  double disponible   = 0; ///< Fracción del tiempo fuera de corte.
+  double primerCorte_d = 0; ///< Día del primer corte (o el horizonte).
+  double aoi_s        = 0; ///< Edad media desde el último envío (todo el horizonte).
+  double enviosDia    = 0;
+};
+
+/**
+ * @param v V del controlador; 0 = niveles con histéresis.
+ */
+Resultado simular(uint32_t v, uint32_t dias, double capacidad_mAh, double pico_uA) {
+  const double capacidad_uC = capacidad_mAh * 3.6e6;
+  double carga_uC = capacidad_uC;
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  double factorDia = 1.0;
+
+  atx::sim::setMillis(0);
+  AdaptiveTXWSN nodo;
+  nodo.begin(AdaptiveTXWSN::Cfg());
+  const EnergyLedger::Cfg costos;
+  LyapunovScheduler dpp;
+  LyapunovScheduler::Cfg c;
+  c.pesoEdad = v;
+  dpp.begin(c, costos, 0);
+
+  const uint32_t total_s = dias * 86400UL;
+  uint32_t arriba = 0, envios = 0, ultimoEnvio_s = 0;
+  double areaEdad = 0, primerCorte = -1;
+  for (uint32_t s = 0; s < total_s; ++s) {
+    if (s % 86400 == 0) factorDia = 1.0 - 0.8 * u(rng);
+    const double h = (s % 86400) / 3600.0;
+    const double cosecha_uA = (h < 6.0 || h > 18.0) ? 0.0 : pico_uA * factorDia * std::sin(M_PI * (h - 6.0) / 12.0);
+
+    nodo.setBatteryVolts(3.30f + 0.85f * (float)(carga_uC / capacidad_uC));
+    const bool porNivel = nodo.tick();
+    dpp.setIncomeUa((uint32_t)cosecha_uA);
+    const bool porDpp = dpp.tick(millis()); // corre siempre para integrar la cola
+    if (!nodo.isCutoff()) {
+      arriba++;
+      if (v ? porDpp : porNivel) {
+        envios++;
+        carga_uC -= costos.cargaEnvio_uC;
+        ultimoEnvio_s = s;
+      }
+    } else if (primerCorte < 0) {
+      primerCorte = s / 86400.0;
+    }
+    areaEdad += s - ultimoEnvio_s;
+    carga_uC += cosecha_uA - costos.corrienteReposo_uA;
+    if (carga_uC > capacidad_uC) carga_uC = capacidad_uC;
+    if (carga_uC < 0) carga_uC = 0;
+    atx::sim::advanceMillis(1000);
+  }
+  Resultado r;
+  r.disponible    = (double)arriba / total_s;
+  r.primerCorte_d = (primerCorte < 0) ? dias : primerCorte;
+  r.aoi_s         = areaEdad / total_s;
+  r.enviosDia     = (double)envios / dias;
+  return r;
+}
+
+void imprimir(const char* nombre, const Resultado& r) {
+  printf("%-14s %9.1f%% %12.1f %12.0f %10.0f\n", nombre, 100.0 * r.disponible, r.primerCorte_d, r.aoi_s, r.enviosDia);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t dias    = (argc > 1) ? (uint32_t)atoi(argv[1]) : 180;
+  const double capacidad = (argc > 2) ? atof(argv[2]) : 300.0;
+  const double sitios[]  = { 0.0, 150.0, 600.0 };
+  const int nSitios      = (argc > 3) ? 1 : 3;
+
+  for (int k = 0; k < nSitios; ++k) {
+    const double pico = (argc > 3) ? atof(argv[3]) : sitios[k];
+    printf("\n%.0f mAh, cosecha pico %.0f uA, %u dias\n", capacidad, pico, dias);
+    printf("%-14s %10s %12s %12s %10s\n", "politica", "disponible", "1er_corte_d", "AoI_s", "envios/d");
+    imprimir("niveles", simular(0, dias, capacidad, pico));
+    const uint32_t vs[] = { 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+    for (uint32_t v : vs) {
+      char nombre[24];
+      snprintf(nombre, sizeof(nombre), "V=%lu", (unsigned long)v);
+      imprimir(nombre, simular(v, dias, capacidad, pico));
+    }
+  }
+  return 0;
+}
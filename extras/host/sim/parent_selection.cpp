@@ -0,0 +1,60 @@
+/**
+ * @file parent_selection.cpp
+ * @brief Compara la elección de padre por conteo de saltos contra RoutingCost
+ * en la misma red simulada (MeshSim) y reporta la ganancia en vida de la red.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/sim/parent_selection.cpp -o parent_selection
+ * Uso:
+ *   ./parent_selection [nodos=150] [semillas=5]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include "MeshSim.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+void imprimir(const char* nombre, const atx::sim::MeshResult& r) {
+  printf("  %-12s primera=%7.1f  10%%=%7.1f  50%%=%7.1f dias  entregados=%10llu (%.1f%%)  cambios_padre=%u\n",
+         nombre, r.primeraPerdida_dias, r.perdida10_dias, r.perdida50_dias,
+         (unsigned long long)r.entregados, r.generados ? 100.0 * r.entregados / r.generados : 0.0, r.cambiosPadre);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t nodos    = (argc > 1) ? (uint32_t)atoi(argv[1]) : 150;
+  const uint32_t semillas = (argc > 2) ? (uint32_t)atoi(argv[2]) : 5;
+
+  double sumaPrimera[2] = {}, suma10[2] = {}, suma50[2] = {}, sumaEntregados[2] = {}, sumaCambios[2] = {};
+  for (uint32_t s = 1; s <= semillas; ++s) {
+    atx::sim::MeshResult r[2];
+    for (int consciente = 0; consciente < 2; ++consciente) {
+      atx::sim::MeshCfg cfg;
+      cfg.nodos = nodos;
+      cfg.semilla = s;
+      cfg.costoConsciente = consciente != 0;
+      cfg.nodo.periodoAlto_ms  = 60000;   // telemetría de malla: 1, 3 y 10 min
+      cfg.nodo.periodoMedio_ms = 180000;
+      cfg.nodo.periodoBajo_ms  = 600000;
+      atx::sim::MeshSim red;
+      red.begin(cfg);
+      r[consciente] = red.run();
+      sumaPrimera[consciente]    += r[consciente].primeraPerdida_dias;
+      suma10[consciente]         += r[consciente].perdida10_dias;
+      suma50[consciente]         += r[consciente].perdida50_dias;
+      sumaEntregados[consciente] += (double)r[consciente].entregados;
+      sumaCambios[consciente]    += r[consciente].cambiosPadre;
+    }
+    printf("semilla %u (%u/%u nodos conectados)\n", s, r[0].nodosConectados, nodos);
+    imprimir("saltos", r[0]);
+    imprimir("RoutingCost", r[1]);
+  }
+  printf("ganancia media: primera_perdida x%.2f  10%% x%.2f  50%% x%.2f  entregados x%.2f  cambios_padre x%.1f\n",
+         sumaPrimera[1] / sumaPrimera[0], suma10[1] / suma10[0], suma50[1] / suma50[0],
+         sumaEntregados[1] / sumaEntregados[0], sumaCambios[1] / sumaCambios[0]);
+  return 0;
+}
@@ -0,0 +1,336 @@
+/**
+ * @file pareto.cpp
+ * @brief Búsqueda multiobjetivo (NSGA-II) de configuraciones: vida útil,
+ * frescura (edad media del dato en el gateway) y datos entregados, sobre los
+ * escenarios de Scenarios.h. Emite el frente de Pareto como presets de `Cfg`
+ * listos para copiar, con sus métricas.
+ *
+ * Los genes son índices en una grilla por parámetro (umbrales cada 10 mV,
+ * histéresis cada 0,25 %, períodos en 16 pasos logarítmicos), así que
+ * configuraciones repetidas comparten la evaluación: un caché por genoma
+ * evita volver a simular. Cada generación junta los genomas nuevos y los
+ * evalúa en lote repartidos entre hilos; el resultado no depende de la
+ * cantidad de hilos.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -pthread -I src -I extras/host extras/host/sim/pareto.cpp -o pareto
+ * Uso:
+ *   ./pareto [poblacion=24] [generaciones=12] [paso_ms=5000] [hilos=núcleos] [semilla=1] [presets=<archivo.h>]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <sim/Scenarios.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int K = 7;
+const int OBJETIVOS = 3;
+
+struct Gen {
+  const char* nombre;
+  double      min;
+  double      paso;        ///< Lineal: incremento; logarítmico: razón entre puntos.
+  uint8_t     puntos;
+  bool        logaritmico;
+
+  double valor(uint8_t i) const { return logaritmico ? min * std::pow(paso, i) : min + paso * i; }
+};
+
+const Gen GENES[K] = {
+  { "umbralAlto_V",       3.80,   0.01,   26, false },
+  { "umbralMedio_V",      3.50,   0.01,   26, false },
+  { "fraccionHisteresis", 0.005,  0.0025, 19, false },
+  { "corteVoltaje_V",     3.20,   0.01,   26, false },
+  { "periodoAlto_ms",     5000,   std::pow(6.0, 1.0 / 15),  16, true },  // 5 s .. 30 s
+  { "periodoMedio_ms",    10000,  std::pow(12.0, 1.0 / 15), 16, true },  // 10 s .. 120 s
+  { "periodoBajo_ms",     60000,  std::pow(15.0, 1.0 / 15), 16, true },  // 1 min .. 15 min
+};
+
+typedef std::array<uint8_t, K> Genoma;
+
+/** Métricas (medias sobre los escenarios). */
+struct Metricas {
+  double vida_dias = 0;
+  double aoi_s     = 0;
+  double envios    = 0;
+
+  /** Objetivos a minimizar. */
+  void objetivos(double f[OBJETIVOS]) const {
+    f[0] = -vida_dias;
+    f[1] = aoi_s;
+    f[2] = -envios;
+  }
+};
+
+/** Lleva los períodos a orden no decreciente (alto <= medio <= bajo): el resto del espacio no tiene sentido. */
+void reparar(Genoma& g) {
+  for (int j = 5; j < K; ++j) {
+    while (g[j] + 1 < GENES[j].puntos && GENES[j].valor(g[j]) < GENES[j - 1].valor(g[j - 1])) g[j]++;
+  }
+}
+
+AdaptiveTXWSN::Cfg aCfg(const Genoma& g) {
+  AdaptiveTXWSN::Cfg c;
+  c.umbralAlto_V       = (float)GENES[0].valor(g[0]);
+  c.umbralMedio_V      = (float)GENES[1].valor(g[1]);
+  c.fraccionHisteresis = (float)GENES[2].valor(g[2]);
+  c.corteVoltaje_V     = (float)GENES[3].valor(g[3]);
+  c.periodoAlto_ms     = (uint32_t)(lround(GENES[4].valor(g[4]) / 100.0) * 100);
+  c.periodoMedio_ms    = (uint32_t)(lround(GENES[5].valor(g[5]) / 100.0) * 100);
+  c.periodoBajo_ms     = (uint32_t)(lround(GENES[6].valor(g[6]) / 1000.0) * 1000);
+  return c;
+}
+
+Metricas evaluar(const Genoma& g, uint32_t paso_ms) {
+  size_t n = 0;
+  const atx::sim::Scenario* suite = atx::sim::scenarioSuite(n);
+  const AdaptiveTXWSN::Cfg cfg = aCfg(g);
+  Metricas m;
+  for (size_t s = 0; s < n; ++s) {
+    const atx::sim::ScenarioResult r = atx::sim::runScenario(suite[s], cfg, paso_ms);
+    m.vida_dias += r.vida_ms / 86400000.0;
+    m.aoi_s     += r.aoiMedio_s;
+    m.envios    += r.envios;
+  }
+  m.vida_dias /= n;
+  m.aoi_s     /= n;
+  m.envios    /= n;
+  return m;
+}
+
+/** Evalúa en paralelo los genomas que no están en el caché. */
+class Evaluador {
+public:
+  Evaluador(uint32_t paso_ms, unsigned hilos) : _paso_ms(paso_ms), _hilos(hilos) {}
+
+  void evaluar(const std::vector<Genoma>& genomas) {
+    std::vector<Genoma> nuevos;
+    for (const Genoma& g : genomas) {
+      _pedidas++;
+      if (_cache.count(g) == 0 && std::find(nuevos.begin(), nuevos.end(), g) == nuevos.end()) nuevos.push_back(g);
+    }
+    std::vector<Metricas> res(nuevos.size());
+    std::vector<std::thread> ts;
+    for (unsigned h = 0; h < _hilos; ++h) {
+      ts.emplace_back([&, h] {
+        for (size_t i = h; i < nuevos.size(); i += _hilos) res[i] = ::evaluar(nuevos[i], _paso_ms);
+      });
+    }
+    for (std::thread& t : ts) t.join();
+    for (size_t i = 0; i < nuevos.size(); ++i) _cache[nuevos[i]] = res[i];
+    _simuladas += nuevos.size();
+  }
+
+  const Metricas& operator[](const Genoma& g) const { return _cache.at(g); }
+  uint64_t pedidas() const { return _pedidas; }
+  uint64_t simuladas() const { return _simuladas; }
+
+private:
+  std::map<Genoma, Metricas> _cache;
+  uint32_t _paso_ms;
+  unsigned _hilos;
+  uint64_t _pedidas   = 0;
+  uint64_t _simuladas = 0;
+};
+
+bool domina(const Metricas& a, const Metricas& b) {
+  double fa[OBJETIVOS], fb[OBJETIVOS];
+  a.objetivos(fa);
+  b.objetivos(fb);
+  bool mejor = false;
+  for (int o = 0; o < OBJETIVOS; ++o) {
+    if (fa[o] > fb[o]) return false;
+    if (fa[o] < fb[o]) mejor = true;
+  }
+  return mejor;
+}
+
+/** Ordenamiento no dominado rápido y distancia de aglomeración (NSGA-II). */
+void clasificar(const std::vector<Metricas>& m, std::vector<int>& rango, std::vector<double>& aglomeracion) {
+  const size_t n = m.size();
+  rango.assign(n, 0);
+  aglomeracion.assign(n, 0.0);
+  std::vector<std::vector<int>> dominados(n);
+  std::vector<int> cuenta(n, 0);
+  std::vector<int> frente;
+  for (size_t p = 0; p < n; ++p) {
+    for (size_t q = 0; q < n; ++q) {
+      if (domina(m[p], m[q]))      dominados[p].push_back((int)q);
+      else if (domina(m[q], m[p])) cuenta[p]++;
+    }
+    if (cuenta[p] == 0) frente.push_back((int)p);
+  }
+  for (int r = 0; !frente.empty(); ++r) {
+    // Aglomeración dentro del frente
+    for (int o = 0; o < OBJETIVOS; ++o) {
+      std::sort(frente.begin(), frente.end(), [&](int a, int b) {
+        double fa[OBJETIVOS], fb[OBJETIVOS];
+        m[a].objetivos(fa);
+        m[b].objetivos(fb);
+        return fa[o] < fb[o];
+      });
+      double lo[OBJETIVOS], hi[OBJETIVOS];
+      m[frente.front()].objetivos(lo);
+      m[frente.back()].objetivos(hi);
+      aglomeracion[frente.front()] = aglomeracion[frente.back()] = 1e30;
+      const double ancho = hi[o] - lo[o];
+      if (ancho <= 0) continue;
+      for (size_t i = 1; i + 1 < frente.size(); ++i) {
+        double fa[OBJETIVOS], fb[OBJETIVOS];
+        m[frente[i - 1]].objetivos(fa);
+        m[frente[i + 1]].objetivos(fb);
+        aglomeracion[frente[i]] += (fb[o] - fa[o]) / ancho;
+      }
+    }
+    std::vector<int> siguiente;
+    for (int p : frente) {
+      rango[p] = r;
+      for (int q : dominados[p]) if (--cuenta[q] == 0) siguiente.push_back(q);
+    }
+    frente.swap(siguiente);
+  }
+}
+
+void escribirPresets(FILE* f, const std::vector<Genoma>& frente, const Evaluador& ev) {
+  fprintf(f, "// Frente de Pareto (vida, edad del dato, envíos) generado con extras/host/sim/pareto.cpp\n");
+  fprintf(f, "// sobre los escenarios de la versión %u de Scenarios.h.\n", atx::sim::SCENARIO_SUITE_VERSION);
+  for (size_t i = 0; i < frente.size(); ++i) {
+    const Metricas& m = ev[frente[i]];
+    const AdaptiveTXWSN::Cfg c = aCfg(frente[i]);
+    fprintf(f, "\n/// vida %.1f días, edad media %.1f s, %.0f envíos por escenario\n", m.vida_dias, m.aoi_s, m.envios);
+    fprintf(f, "inline AdaptiveTXWSN::Cfg paretoPreset%zu() {\n", i);
+    fprintf(f, "  AdaptiveTXWSN::Cfg c;\n");
+    fprintf(f, "  c.umbralAlto_V       = %.2ff;\n", c.umbralAlto_V);
+    fprintf(f, "  c.umbralMedio_V      = %.2ff;\n", c.umbralMedio_V);
+    fprintf(f, "  c.fraccionHisteresis = %.4ff;\n", c.fraccionHisteresis);
+    fprintf(f, "  c.corteVoltaje_V     = %.2ff;\n", c.corteVoltaje_V);
+    fprintf(f, "  c.periodoAlto_ms     = %u;\n", c.periodoAlto_ms);
+    fprintf(f, "  c.periodoMedio_ms    = %u;\n", c.periodoMedio_ms);
+    fprintf(f, "  c.periodoBajo_ms     = %u;\n", c.periodoBajo_ms);
+    fprintf(f, "  return c;\n}\n");
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint32_t poblacion      = (argc > 1) ? (uint32_t)atoi(argv[1]) : 24;
+  const uint32_t generaciones = (argc > 2) ? (uint32_t)atoi(argv[2]) : 12;
+  const uint32_t paso_ms  = (argc > 3) ? (uint32_t)atoi(argv[3]) : 5000;
+  unsigned hilos          = (argc > 4) ? (unsigned)atoi(argv[4]) : 0;
+  const uint32_t semilla  = (argc > 5) ? (uint32_t)atoi(argv[5]) : 1;
+  const char* presets     = (argc > 6) ? argv[6] : nullptr;
+  if (hilos == 0) hilos = std::max(1u, std::thread::hardware_concurrency());
+  poblacion += poblacion & 1; // pares de padres
+
+  size_t nEscenarios = 0;
+  atx::sim::scenarioSuite(nEscenarios); // inicializa la tabla antes de los hilos
+
+  std::mt19937 rng(semilla);
+  Evaluador ev(paso_ms, hilos);
+  auto t0 = std::chrono::steady_clock::now();
+
+  std::vector<Genoma> pob(poblacion);
+  for (Genoma& g : pob) {
+    for (int j = 0; j < K; ++j) g[j] = (uint8_t)(rng() % GENES[j].puntos);
+    reparar(g);
+  }
+  ev.evaluar(pob);
+
+  std::vector<int> rango;
+  std::vector<double> aglomeracion;
+  std::vector<Metricas> m;
+  auto metricas = [&](const std::vector<Genoma>& gs) {
+    m.clear();
+    for (const Genoma& g : gs) m.push_back(ev[g]);
+  };
+  metricas(pob);
+  clasificar(m, rango, aglomeracion);
+
+  std::uniform_real_distribution<double> u01(0.0, 1.0);
+  for (uint32_t gen = 0; gen < generaciones; ++gen) {
+    // Torneo binario por (rango, aglomeración)
+    auto torneo = [&]() -> const Genoma& {
+      const size_t a = rng() % pob.size(), b = rng() % pob.size();
+      if (rango[a] != rango[b]) return pob[(rango[a] < rango[b]) ? a : b];
+      return pob[(aglomeracion[a] >= aglomeracion[b]) ? a : b];
+    };
+    std::vector<Genoma> hijos;
+    while (hijos.size() < poblacion) {
+      Genoma h1 = torneo(), h2 = torneo();
+      if (u01(rng) < 0.9) {
+        for (int j = 0; j < K; ++j) if (u01(rng) < 0.5) std::swap(h1[j], h2[j]); // cruce uniforme
+      }
+      for (Genoma* h : { &h1, &h2 }) {
+        for (int j = 0; j < K; ++j) {
+          if (u01(rng) >= 1.0 / K) continue;
+          const int d = 1 + (int)(rng() % 3);
+          const int v = (int)(*h)[j] + ((rng() & 1) ? d : -d);
+          (*h)[j] = (uint8_t)std::min(std::max(v, 0), (int)GENES[j].puntos - 1);
+        }
+        reparar(*h);
+        hijos.push_back(*h);
+      }
+    }
+    ev.evaluar(hijos);
+
+    // Elitismo: padres + hijos, se queda con los mejores N por (rango, aglomeración)
+    std::vector<Genoma> todos(pob);
+    for (const Genoma& h : hijos) if (std::find(todos.begin(), todos.end(), h) == todos.end()) todos.push_back(h);
+    metricas(todos);
+    clasificar(m, rango, aglomeracion);
+    std::vector<int> orden(todos.size());
+    for (size_t i = 0; i < orden.size(); ++i) orden[i] = (int)i;
+    std::stable_sort(orden.begin(), orden.end(), [&](int a, int b) {
+      if (rango[a] != rango[b]) return rango[a] < rango[b];
+      return aglomeracion[a] > aglomeracion[b];
+    });
+    pob.clear();
+    for (size_t i = 0; i < orden.size() && pob.size() < poblacion; ++i) pob.push_back(todos[orden[i]]);
+    metricas(pob);
+    clasificar(m, rango, aglomeracion);
+    fprintf(stderr, "generacion %u/%u simuladas=%llu\n", gen + 1, generaciones, (unsigned long long)ev.simuladas());
+  }
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  std::vector<Genoma> frente;
+  for (size_t i = 0; i < pob.size(); ++i) if (rango[i] == 0) frente.push_back(pob[i]);
+  std::sort(frente.begin(), frente.end(), [&](const Genoma& a, const Genoma& b) { return ev[a].vida_dias > ev[b].vida_dias; });
+
+  printf("# nsga2 poblacion=%u generaciones=%u escenarios=%zu suite=%u paso_ms=%u semilla=%u hilos=%u "
+         "evaluaciones=%llu simuladas=%llu s=%.1f\n",
+         poblacion, generaciones, nEscenarios, atx::sim::SCENARIO_SUITE_VERSION, paso_ms, semilla, hilos,
+         (unsigned long long)ev.pedidas(), (unsigned long long)ev.simuladas(), s);
+  printf("preset,vida_dias,aoi_medio_s,envios,alto,medio,hist,corte,palto,pmedio,pbajo\n");
+  for (size_t i = 0; i < frente.size(); ++i) {
+    const Metricas& mt = ev[frente[i]];
+    const AdaptiveTXWSN::Cfg c = aCfg(frente[i]);
+    printf("%zu,%.2f,%.1f,%.0f,%.2f,%.2f,%.4f,%.2f,%u,%u,%u\n", i, mt.vida_dias, mt.aoi_s, mt.envios, c.umbralAlto_V,
+           c.umbralMedio_V, c.fraccionHisteresis, c.corteVoltaje_V, c.periodoAlto_ms, c.periodoMedio_ms,
+           c.periodoBajo_ms);
+  }
+  if (presets) {
+    FILE* f = fopen(presets, "w");
+    if (!f) { perror(presets); return 1; }
+    escribirPresets(f, frente, ev);
+    fclose(f);
+  } else {
+    printf("\n");
+    escribirPresets(stdout, frente, ev);
+  }
+  return 0;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file relay_load.cpp
+ * @brief Verifica en MeshSim que descontar la corriente de relevo del período
+ * propio (EnergyLedger::relayCurrentUa() -> AdaptiveTXWSN::setRelayCurrentUa())
+ * mantiene vivos a los relevos, con ruteo por saltos y por RoutingCost.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/sim/relay_load.cpp -o relay_load
+ * Uso:
+ *   ./relay_load [nodos=150] [semillas=5]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include "MeshSim.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+  const uint32_t nodos    = (argc > 1) ? (uint32_t)atoi(argv[1]) : 150;
+  const uint32_t semillas = (argc > 2) ? (uint32_t)atoi(argv[2]) : 5;
+  const char* nombres[4] = { "saltos", "saltos+relevo", "RoutingCost", "RoutingCost+relevo" };
+
+  double primera[4] = {}, p10[4] = {}, p50[4] = {}, entregados[4] = {};
+  for (uint32_t s = 1; s <= semillas; ++s) {
+    for (int k = 0; k < 4; ++k) {
+      atx::sim::MeshCfg cfg;
+      cfg.nodos = nodos;
+      cfg.semilla = s;
+      cfg.costoConsciente = k >= 2;
+      cfg.relevoEnPeriodo = (k & 1) != 0;
+      cfg.nodo.periodoAlto_ms  = 60000;   // telemetría de malla: 1, 3 y 10 min
+      cfg.nodo.periodoMedio_ms = 180000;
+      cfg.nodo.periodoBajo_ms  = 600000;
+      atx::sim::MeshSim red;
+      red.begin(cfg);
+      atx::sim::MeshResult r = red.run();
+      primera[k]    += r.primeraPerdida_dias / semillas;
+      p10[k]        += r.perdida10_dias / semillas;
+      p50[k]        += r.perdida50_dias / semillas;
+      entregados[k] += (double)r.entregados / semillas;
+    }
+  }
+  printf("%-20s %10s %10s %10s %14s\n", "ruteo", "primera_d", "10%_d", "50%_d", "entregados");
+  for (int k = 0; k < 4; ++k)
+    printf("%-20s %10.1f %10.1f %10.1f %14.0f\n", nombres[k], primera[k], p10[k], p50[k], entregados[k]);
+  return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file scenario_suite.cpp
+ * @brief Corre el conjunto de escenarios de Scenarios.h (un hilo por
+ * escenario) con la configuración dada y escribe una tabla CSV: envíos,
+ * energía, horas por nivel y en corte, rebotes, peor silencio, edad media
+ * del dato en el gateway y vida.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -pthread -I src -I extras/host extras/host/sim/scenario_suite.cpp -o scenario_suite
+ * Uso:
+ *   ./scenario_suite [clave=valor ...]
+ *       paso_ms=1000  alto=3.90 medio=3.60 hist=0.03 corte=3.40
+ *       palto=5000 pmedio=15000 pbajo=120000
+ *       grabado=<archivo>  agrega una fila con una traza medida ("t_s,volts" por línea)
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <sim/Scenarios.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+bool leerGrabado(const char* ruta, atx::sim::PiecewiseVoltage& traza) {
+  FILE* f = fopen(ruta, "r");
+  if (!f) { perror(ruta); return false; }
+  char linea[128];
+  double t_s, v;
+  uint64_t ultimo_ms = 0;
+  while (fgets(linea, sizeof(linea), f)) {
+    if (sscanf(linea, "%lf,%lf", &t_s, &v) != 2 || t_s < 0) continue; // encabezado o comentario
+    const uint64_t t_ms = (uint64_t)(t_s * 1000.0);
+    if (traza.size() > 0 && t_ms <= ultimo_ms) continue;
+    traza.add(t_ms, (float)v);
+    ultimo_ms = t_ms;
+  }
+  fclose(f);
+  return traza.size() > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  AdaptiveTXWSN::Cfg cfg;
+  uint32_t paso_ms = 1000;
+  const char* grabado = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    const char* eq = strchr(argv[i], '=');
+    if (!eq) { fprintf(stderr, "argumento sin '=': %s\n", argv[i]); return 2; }
+    const std::string k(argv[i], eq - argv[i]);
+    const char* v = eq + 1;
+    if      (k == "paso_ms") paso_ms = (uint32_t)atoi(v);
+    else if (k == "alto")    cfg.umbralAlto_V = (float)atof(v);
+    else if (k == "medio")   cfg.umbralMedio_V = (float)atof(v);
+    else if (k == "hist")    cfg.fraccionHisteresis = (float)atof(v);
+    else if (k == "corte")   cfg.corteVoltaje_V = (float)atof(v);
+    else if (k == "palto")   cfg.periodoAlto_ms = (uint32_t)atol(v);
+    else if (k == "pmedio")  cfg.periodoMedio_ms = (uint32_t)atol(v);
+    else if (k == "pbajo")   cfg.periodoBajo_ms = (uint32_t)atol(v);
+    else if (k == "grabado") grabado = v;
+    else { fprintf(stderr, "clave desconocida: %s\n", k.c_str()); return 2; }
+  }
+
+  size_t n = 0;
+  const atx::sim::Scenario* suite = atx::sim::scenarioSuite(n);
+  std::vector<atx::sim::Scenario> escenarios(suite, suite + n);
+  atx::sim::PiecewiseVoltage traza;
+  if (grabado) {
+    if (!leerGrabado(grabado, traza)) { fprintf(stderr, "%s: sin muestras\n", grabado); return 1; }
+    atx::sim::Scenario e;
+    e.nombre = "grabado";
+    e.curva = &atx::sim::CURVA_LIPO;
+    e.grabado = &traza;
+    e.dias = (uint32_t)(traza.lastMs() / 86400000ULL) + 1;
+    escenarios.push_back(e);
+  }
+
+  std::vector<atx::sim::ScenarioResult> res(escenarios.size());
+  std::vector<std::thread> hilos;
+  for (size_t i = 0; i < escenarios.size(); ++i)
+    hilos.emplace_back([&, i] { res[i] = atx::sim::runScenario(escenarios[i], cfg, paso_ms); });
+  for (std::thread& h : hilos) h.join();
+
+  printf("# suite=%u paso_ms=%u alto=%.3f medio=%.3f hist=%.3f corte=%.3f palto=%u pmedio=%u pbajo=%u\n",
+         atx::sim::SCENARIO_SUITE_VERSION, paso_ms, cfg.umbralAlto_V, cfg.umbralMedio_V, cfg.fraccionHisteresis,
+         cfg.corteVoltaje_V, cfg.periodoAlto_ms, cfg.periodoMedio_ms, cfg.periodoBajo_ms);
+  printf("escenario,version,envios,energia_mAh,h_alto,h_medio,h_bajo,h_corte,cambios_nivel,rebotes,"
+         "entradas_corte,silencio_max_s,aoi_medio_s,vida_dias,murio\n");
+  for (size_t i = 0; i < escenarios.size(); ++i) {
+    const atx::sim::ScenarioResult& r = res[i];
+    printf("%s,%u,%u,%.2f,%.1f,%.1f,%.1f,%.1f,%u,%u,%u,%.0f,%.1f,%.2f,%d\n", escenarios[i].nombre,
+           atx::sim::SCENARIO_SUITE_VERSION, r.envios, r.carga_uC / 3.6e6,
+           r.msPorNivel[AdaptiveTXWSN::BATT_HIGH] / 3.6e6, r.msPorNivel[AdaptiveTXWSN::BATT_MID] / 3.6e6,
+           r.msPorNivel[AdaptiveTXWSN::BATT_LOW] / 3.6e6, r.msEnCorte / 3.6e6, r.cambiosNivel, r.rebotes, r.entradasCorte,
+           r.silencioMaximo_ms / 1000.0, r.aoiMedio_s, r.vida_ms / 86400000.0, r.murio ? 1 : 0);
+  }
+  return 0;
+}
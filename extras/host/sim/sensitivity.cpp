@@ -0,0 +1,189 @@
+/**
+ * @file sensitivity.cpp
+ * @brief Análisis de sensibilidad global de los parámetros del `Cfg` sobre la
+ * vida útil y los datos entregados en los sitios de Scenarios.h.
+ *
+ * Método de Morris en diseño radial (Campolongo et al.): cada muestra es un
+ * punto base `a` y un punto auxiliar `b` de una secuencia de Halton con
+ * desplazamiento aleatorio (Cranley-Patterson, fijado por la semilla); se
+ * reemplaza un parámetro por vez de `a` por el de `b` y el efecto elemental
+ * es la diferencia de la salida dividida por el cambio en el espacio
+ * normalizado [0, 1]. Se reporta μ* (media del valor absoluto: importancia)
+ * y σ (dispersión: no linealidad o interacciones), ordenados por μ*.
+ *
+ * Cada evaluación corre todos los escenarios de la versión actual del
+ * conjunto; las salidas son la media de la vida (días, los que sobreviven
+ * cuentan el horizonte) y la media de envíos por escenario. Las muestras se
+ * reparten entre hilos y se reducen en orden, así que el resultado no
+ * depende de la cantidad de hilos.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -pthread -I src -I extras/host extras/host/sim/sensitivity.cpp -o sensitivity
+ * Uso:
+ *   ./sensitivity [muestras=16] [paso_ms=5000] [hilos=núcleos] [semilla=1]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <sim/Scenarios.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int K = 7; ///< Parámetros analizados.
+
+struct Parametro {
+  const char* nombre;
+  double      min;
+  double      max;
+  bool        logaritmico; ///< Períodos: uniforme en escala logarítmica.
+};
+
+const Parametro PARAMETROS[K] = {
+  { "umbralAlto_V",       3.80,   4.05,     false },
+  { "umbralMedio_V",      3.50,   3.75,     false },
+  { "fraccionHisteresis", 0.005,  0.05,     false },
+  { "corteVoltaje_V",     3.20,   3.45,     false },
+  { "periodoAlto_ms",     5000,   30000,    true  },
+  { "periodoMedio_ms",    10000,  120000,   true  },
+  { "periodoBajo_ms",     60000,  900000,   true  },
+};
+
+const int SALIDAS = 2;
+const char* const NOMBRES_SALIDA[SALIDAS] = { "vida_dias", "envios" };
+
+AdaptiveTXWSN::Cfg aCfg(const double u[K]) {
+  double x[K];
+  for (int j = 0; j < K; ++j) {
+    const Parametro& p = PARAMETROS[j];
+    x[j] = p.logaritmico ? std::exp(std::log(p.min) + u[j] * (std::log(p.max) - std::log(p.min)))
+                         : p.min + u[j] * (p.max - p.min);
+  }
+  AdaptiveTXWSN::Cfg c;
+  c.umbralAlto_V       = (float)x[0];
+  c.umbralMedio_V      = (float)x[1];
+  c.fraccionHisteresis = (float)x[2];
+  c.corteVoltaje_V     = (float)x[3];
+  c.periodoAlto_ms     = (uint32_t)lround(x[4]);
+  c.periodoMedio_ms    = (uint32_t)lround(x[5]);
+  c.periodoBajo_ms     = (uint32_t)lround(x[6]);
+  return c;
+}
+
+void evaluar(const double u[K], uint32_t paso_ms, double y[SALIDAS]) {
+  size_t n = 0;
+  const atx::sim::Scenario* suite = atx::sim::scenarioSuite(n);
+  const AdaptiveTXWSN::Cfg cfg = aCfg(u);
+  y[0] = y[1] = 0.0;
+  for (size_t s = 0; s < n; ++s) {
+    const atx::sim::ScenarioResult r = atx::sim::runScenario(suite[s], cfg, paso_ms);
+    y[0] += r.vida_ms / 86400000.0;
+    y[1] += r.envios;
+  }
+  y[0] /= n;
+  y[1] /= n;
+}
+
+/** Componente `d` del punto `i` de Halton (base = d-ésimo primo). */
+double halton(uint32_t i, int d) {
+  static const uint32_t PRIMOS[2 * K] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43 };
+  const uint32_t base = PRIMOS[d];
+  double f = 1.0, r = 0.0;
+  for (; i > 0; i /= base) {
+    f /= base;
+    r += f * (i % base);
+  }
+  return r;
+}
+
+/** Efectos elementales de una muestra radial: ee[j][salida]. */
+void muestraRadial(uint32_t i, const double desplazamiento[2 * K], uint32_t paso_ms, double ee[K][SALIDAS]) {
+  double a[K], b[K];
+  for (int j = 0; j < K; ++j) {
+    // i + 1: el punto 0 de Halton es el origen
+    a[j] = std::fmod(halton(i + 1, j) + desplazamiento[j], 1.0);
+    b[j] = std::fmod(halton(i + 1, K + j) + desplazamiento[K + j], 1.0);
+    if (std::fabs(b[j] - a[j]) < 0.05) b[j] = std::fmod(a[j] + 0.5, 1.0); // paso demasiado chico
+  }
+  double ya[SALIDAS];
+  evaluar(a, paso_ms, ya);
+  for (int j = 0; j < K; ++j) {
+    double x[K];
+    std::copy(a, a + K, x);
+    x[j] = b[j];
+    double yx[SALIDAS];
+    evaluar(x, paso_ms, yx);
+    for (int o = 0; o < SALIDAS; ++o) ee[j][o] = (yx[o] - ya[o]) / (b[j] - a[j]);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t muestras = (argc > 1) ? (uint32_t)atoi(argv[1]) : 16;
+  const uint32_t paso_ms  = (argc > 2) ? (uint32_t)atoi(argv[2]) : 5000;
+  unsigned hilos          = (argc > 3) ? (unsigned)atoi(argv[3]) : 0;
+  const uint32_t semilla  = (argc > 4) ? (uint32_t)atoi(argv[4]) : 1;
+  if (hilos == 0) hilos = std::max(1u, std::thread::hardware_concurrency());
+
+  size_t nEscenarios = 0;
+  atx::sim::scenarioSuite(nEscenarios); // inicializa la tabla antes de los hilos
+
+  std::mt19937 rng(semilla);
+  std::uniform_real_distribution<double> u01(0.0, 1.0);
+  double desplazamiento[2 * K];
+  for (int d = 0; d < 2 * K; ++d) desplazamiento[d] = u01(rng);
+
+  std::vector<double> ee((size_t)muestras * K * SALIDAS);
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> ts;
+  for (unsigned h = 0; h < hilos; ++h) {
+    ts.emplace_back([&, h] {
+      for (uint32_t i = h; i < muestras; i += hilos) {
+        double e[K][SALIDAS];
+        muestraRadial(i, desplazamiento, paso_ms, e);
+        for (int j = 0; j < K; ++j)
+          for (int o = 0; o < SALIDAS; ++o) ee[((size_t)i * K + j) * SALIDAS + o] = e[j][o];
+      }
+    });
+  }
+  for (std::thread& t : ts) t.join();
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  printf("# morris_radial muestras=%u evaluaciones=%u escenarios=%zu suite=%u paso_ms=%u semilla=%u hilos=%u s=%.1f\n",
+         muestras, muestras * (K + 1), nEscenarios, atx::sim::SCENARIO_SUITE_VERSION, paso_ms, semilla, hilos, s);
+  for (int o = 0; o < SALIDAS; ++o) {
+    double mu[K], sigma[K];
+    for (int j = 0; j < K; ++j) {
+      double suma = 0, sumaAbs = 0, suma2 = 0;
+      for (uint32_t i = 0; i < muestras; ++i) {
+        const double v = ee[((size_t)i * K + j) * SALIDAS + o];
+        suma += v;
+        sumaAbs += std::fabs(v);
+        suma2 += v * v;
+      }
+      mu[j] = sumaAbs / muestras;
+      const double media = suma / muestras;
+      sigma[j] = (muestras > 1) ? std::sqrt(std::max(0.0, (suma2 - muestras * media * media) / (muestras - 1))) : 0.0;
+    }
+    int orden[K];
+    for (int j = 0; j < K; ++j) orden[j] = j;
+    std::sort(orden, orden + K, [&](int x, int y) { return mu[x] > mu[y]; });
+    printf("\nsalida=%s\nrango,parametro,mu_estrella,sigma,relativo\n", NOMBRES_SALIDA[o]);
+    for (int r = 0; r < K; ++r) {
+      const int j = orden[r];
+      printf("%d,%s,%.4g,%.4g,%.3f\n", r + 1, PARAMETROS[j].nombre, mu[j], sigma[j],
+             mu[orden[0]] > 0 ? mu[j] / mu[orden[0]] : 0.0);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file skip_ahead.cpp
+ * @brief Compara SkipAhead (salto de evento en evento) con el loop() paso a
+ * paso sobre los mismos modelos de voltaje: envíos instante por instante,
+ * tiempo por nivel, ticks ejecutados y tiempo de cómputo.
+ *
+ * Escenarios: descarga lineal, ciclo solar diario con ruido (lineal a tramos
+ * cada 10 min, cruza los umbrales a diario) y, sólo por eventos, la vida de
+ * una celda en descarga lineal durante un año (con el día en que baja a MEDIO
+ * hallado paso a paso con nextEventMs()).
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/sim/skip_ahead.cpp -o skip_ahead
+ * Uso:
+ *   ./skip_ahead [dias=30] [paso_ms=100]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <sim/SkipAhead.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+double segundosDesde(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/** Referencia: tick() en cada paso del loop() con el voltaje del modelo. */
+template <class Modelo>
+atx::sim::SkipResult pasoAPaso(Modelo& modelo, uint64_t hasta_ms, uint32_t paso_ms, std::vector<uint64_t>& envios) {
+  atx::sim::SkipResult r;
+  atx::sim::setMillis(0);
+  AdaptiveTXWSN nodo;
+  nodo.begin(AdaptiveTXWSN::Cfg());
+  for (uint64_t t = 0; t <= hasta_ms; t += paso_ms) {
+    if (t > 0) {
+      if (nodo.isCutoff()) r.msEnCorte += paso_ms;
+      else                 r.msPorNivel[nodo.level()] += paso_ms;
+    }
+    atx::sim::setMillis((uint32_t)t);
+    const AdaptiveTXWSN::Level antes = nodo.level();
+    nodo.setBatteryVolts(modelo.volts(t));
+    if (nodo.tick()) {
+      r.envios++;
+      envios.push_back(t);
+    }
+    if (nodo.level() != antes) r.cambiosNivel++;
+    r.ticks++;
+  }
+  return r;
+}
+
+template <class Modelo>
+void comparar(const char* nombre, Modelo& modelo, uint64_t hasta_ms, uint32_t paso_ms) {
+  std::vector<uint64_t> enviosRef, enviosSalto;
+
+  auto t0 = std::chrono::steady_clock::now();
+  const atx::sim::SkipResult ref = pasoAPaso(modelo, hasta_ms, paso_ms, enviosRef);
+  const double sRef = segundosDesde(t0);
+
+  t0 = std::chrono::steady_clock::now();
+  atx::sim::SkipAhead sim;
+  sim.begin(AdaptiveTXWSN::Cfg(), paso_ms);
+  sim.run(modelo, hasta_ms, [&](uint64_t t, AdaptiveTXWSN&) { enviosSalto.push_back(t); });
+  const double sSalto = segundosDesde(t0);
+  const atx::sim::SkipResult& r = sim.result();
+
+  size_t difEnvios = (enviosRef.size() > enviosSalto.size()) ? enviosRef.size() - enviosSalto.size()
+                                                             : enviosSalto.size() - enviosRef.size();
+  for (size_t i = 0; i < std::min(enviosRef.size(), enviosSalto.size()); ++i) difEnvios += (enviosRef[i] != enviosSalto[i]);
+  uint64_t difNivel_ms = 0;
+  for (int n = 0; n < 3; ++n) difNivel_ms += (uint64_t)std::llabs((long long)(ref.msPorNivel[n] - r.msPorNivel[n]));
+  difNivel_ms += (uint64_t)std::llabs((long long)(ref.msEnCorte - r.msEnCorte));
+
+  printf("%-8s envios=%u/%u cambios_nivel=%u/%u dif_envios=%zu dif_nivel_ms=%llu "
+         "ticks=%llu/%llu s=%.3f/%.4f acel=%.0fx\n",
+         nombre, ref.envios, r.envios, ref.cambiosNivel, r.cambiosNivel, difEnvios, (unsigned long long)difNivel_ms,
+         (unsigned long long)ref.ticks, (unsigned long long)r.ticks, sRef, sSalto, sRef / (sSalto > 0 ? sSalto : 1e-9));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t dias    = (argc > 1) ? (uint32_t)atoi(argv[1]) : 30;
+  const uint32_t paso_ms = (argc > 2) ? (uint32_t)atoi(argv[2]) : 100;
+  const uint64_t hasta_ms = (uint64_t)dias * 86400000ULL;
+  printf("dias=%u paso_ms=%u (referencia/salto)\n", dias, paso_ms);
+
+  // Descarga lineal de 4.2 V a 3.3 V en el horizonte
+  atx::sim::LinearDischarge lineal(4.2f, -0.9f / (dias * 24.0f));
+  comparar("lineal", lineal, hasta_ms, paso_ms);
+
+  // Ciclo solar: carga de día, descarga de noche, tendencia descendente y ruido
+  atx::sim::PiecewiseVoltage solar;
+  std::mt19937 rng(11);
+  std::normal_distribution<double> ruido(0.0, 0.004);
+  for (uint64_t t = 0; t <= hasta_ms + 600000ULL; t += 600000ULL) {
+    const double dia = t / 86400000.0;
+    const double v = 3.78 - 0.004 * dia + 0.30 * std::sin(2.0 * M_PI * (dia - 0.25)) + ruido(rng);
+    solar.add(t, (float)v);
+  }
+  comparar("solar", solar, hasta_ms, paso_ms);
+
+  // Vida útil en un año, sólo por eventos
+  atx::sim::LinearDischarge anual(4.2f, -0.9f / (365.0f * 24.0f));
+  auto t0 = std::chrono::steady_clock::now();
+  atx::sim::SkipAhead sim;
+  sim.begin(AdaptiveTXWSN::Cfg(), paso_ms);
+  // Evento por evento con nextEventMs() hasta que el nivel deja de ser ALTO
+  while (sim.node().level() == AdaptiveTXWSN::BATT_HIGH) sim.run(anual, sim.nextEventMs(anual));
+  const double diaMedio = sim.now() / 86400000.0;
+  sim.run(anual, 400ULL * 86400000ULL);
+  const atx::sim::SkipResult& r = sim.result();
+  printf("anual    envios=%u ticks=%llu dia_medio=%.2f vida_dias=%.2f horas_alto/medio/bajo=%.0f/%.0f/%.0f s=%.4f\n",
+         r.envios, (unsigned long long)r.ticks, diaMedio, r.primerCorte_ms / 86400000.0, r.msPorNivel[AdaptiveTXWSN::BATT_HIGH] / 3.6e6,
+         r.msPorNivel[AdaptiveTXWSN::BATT_MID] / 3.6e6, r.msPorNivel[AdaptiveTXWSN::BATT_LOW] / 3.6e6, segundosDesde(t0));
+  return 0;
+}
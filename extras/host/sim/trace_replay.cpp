@@ -0,0 +1,256 @@
+/**
+ * @file trace_replay.cpp
+ * @brief Decodifica un volcado de BinaryTrace y reproduce la línea de tiempo
+ * con el motor Replay para comparar lo que hizo el nodo con lo que haría la
+ * configuración dada.
+ *
+ * `demo` genera un volcado de prueba: un nodo con BinaryTrace sobre un ciclo
+ * diario de batería con ruido, volcado entre líneas de texto como quedaría
+ * en una captura del puerto serie.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/sim/trace_replay.cpp -o trace_replay
+ * Uso:
+ *   ./trace_replay demo <archivo> [horas=24] [paso_ms=1000]
+ *   ./trace_replay list <archivo>
+ *   ./trace_replay replay <archivo> [paso_ms=1000]
+ *   ./trace_replay check   (corte de energía en cada escritura de un anillo que da vueltas)
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <BinaryTrace.h>
+#include <sim/Replay.h>
+#include <sim/TraceDecode.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+/** Salida con write(uint8_t), como Serial, sobre un FILE*. */
+struct SalidaArchivo {
+  FILE* f;
+  size_t write(uint8_t b) { return fputc(b, f) == EOF ? 0 : 1; }
+};
+
+/** Salida con write(uint8_t) sobre un vector. */
+struct SalidaMemoria {
+  std::vector<uint8_t> datos;
+  size_t write(uint8_t b) { datos.push_back(b); return 1; }
+};
+
+const char* nombreEvento(uint8_t e) {
+  switch (e) {
+    case TRAZA_MUESTRA_FIN:   return "muestra";
+    case TRAZA_CAMBIO_NIVEL:  return "nivel";
+    case TRAZA_CORTE_ENTRADA: return "corte+";
+    case TRAZA_CORTE_SALIDA:  return "corte-";
+    case TRAZA_ENVIO_DEBIDO:  return "envio";
+    case TRAZA_FILTRADO:      return "filtrado";
+    case BinaryTraceFormat::REINICIO: return "reinicio";
+    default:                  return "?";
+  }
+}
+
+bool leerArchivo(const char* ruta, std::vector<uint8_t>& buf) {
+  FILE* f = fopen(ruta, "rb");
+  if (!f) { perror(ruta); return false; }
+  uint8_t bloque[4096];
+  size_t n;
+  while ((n = fread(bloque, 1, sizeof(bloque), f)) > 0) buf.insert(buf.end(), bloque, bloque + n);
+  fclose(f);
+  return true;
+}
+
+bool decodificar(const char* ruta, std::vector<atx::sim::TraceRecord>& registros) {
+  std::vector<uint8_t> buf;
+  if (!leerArchivo(ruta, buf)) return false;
+  if (!atx::sim::decodeTrace(buf.data(), buf.size(), registros)) {
+    fprintf(stderr, "%s: no se encontró un volcado válido\n", ruta);
+    return false;
+  }
+  return true;
+}
+
+int demo(const char* ruta, uint32_t horas, uint32_t paso_ms) {
+  static BasicAdaptiveTXWSN<BinaryTrace<4096>> nodo;
+  atx::sim::setMillis(0);
+  nodo.tracer().begin(false);
+  nodo.begin(AdaptiveTXWSN::Cfg());
+
+  std::mt19937 rng(7);
+  std::normal_distribution<double> ruido(0.0, 0.001);
+  const uint32_t total_ms = horas * 3600000UL;
+  uint32_t envios = 0;
+  for (uint32_t t = 0; t < total_ms; t += paso_ms) {
+    const double v = 3.75 + 0.45 * std::sin(2.0 * M_PI * t / 86400000.0) + ruido(rng);
+    nodo.setBatteryVolts((float)(std::lround(v * 1000.0) / 1000.0));
+    if (nodo.tick()) envios++;
+    atx::sim::advanceMillis(paso_ms);
+  }
+
+  FILE* f = fopen(ruta, "wb");
+  if (!f) { perror(ruta); return 1; }
+  fprintf(f, "EVENTO: Transmitir. VBat: %.2fV\r\nvolcando traza...\r\n", nodo.lastVolts());
+  SalidaArchivo salida{ f };
+  nodo.tracer().dump(salida);
+  fprintf(f, "\r\nfin de la traza\r\n");
+  fclose(f);
+  printf("horas=%u envios=%u registros=%u bytes_volcado=%u bytes_por_registro=%u\n", horas, envios,
+         (unsigned)nodo.tracer().size(), (unsigned)nodo.tracer().dumpBytes(), (unsigned)BinaryTraceFormat::REGISTRO);
+  return 0;
+}
+
+int listar(const char* ruta) {
+  std::vector<atx::sim::TraceRecord> registros;
+  if (!decodificar(ruta, registros)) return 1;
+  for (const atx::sim::TraceRecord& r : registros) {
+    printf("%12.3f %-8s ", r.t_ms / 1000.0, nombreEvento(r.evento));
+    if (r.evento == TRAZA_CAMBIO_NIVEL)      printf("%u -> %u\n", r.dato >> 8, r.dato & 0xFF);
+    else if (r.evento == TRAZA_ENVIO_DEBIDO) printf("periodo=%us\n", r.dato);
+    else                                     printf("%umV\n", r.dato);
+  }
+  return 0;
+}
+
+int reproducir(const char* ruta, uint32_t paso_ms) {
+  std::vector<atx::sim::TraceRecord> registros;
+  if (!decodificar(ruta, registros)) return 1;
+
+  uint32_t cuentas[16] = {};
+  std::vector<uint32_t> enviosNodo;
+  uint32_t inicio_ms = 0;
+  const std::vector<atx::sim::Sample> muestras = atx::sim::traceSamples(registros, inicio_ms);
+  for (const atx::sim::TraceRecord& r : registros) {
+    cuentas[r.evento & 0x0F]++;
+    if (r.evento == TRAZA_ENVIO_DEBIDO) enviosNodo.push_back(r.t_ms - inicio_ms);
+  }
+  if (muestras.empty()) { fprintf(stderr, "la traza no tiene voltajes\n"); return 1; }
+  const uint32_t fin_ms = registros.back().t_ms - inicio_ms;
+
+  atx::sim::Replay replay;
+  const AdaptiveTXWSN::Cfg cfg;
+  replay.begin(cfg, paso_ms);
+  const int8_t nivel = atx::sim::traceInitialLevel(registros, inicio_ms, cfg);
+  if (nivel >= 0) replay.settle(muestras[0].t_ms, (AdaptiveTXWSN::Level)nivel, muestras[0].volts);
+  std::vector<uint32_t> enviosReplay;
+  auto alEnviar = [&](uint32_t t, const AdaptiveTXWSN&) { enviosReplay.push_back(t); };
+  for (const atx::sim::Sample& m : muestras) replay.feed(m, alEnviar);
+  replay.feed(atx::sim::Sample{ fin_ms, muestras.back().volts }, alEnviar);
+
+  // Empareja envíos en orden con tolerancia de un paso del loop()
+  size_t i = 0, j = 0, coinciden = 0;
+  long divergencia = -1;
+  while (i < enviosNodo.size() && j < enviosReplay.size()) {
+    const int64_t d = (int64_t)enviosReplay[j] - (int64_t)enviosNodo[i];
+    if (d <= (int64_t)paso_ms && d >= -(int64_t)paso_ms) { coinciden++; i++; j++; continue; }
+    if (divergencia < 0) divergencia = (long)std::min(enviosNodo[i], enviosReplay[j]);
+    if (d < 0) j++; else i++;
+  }
+
+  const atx::sim::ReplayResult& res = replay.result();
+  printf("registros=%zu ventana_h=%.2f muestras=%u envios=%u cambios_nivel=%u cortes=%u reinicios=%u\n",
+         registros.size(), (registros.back().t_ms - registros.front().t_ms) / 3.6e6, cuentas[TRAZA_MUESTRA_FIN],
+         cuentas[TRAZA_ENVIO_DEBIDO], cuentas[TRAZA_CAMBIO_NIVEL], cuentas[TRAZA_CORTE_ENTRADA],
+         cuentas[BinaryTraceFormat::REINICIO]);
+  printf("replay: envios=%u cambios_nivel=%u cortes=%u\n", res.envios, res.cambiosNivel, res.entradasCorte);
+  printf("envios_coincidentes=%zu/%zu", coinciden, enviosNodo.size());
+  if (divergencia >= 0) printf(" primera_divergencia_s=%.3f\n", (divergencia + inicio_ms) / 1000.0);
+  else                  printf(" sin_divergencia\n");
+  return 0;
+}
+
+/** Memoria que deja de escribir tras `limite` escrituras (corte de energía). */
+template <uint32_t BYTES>
+struct MemoriaConCorte {
+  uint8_t  datos[BYTES] = {};
+  uint32_t escritas     = 0;
+  uint32_t limite       = 0xFFFFFFFFUL;
+  uint8_t read(uint16_t dir) const { return datos[dir]; }
+  void    write(uint16_t dir, uint8_t b) { if (escritas++ < limite) datos[dir] = b; }
+};
+
+/**
+ * Corta la energía tras cada escritura posible mientras un anillo de 8
+ * registros da varias vueltas, retoma la memoria con begin() y exige que el
+ * volcado sea exactamente la cola de los registros completos (mismos
+ * instantes y datos) seguida de REINICIO.
+ */
+int verificar() {
+  const uint16_t N = 8;
+  const uint32_t EVENTOS = 30;
+  typedef MemoriaConCorte<BinaryTraceFormat::bytes(N)> Memoria;
+  auto avanzar = [](uint32_t k) { atx::sim::advanceMillis(1 + (k * 7919UL) % 200000UL); };
+
+  // Referencia: todos los registros con su instante, en un anillo que no da la vuelta
+  std::vector<atx::sim::TraceRecord> referencia;
+  {
+    static BinaryTrace<64> ref;
+    atx::sim::setMillis(0);
+    ref.begin(false);
+    for (uint32_t k = 0; k < EVENTOS; ++k) { avanzar(k); ref.onSendDue(k * 1000UL); }
+    SalidaMemoria salida;
+    ref.dump(salida);
+    atx::sim::decodeTrace(salida.datos.data(), salida.datos.size(), referencia);
+  }
+
+  uint32_t cortes = 0, fallas = 0;
+  for (uint32_t limite = 0;; ++limite) {
+    BinaryTrace<N, Memoria> nodo;
+    atx::sim::setMillis(0);
+    nodo.begin(false);
+    nodo.memory().escritas = 0;
+    nodo.memory().limite = limite;
+    uint32_t completos = 0;
+    for (uint32_t k = 0; k < EVENTOS; ++k) {
+      avanzar(k);
+      nodo.onSendDue(k * 1000UL);
+      if (nodo.memory().escritas <= limite) completos++;
+    }
+    if (completos == EVENTOS) break;
+    cortes++;
+
+    BinaryTrace<N, Memoria> tras;
+    memcpy(tras.memory().datos, nodo.memory().datos, sizeof(nodo.memory().datos));
+    tras.begin(true);
+    SalidaMemoria salida;
+    tras.dump(salida);
+    std::vector<atx::sim::TraceRecord> leidos;
+    bool ok = atx::sim::decodeTrace(salida.datos.data(), salida.datos.size(), leidos)
+           && !leidos.empty() && leidos.back().evento == BinaryTraceFormat::REINICIO;
+    if (ok) {
+      leidos.pop_back();
+      const size_t m = leidos.size();
+      ok = m <= completos && m + 1 >= std::min<size_t>(completos, N);
+      for (size_t i = 0; ok && i < m; ++i) {
+        const atx::sim::TraceRecord& r = referencia[completos - m + i];
+        ok = leidos[i].t_ms == r.t_ms && leidos[i].evento == r.evento && leidos[i].dato == r.dato;
+      }
+    }
+    if (!ok) fallas++;
+  }
+  printf("cortes=%u anillos_inconsistentes=%u %s\n", cortes, fallas, fallas == 0 ? "ok" : "FALLA");
+  return fallas == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 3 && strcmp(argv[1], "demo") == 0)
+    return demo(argv[2], (argc > 3) ? (uint32_t)atoi(argv[3]) : 24, (argc > 4) ? (uint32_t)atoi(argv[4]) : 1000);
+  if (argc >= 3 && strcmp(argv[1], "list") == 0)
+    return listar(argv[2]);
+  if (argc >= 3 && strcmp(argv[1], "replay") == 0)
+    return reproducir(argv[2], (argc > 3) ? (uint32_t)atoi(argv[3]) : 1000);
+  if (argc >= 2 && strcmp(argv[1], "check") == 0)
+    return verificar();
+  fprintf(stderr, "uso: %s demo <archivo> [horas] [paso_ms] | list <archivo> | replay <archivo> [paso_ms] | check\n", argv[0]);
+  return 2;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file variability_rate.cpp
+ * @brief Compara el período por nivel contra VariabilityRate sobre una señal
+ * sintética mayormente quieta con episodios de actividad.
+ *
+ * La señal es una deriva diaria lenta con ruido del sensor y, de vez en
+ * cuando, un episodio de 30 min con oscilaciones rápidas. El gateway retiene
+ * el último valor recibido; se mide el error absoluto medio de esa
+ * reconstrucción (total y durante los episodios) y los envíos y muestras por
+ * día. La batería se fija en cada nivel para ver las cotas de cada uno.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/sim/variability_rate.cpp -o variability_rate
+ * Uso:
+ *   ./variability_rate [dias=7] [episodiosPorDia=3]
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include <Arduino.h>
+#include <AdaptiveTXWSN.h>
+#include <VariabilityRate.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+struct Resultado {
+  double enviosDia    = 0;
+  double muestrasDia  = 0;
+  double error        = 0; ///< Error absoluto medio de la reconstrucción.
+  double errorEpisodio = 0; ///< Igual, sólo durante los episodios.
+};
+
+Resultado simular(bool variabilidad, float voltaje, uint32_t dias, double episodiosPorDia) {
+  std::mt19937 rng(2025);
+  std::normal_distribution<double> ruido(0.0, 2.0);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+
+  atx::sim::setMillis(0);
+  AdaptiveTXWSN nodo;
+  nodo.begin(AdaptiveTXWSN::Cfg());
+  nodo.setBatteryVolts(voltaje);
+  VariabilityRate<16> variab;
+  variab.begin(VariabilityRate<16>::Cfg());
+
+  Resultado r;
+  double recibido = 0, errorTotal = 0, errorEpisodio = 0;
+  uint32_t envios = 0, muestras = 0, segundosEpisodio = 0, finEpisodio = 0, proximaMuestra = 0;
+  int16_t ultimaLectura = 0;
+  const uint32_t total_s = dias * 86400UL;
+  for (uint32_t s = 0; s < total_s; ++s) {
+    if (s >= finEpisodio && u(rng) < episodiosPorDia / 86400.0) finEpisodio = s + 1800;
+    const bool episodio = s < finEpisodio;
+    double valor = 1000.0 + 100.0 * std::sin(2.0 * M_PI * s / 86400.0);
+    if (episodio) valor += 200.0 * std::sin(2.0 * M_PI * s / 900.0);
+    const double lectura = valor + ruido(rng);
+
+    // Muestreo: cada segundo con período por nivel, o según la variabilidad
+    const uint32_t periodoMuestra_s = variabilidad ? variab.samplePeriodMs(nodo.level()) / 1000 : 1;
+    if (s >= proximaMuestra) {
+      ultimaLectura = (int16_t)lround(lectura);
+      variab.addSample(ultimaLectura);
+      muestras++;
+      proximaMuestra = s + (periodoMuestra_s ? periodoMuestra_s : 1);
+    }
+    if (variabilidad) nodo.setPeriodOverride(variab.txPeriodMs(nodo.level()));
+    if (nodo.tick()) {
+      envios++;
+      recibido = ultimaLectura;
+    }
+    const double e = std::fabs(recibido - valor);
+    errorTotal += e;
+    if (episodio) { errorEpisodio += e; segundosEpisodio++; }
+    atx::sim::advanceMillis(1000);
+  }
+  r.enviosDia     = (double)envios / dias;
+  r.muestrasDia   = (double)muestras / dias;
+  r.error         = errorTotal / total_s;
+  r.errorEpisodio = segundosEpisodio ? errorEpisodio / segundosEpisodio : 0.0;
+  return r;
+}
+
+void imprimir(const char* nivel, const char* politica, const Resultado& r) {
+  printf("%-6s %-12s %10.0f %12.0f %9.1f %14.1f\n", nivel, politica, r.enviosDia, r.muestrasDia, r.error, r.errorEpisodio);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t dias     = (argc > 1) ? (uint32_t)atoi(argv[1]) : 7;
+  const double episodios  = (argc > 2) ? atof(argv[2]) : 3.0;
+
+  printf("%-6s %-12s %10s %12s %9s %14s\n", "nivel", "politica", "envios/d", "muestras/d", "error", "error_episodio");
+  const char* nombres[3] = { "BAJO", "MEDIO", "ALTO" };
+  const float voltajes[3] = { 3.45f, 3.75f, 4.10f };
+  for (int k = 2; k >= 0; --k) {
+    imprimir(nombres[k], "nivel", simular(false, voltajes[k], dias, episodios));
+    imprimir(nombres[k], "variabilidad", simular(true, voltajes[k], dias, episodios));
+  }
+  return 0;
+}
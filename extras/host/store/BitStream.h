@@ -0,0 +1,100 @@
+/**
+ * @file BitStream.h
+ * @brief Escritor y lector de flujos de bits (MSB primero) para la compresión
+ * de columnas del almacén de series temporales.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace atx {
+
+/**
+ * @class BitWriter
+ * @brief Acumula bits en un vector de bytes.
+ */
+class BitWriter {
+public:
+  /** @brief Escribe los `n` bits menos significativos de `v` (n <= 64). */
+  void write(uint64_t v, uint8_t n) {
+    while (n > 0) {
+      uint8_t libres = (uint8_t)(64 - _nAcum);
+      uint8_t k = (n < libres) ? n : libres;
+      uint64_t trozo = (k == 64) ? v : ((v >> (n - k)) & ((1ULL << k) - 1));
+      _acum = (k == 64) ? trozo : ((_acum << k) | trozo);
+      _nAcum = (uint8_t)(_nAcum + k);
+      n = (uint8_t)(n - k);
+      if (_nAcum == 64) volcar();
+    }
+  }
+
+  void writeBit(bool b) { write(b ? 1 : 0, 1); }
+
+  /** @brief Completa el último byte con ceros y devuelve los bytes. */
+  const std::vector<uint8_t>& finish() {
+    while (_nAcum % 8 != 0) { _acum <<= 1; _nAcum++; }
+    for (int s = (int)_nAcum - 8; s >= 0; s -= 8) _bytes.push_back((uint8_t)(_acum >> s));
+    _acum = 0;
+    _nAcum = 0;
+    return _bytes;
+  }
+
+private:
+  std::vector<uint8_t> _bytes;
+  uint64_t             _acum  = 0;
+  uint8_t              _nAcum = 0;
+
+  void volcar() {
+    for (int s = 56; s >= 0; s -= 8) _bytes.push_back((uint8_t)(_acum >> s));
+    _acum = 0;
+    _nAcum = 0;
+  }
+};
+
+/**
+ * @class BitReader
+ * @brief Lee bits de un bloque de memoria (p. ej. un chunk mapeado con mmap).
+ * Lee de a 8 bytes para que la decodificación no vaya bit a bit.
+ */
+class BitReader {
+public:
+  BitReader(const uint8_t* datos, size_t len) : _p(datos), _fin(datos + len) {}
+
+  /** @brief Lee `n` bits (1..57). Más allá del final devuelve ceros. */
+  uint64_t read(uint8_t n) {
+    if (_nAcum < n) rellenar();
+    uint64_t v = _acum >> (64 - n);
+    _acum <<= n;
+    _nAcum = (uint8_t)(_nAcum - n);
+    return v;
+  }
+
+  bool readBit() { return read(1) != 0; }
+
+  /** @brief Lee hasta 64 bits en dos partes. */
+  uint64_t read64(uint8_t n) {
+    if (n <= 32) return read(n);
+    uint64_t alto = read((uint8_t)(n - 32));
+    return (alto << 32) | read(32);
+  }
+
+private:
+  const uint8_t* _p;
+  const uint8_t* _fin;
+  uint64_t       _acum  = 0;  ///< Bits pendientes alineados a la izquierda.
+  uint8_t        _nAcum = 0;
+
+  void rellenar() {
+    while (_nAcum <= 56) {
+      uint64_t byte = (_p < _fin) ? *_p++ : 0;
+      _acum |= byte << (56 - _nAcum);
+      _nAcum = (uint8_t)(_nAcum + 8);
+    }
+  }
+};
+
+} // namespace atx
@@ -0,0 +1,422 @@
+/**
+ * @file TsStore.h
+ * @brief Almacén columnar, comprimido y de sólo-anexar para el historial de
+ * voltaje y nivel de la flota.
+ * Cada nodo escribe chunks independientes con tres columnas:
+ *  - instantes: delta-de-delta (Gorilla, con escape de 64 bits para huecos
+ *    de semanas),
+ *  - voltios:   XOR de float32 con ventana de bits significativos (Gorilla),
+ *  - Level:     RLE (nivel, longitud de corrida en varint).
+ * Los chunks se anexan a `<ruta>.dat` (mapeable con mmap) y su entrada de
+ * índice (nodo, t0, t1, desplazamiento) a `<ruta>.idx`.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include "BitStream.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace atx {
+
+/**
+ * @struct TsPoint
+ * @brief Una observación de un nodo (p. ej. extraída de su StatusBeacon).
+ */
+struct TsPoint {
+  int64_t t_ms;   ///< Instante absoluto (ms desde epoch).
+  float   volts;  ///< Equivalente a lastVolts().
+  uint8_t level;  ///< Equivalente a level().
+};
+
+namespace tsfmt {
+
+static const uint32_t MAGIA_CHUNK    = 0x44585441; // "ATXD": escapes de 64 bits en los instantes
+static const uint32_t MAGIA_CHUNK_V1 = 0x43585441; // "ATXC": sólo 32 bits (se sigue leyendo)
+static const uint32_t DELTA_ESCAPE   = 0xFFFFFFFFu; // primer delta: le siguen 64 bits
+
+/** @brief Cabecera de chunk tal como queda en disco (little-endian, 40 bytes). */
+struct ChunkHeader {
+  uint32_t magia;
+  uint32_t nodeId;
+  uint32_t n;
+  uint32_t bytesT;
+  uint32_t bytesV;
+  uint32_t bytesL;
+  int64_t  t0;
+  int64_t  t1;
+};
+
+/** @brief Entrada del índice (32 bytes). */
+struct IndexEntry {
+  uint32_t nodeId;
+  uint32_t n;
+  int64_t  t0;
+  int64_t  t1;
+  uint64_t offset;
+};
+
+static_assert(sizeof(ChunkHeader) == 40, "formato de cabecera");
+static_assert(sizeof(IndexEntry) == 32, "formato de índice");
+
+inline uint32_t bitsDe(float f) { uint32_t u; memcpy(&u, &f, 4); return u; }
+inline float    floatDe(uint32_t u) { float f; memcpy(&f, &u, 4); return f; }
+
+inline int64_t extenderSigno(uint64_t v, uint8_t bits) {
+  uint64_t m = 1ULL << (bits - 1);
+  return (int64_t)((v ^ m) - m);
+}
+
+/**
+ * @brief Codifica `n` puntos consecutivos de un nodo en un chunk.
+ */
+inline std::vector<uint8_t> encodeChunk(uint32_t nodeId, const TsPoint* p, uint32_t n) {
+  BitWriter t, v;
+  std::vector<uint8_t> l;
+
+  // --- Instantes: primer delta en 32 bits (o escape y 64 bits) y luego
+  //     delta-de-delta por cubetas; la última cubeta elige 32 o 64 bits ---
+  int64_t deltaPrevio = 0;
+  for (uint32_t i = 1; i < n; ++i) {
+    int64_t delta = p[i].t_ms - p[i - 1].t_ms;
+    if (i == 1) {
+      if (delta >= 0 && delta < (int64_t)DELTA_ESCAPE) t.write((uint64_t)delta, 32);
+      else { t.write(DELTA_ESCAPE, 32); t.write((uint64_t)delta, 64); }
+      deltaPrevio = delta;
+      continue;
+    }
+    int64_t dod = delta - deltaPrevio;
+    deltaPrevio = delta;
+    if (dod == 0)                          { t.writeBit(false); }
+    else if (dod >= -64   && dod < 64)     { t.write(0b10, 2);   t.write((uint64_t)dod & 0x7F, 7); }
+    else if (dod >= -256  && dod < 256)    { t.write(0b110, 3);  t.write((uint64_t)dod & 0x1FF, 9); }
+    else if (dod >= -2048 && dod < 2048)   { t.write(0b1110, 4); t.write((uint64_t)dod & 0xFFF, 12); }
+    else if (dod >= INT32_MIN && dod <= INT32_MAX) { t.write(0b11110, 5); t.write((uint64_t)dod & 0xFFFFFFFFULL, 32); }
+    else                                   { t.write(0b11111, 5); t.write((uint64_t)dod, 64); }
+  }
+
+  // --- Voltios: XOR con el valor previo ---
+  uint32_t previo = bitsDe(p[0].volts);
+  v.write(previo, 32);
+  uint8_t ceros0 = 0xFF, cerosF = 0;  // ventana vigente (ceros a la izquierda / derecha)
+  for (uint32_t i = 1; i < n; ++i) {
+    uint32_t actual = bitsDe(p[i].volts);
+    uint32_t x = actual ^ previo;
+    previo = actual;
+    if (x == 0) { v.writeBit(false); continue; }
+    v.writeBit(true);
+    uint8_t lz = (uint8_t)__builtin_clz(x);
+    uint8_t tz = (uint8_t)__builtin_ctz(x);
+    if (ceros0 != 0xFF && lz >= ceros0 && tz >= cerosF) {
+      v.writeBit(false);
+      v.write(x >> cerosF, (uint8_t)(32 - ceros0 - cerosF));
+    } else {
+      uint8_t significativos = (uint8_t)(32 - lz - tz);
+      v.writeBit(true);
+      v.write(lz, 5);
+      v.write(significativos - 1, 5);
+      v.write(x >> tz, significativos);
+      ceros0 = lz;
+      cerosF = tz;
+    }
+  }
+
+  // --- Level: RLE ---
+  for (uint32_t i = 0; i < n;) {
+    uint32_t j = i;
+    while (j < n && p[j].level == p[i].level) ++j;
+    uint32_t corrida = j - i;
+    l.push_back(p[i].level);
+    while (corrida >= 0x80) { l.push_back((uint8_t)(corrida | 0x80)); corrida >>= 7; }
+    l.push_back((uint8_t)corrida);
+    i = j;
+  }
+
+  const std::vector<uint8_t>& bt = t.finish();
+  const std::vector<uint8_t>& bv = v.finish();
+  ChunkHeader h = { MAGIA_CHUNK, nodeId, n, (uint32_t)bt.size(), (uint32_t)bv.size(), (uint32_t)l.size(),
+                    p[0].t_ms, p[n - 1].t_ms };
+  std::vector<uint8_t> out(sizeof(h));
+  memcpy(out.data(), &h, sizeof(h));
+  out.insert(out.end(), bt.begin(), bt.end());
+  out.insert(out.end(), bv.begin(), bv.end());
+  out.insert(out.end(), l.begin(), l.end());
+  while (out.size() % 8 != 0) out.push_back(0);
+  return out;
+}
+
+/**
+ * @brief Decodifica un chunk e invoca `fn(const TsPoint&)` para los puntos en [t0, t1].
+ * @return uint32_t Puntos decodificados (incluidos los fuera de rango).
+ */
+template <class Fn>
+uint32_t decodeChunk(const uint8_t* chunk, int64_t t0, int64_t t1, Fn&& fn) {
+  ChunkHeader h;
+  memcpy(&h, chunk, sizeof(h));
+  const uint8_t* pt = chunk + sizeof(h);
+  const uint8_t* pv = pt + h.bytesT;
+  const uint8_t* pl = pv + h.bytesV;
+  const uint8_t* finL = pl + h.bytesL;
+  BitReader t(pt, h.bytesT), v(pv, h.bytesV);
+  const bool v1 = (h.magia == MAGIA_CHUNK_V1);
+
+  int64_t  ts = h.t0, delta = 0;
+  uint32_t bitsV = (uint32_t)v.read(32);
+  uint8_t  ceros0 = 0, cerosF = 0;
+  uint8_t  nivel = 0;
+  uint32_t restantesCorrida = 0;
+
+  for (uint32_t i = 0; i < h.n; ++i) {
+    if (i == 1) {
+      delta = (int64_t)t.read(32);
+      if (!v1 && delta == (int64_t)DELTA_ESCAPE) delta = (int64_t)t.read64(64);
+      ts += delta;
+    } else if (i > 1) {
+      int64_t dod;
+      if (!t.readBit())      dod = 0;
+      else if (!t.readBit()) dod = extenderSigno(t.read(7), 7);
+      else if (!t.readBit()) dod = extenderSigno(t.read(9), 9);
+      else if (!t.readBit()) dod = extenderSigno(t.read(12), 12);
+      else if (v1 || !t.readBit()) dod = extenderSigno(t.read(32), 32);
+      else                         dod = (int64_t)t.read64(64);
+      delta += dod;
+      ts += delta;
+    }
+    if (i > 0 && v.readBit()) {
+      if (v.readBit()) {
+        ceros0 = (uint8_t)v.read(5);
+        uint8_t significativos = (uint8_t)(v.read(5) + 1);
+        cerosF = (uint8_t)(32 - ceros0 - significativos);
+      }
+      bitsV ^= (uint32_t)(v.read((uint8_t)(32 - ceros0 - cerosF)) << cerosF);
+    }
+    if (restantesCorrida == 0 && pl < finL) {
+      nivel = *pl++;
+      uint32_t corrida = 0;
+      for (uint8_t s = 0; pl < finL; s += 7) {
+        uint8_t b = *pl++;
+        corrida |= (uint32_t)(b & 0x7F) << s;
+        if (!(b & 0x80)) break;
+      }
+      restantesCorrida = corrida;
+    }
+    restantesCorrida--;
+    if (ts >= t0 && ts <= t1) fn(TsPoint{ ts, floatDe(bitsV), nivel });
+  }
+  return h.n;
+}
+
+} // namespace tsfmt
+
+/**
+ * @class TsStoreWriter
+ * @brief Acumula puntos por nodo y anexa un chunk cuando se llena.
+ */
+class TsStoreWriter {
+public:
+  /**
+   * @brief Abre (o crea) el almacén para anexar.
+   * @param ruta Prefijo; se usan `<ruta>.dat` y `<ruta>.idx`.
+   * @param puntosPorChunk Puntos por chunk antes de volcarlo.
+   * @return true Si ambos archivos se abrieron.
+   */
+  bool begin(const std::string& ruta, uint32_t puntosPorChunk = 1024) {
+    _puntosPorChunk = puntosPorChunk ? puntosPorChunk : 1;
+    _dat = fopen((ruta + ".dat").c_str(), "ab");
+    _idx = fopen((ruta + ".idx").c_str(), "ab");
+    if (!_dat || !_idx) return false;
+    fseek(_dat, 0, SEEK_END);
+    _offset = (uint64_t)ftell(_dat);
+    return true;
+  }
+
+  /** @brief Anexa un punto; los instantes de un nodo deben ser no decrecientes. */
+  void append(uint32_t nodeId, const TsPoint& p) {
+    std::vector<TsPoint>& buf = _pendientes[nodeId];
+    buf.push_back(p);
+    if (buf.size() >= _puntosPorChunk) volcar(nodeId, buf);
+  }
+
+  /** @brief Vuelca todos los chunks parciales y sincroniza los archivos. */
+  void flush() {
+    for (auto& kv : _pendientes) if (!kv.second.empty()) volcar(kv.first, kv.second);
+    if (_dat) fflush(_dat);
+    if (_idx) fflush(_idx);
+  }
+
+  /** @brief flush() y cierre. */
+  void close() {
+    flush();
+    if (_dat) { fclose(_dat); _dat = nullptr; }
+    if (_idx) { fclose(_idx); _idx = nullptr; }
+  }
+
+  ~TsStoreWriter() { close(); }
+
+  /** @brief Bytes comprimidos escritos en `.dat` (incluido lo previo). */
+  uint64_t bytesWritten() const { return _offset; }
+
+private:
+  FILE*                                            _dat = nullptr;
+  FILE*                                            _idx = nullptr;
+  uint64_t                                         _offset = 0;
+  uint32_t                                         _puntosPorChunk = 1024;
+  std::unordered_map<uint32_t, std::vector<TsPoint>> _pendientes;
+
+  void volcar(uint32_t nodeId, std::vector<TsPoint>& buf) {
+    std::vector<uint8_t> chunk = tsfmt::encodeChunk(nodeId, buf.data(), (uint32_t)buf.size());
+    // Los datos salen del búfer antes de escribir el índice; aun así el
+    // búfer del índice puede llegar al disco primero si el proceso muere,
+    // por eso open() descarta entradas cuyo chunk no está completo.
+    fwrite(chunk.data(), 1, chunk.size(), _dat);
+    fflush(_dat);
+    tsfmt::IndexEntry e = { nodeId, (uint32_t)buf.size(), buf.front().t_ms, buf.back().t_ms, _offset };
+    fwrite(&e, sizeof(e), 1, _idx);
+    _offset += chunk.size();
+    buf.clear();
+  }
+};
+
+/**
+ * @class TsStoreReader
+ * @brief Mapea `<ruta>.dat` en memoria y responde consultas por nodo y rango.
+ */
+class TsStoreReader {
+public:
+  /**
+   * @brief Mapea los datos y carga el índice.
+   * @return true Si el almacén existe y se pudo mapear.
+   */
+  bool open(const std::string& ruta) {
+    close();
+    int fd = ::open((ruta + ".dat").c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    fstat(fd, &st);
+    _len = (size_t)st.st_size;
+    if (_len > 0) {
+      void* m = mmap(nullptr, _len, PROT_READ, MAP_SHARED, fd, 0);
+      if (m == MAP_FAILED) { ::close(fd); return false; }
+      _datos = (const uint8_t*)m;
+      madvise(m, _len, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+
+    FILE* idx = fopen((ruta + ".idx").c_str(), "rb");
+    if (!idx) return false;
+    tsfmt::IndexEntry e;
+    while (fread(&e, sizeof(e), 1, idx) == 1) {
+      if (!chunkCompleto(e)) break; // escritura interrumpida
+      _indice[e.nodeId].push_back(e);
+      _finIndexado = std::max(_finIndexado, (size_t)e.offset + tamanoChunk(e.offset));
+    }
+    fclose(idx);
+    for (auto& kv : _indice) {
+      std::sort(kv.second.begin(), kv.second.end(),
+                [](const tsfmt::IndexEntry& a, const tsfmt::IndexEntry& b) { return a.t0 < b.t0; });
+    }
+    return true;
+  }
+
+  void close() {
+    if (_datos) munmap((void*)_datos, _len);
+    _datos = nullptr;
+    _len = 0;
+    _finIndexado = 0;
+    _indice.clear();
+  }
+
+  ~TsStoreReader() { close(); }
+
+  /**
+   * @brief Recorre los puntos de un nodo con `t0 <= t <= t1`, en orden temporal.
+   * @param fn Callable `void(const TsPoint&)`.
+   * @return uint64_t Puntos entregados.
+   */
+  template <class Fn>
+  uint64_t scan(uint32_t nodeId, int64_t t0, int64_t t1, Fn&& fn) const {
+    auto it = _indice.find(nodeId);
+    if (it == _indice.end()) return 0;
+    uint64_t n = 0;
+    auto contar = [&](const TsPoint& p) { n++; fn(p); };
+    for (const tsfmt::IndexEntry& e : it->second) {
+      if (e.t1 < t0 || e.t0 > t1) continue;
+      tsfmt::decodeChunk(_datos + e.offset, t0, t1, contar);
+    }
+    return n;
+  }
+
+  /**
+   * @brief Recorre todos los chunks en orden de archivo (barrido secuencial).
+   * Se detiene en el primer chunk incompleto y no pasa del último chunk
+   * indexado, así que entrega los mismos puntos que scan() sobre todos los nodos.
+   * @param fn Callable `void(uint32_t nodeId, const TsPoint&)`.
+   */
+  template <class Fn>
+  uint64_t scanAll(Fn&& fn) const {
+    uint64_t n = 0;
+    size_t off = 0;
+    while (off < _finIndexado) {
+      const size_t tam = tamanoChunk(off);
+      if (tam == 0 || off + tam > _finIndexado) break; // cabecera inválida o chunk cortado
+      tsfmt::ChunkHeader h;
+      memcpy(&h, _datos + off, sizeof(h));
+      const uint32_t id = h.nodeId;
+      n += tsfmt::decodeChunk(_datos + off, INT64_MIN, INT64_MAX, [&](const TsPoint& p) { fn(id, p); });
+      off += (tam + 7) & ~(size_t)7;
+    }
+    return n;
+  }
+
+  /** @brief Identificadores de nodo presentes en el índice. */
+  std::vector<uint32_t> nodes() const {
+    std::vector<uint32_t> v;
+    for (auto& kv : _indice) v.push_back(kv.first);
+    std::sort(v.begin(), v.end());
+    return v;
+  }
+
+  /** @brief Tamaño en bytes de los datos mapeados. */
+  size_t bytes() const { return _len; }
+
+private:
+  /**
+   * @brief Tamaño (cabecera y datos) del chunk en `off`, o 0 si la cabecera
+   * no es válida o el chunk no cabe entero dentro de `.dat`.
+   */
+  size_t tamanoChunk(uint64_t off) const {
+    if (off > _len || _len - off < sizeof(tsfmt::ChunkHeader)) return 0;
+    tsfmt::ChunkHeader h;
+    memcpy(&h, _datos + off, sizeof(h));
+    if (h.magia != tsfmt::MAGIA_CHUNK && h.magia != tsfmt::MAGIA_CHUNK_V1) return 0;
+    const uint64_t tam = sizeof(h) + (uint64_t)h.bytesT + h.bytesV + h.bytesL;
+    return (tam <= _len - off) ? (size_t)tam : 0;
+  }
+
+  /** @brief true si la entrada apunta a un chunk entero dentro de `.dat`. */
+  bool chunkCompleto(const tsfmt::IndexEntry& e) const {
+    if (tamanoChunk(e.offset) == 0) return false;
+    tsfmt::ChunkHeader h;
+    memcpy(&h, _datos + e.offset, sizeof(h));
+    return h.nodeId == e.nodeId && h.n == e.n;
+  }
+
+  const uint8_t*                                            _datos = nullptr;
+  size_t                                                    _len   = 0;
+  size_t                                                    _finIndexado = 0; ///< Fin del último chunk indexado.
+  std::unordered_map<uint32_t, std::vector<tsfmt::IndexEntry>> _indice;
+};
+
+} // namespace atx
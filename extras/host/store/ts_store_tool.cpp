@@ -0,0 +1,194 @@
+/**
+ * @file ts_store_tool.cpp
+ * @brief Herramienta del almacén de series: genera historial sintético,
+ * mide barridos y reproduce el historial de un nodo con el motor Replay.
+ *
+ * Compilar desde la raíz del repositorio:
+ *   g++ -std=c++17 -O2 -I src -I extras/host extras/host/store/ts_store_tool.cpp -o ts_store_tool
+ * Uso:
+ *   ./ts_store_tool gen <ruta> <nodos> <dias> [muestra_s=60]
+ *   ./ts_store_tool scan <ruta> [nodo t0_ms t1_ms]
+ *   ./ts_store_tool replay <ruta> <nodo> [paso_ms=1000]
+ *   ./ts_store_tool check <ruta>   (ida y vuelta con huecos de semanas y escritura cortada)
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#include "TsStore.h"
+#include <sim/Replay.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+const int64_t EPOCH_BASE_ms = 1735689600000LL; // 2025-01-01T00:00:00Z
+const size_t  BYTES_FILA    = sizeof(int64_t) + sizeof(float) + sizeof(uint8_t); // equivalente en filas
+
+double segundosDesde(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int generar(const char* ruta, uint32_t nodos, double dias, uint32_t muestra_s) {
+  atx::TsStoreWriter w;
+  if (!w.begin(ruta)) { perror(ruta); return 1; }
+  std::mt19937 rng(7);
+  std::normal_distribution<float> ruidoAdc(0.0f, 0.004f);
+  const uint64_t muestras = (uint64_t)(dias * 86400.0 / muestra_s);
+
+  // Un AdaptiveTXWSN por nodo para que el nivel registrado sea el real (con histéresis)
+  std::vector<AdaptiveTXWSN> nodosSim(nodos);
+  AdaptiveTXWSN::Cfg cfg;
+  cfg.pinAdcBateria = -1;
+  for (auto& n : nodosSim) n.begin(cfg);
+
+  for (uint64_t k = 0; k < muestras; ++k) {
+    const int64_t t = EPOCH_BASE_ms + (int64_t)k * muestra_s * 1000;
+    for (uint32_t id = 0; id < nodos; ++id) {
+      // Descarga lineal de 4.15 V a 3.3 V a lo largo del período, con pendiente distinta por nodo
+      float frac = (float)k / (float)muestras * (0.7f + 0.6f * (float)(id % 11) / 10.0f);
+      float v = 4.15f - 0.85f * std::min(frac, 1.0f) + ruidoAdc(rng);
+      v = roundf(v * 1000.0f) / 1000.0f; // resolución de mV, como la baliza
+      nodosSim[id].setBatteryVolts(v);
+      nodosSim[id].tick();
+      w.append(id, atx::TsPoint{ t, v, (uint8_t)nodosSim[id].level() });
+    }
+  }
+  w.close();
+  const uint64_t puntos = muestras * nodos;
+  printf("puntos=%llu bytes=%llu bytes_por_punto=%.2f compresion=%.1fx\n",
+         (unsigned long long)puntos, (unsigned long long)w.bytesWritten(),
+         (double)w.bytesWritten() / (double)puntos, (double)(puntos * BYTES_FILA) / (double)w.bytesWritten());
+  return 0;
+}
+
+int barrer(const char* ruta, int argc, char** argv) {
+  atx::TsStoreReader r;
+  if (!r.open(ruta)) { perror(ruta); return 1; }
+  double sumaV = 0;
+  uint64_t n;
+  auto t0 = std::chrono::steady_clock::now();
+  if (argc >= 3) {
+    n = r.scan((uint32_t)atoi(argv[0]), atoll(argv[1]), atoll(argv[2]),
+               [&](const atx::TsPoint& p) { sumaV += p.volts; });
+  } else {
+    n = r.scanAll([&](uint32_t, const atx::TsPoint& p) { sumaV += p.volts; });
+  }
+  double s = segundosDesde(t0);
+  printf("puntos=%llu segundos=%.3f puntos_por_s=%.0f GB_s_equivalente=%.2f GB_s_comprimido=%.2f media_V=%.4f\n",
+         (unsigned long long)n, s, n / s, n * BYTES_FILA / s / 1e9, r.bytes() / s / 1e9, n ? sumaV / n : 0.0);
+  return 0;
+}
+
+int reproducir(const char* ruta, uint32_t nodo, uint32_t paso_ms) {
+  atx::TsStoreReader r;
+  if (!r.open(ruta)) { perror(ruta); return 1; }
+  atx::sim::Replay replay;
+  replay.begin(AdaptiveTXWSN::Cfg(), paso_ms);
+
+  int64_t base = INT64_MIN;
+  uint64_t puntos = 0, coincidencias = 0;
+  r.scan(nodo, INT64_MIN, INT64_MAX, [&](const atx::TsPoint& p) {
+    if (base == INT64_MIN) base = p.t_ms;
+    replay.feed(atx::sim::Sample{ (uint32_t)(p.t_ms - base), p.volts });
+    puntos++;
+    if (replay.node().level() == p.level) coincidencias++;
+  });
+  const atx::sim::ReplayResult& res = replay.result();
+  printf("puntos=%llu coincidencia_nivel=%.4f envios=%u cambios_nivel=%u entradas_corte=%u silencio_max_s=%.1f\n",
+         (unsigned long long)puntos, puntos ? (double)coincidencias / puntos : 0.0, res.envios,
+         res.cambiosNivel, res.entradasCorte, res.silencioMaximo_ms / 1000.0);
+  printf("horas_alto=%.2f horas_medio=%.2f horas_bajo=%.2f horas_corte=%.2f\n",
+         res.msPorNivel[AdaptiveTXWSN::BATT_HIGH] / 3.6e6, res.msPorNivel[AdaptiveTXWSN::BATT_MID] / 3.6e6,
+         res.msPorNivel[AdaptiveTXWSN::BATT_LOW] / 3.6e6, res.msEnCorte / 3.6e6);
+  return 0;
+}
+
+/**
+ * Ida y vuelta exacta de nodos con huecos de 1 a 120 días entre ráfagas
+ * (primer delta y delta-de-delta más allá de 32 bits), y descarte del
+ * último chunk cuando `.dat` queda truncado detrás de su entrada de índice,
+ * tanto en scan() como en el barrido secuencial scanAll().
+ */
+int verificar(const char* ruta) {
+  const int64_t DIA_ms = 86400000LL;
+  const int64_t huecos_ms[] = { 60000, 50 * DIA_ms, 1, 25 * DIA_ms + 1, 3 * 7 * DIA_ms, 0, 120 * DIA_ms, 5000 };
+  std::vector<std::vector<atx::TsPoint>> esperados(8);
+  for (uint32_t id = 0; id < esperados.size(); ++id) {
+    int64_t t = EPOCH_BASE_ms + id;
+    for (uint32_t k = 0; k < 300; ++k) {
+      // Primer delta del nodo: el hueco id; después ráfagas de 60 s separadas por huecos
+      t += (k == 1) ? huecos_ms[id] : (k % 37 == 0) ? huecos_ms[(id + k) % 8] : 60000 + (int64_t)(k % 3) * 7;
+      esperados[id].push_back(atx::TsPoint{ t, 3.3f + 0.001f * (float)((k * 7 + id) % 900), (uint8_t)(k / 100) });
+    }
+  }
+
+  unlink((std::string(ruta) + ".dat").c_str());
+  unlink((std::string(ruta) + ".idx").c_str());
+  {
+    atx::TsStoreWriter w;
+    if (!w.begin(ruta, 64)) { perror(ruta); return 1; }
+    for (uint32_t id = 0; id < esperados.size(); ++id)
+      for (const atx::TsPoint& p : esperados[id]) w.append(id, p);
+    w.close();
+  }
+
+  uint32_t fallas = 0;
+  atx::TsStoreReader r;
+  if (!r.open(ruta)) { perror(ruta); return 1; }
+  for (uint32_t id = 0; id < esperados.size(); ++id) {
+    size_t k = 0;
+    uint32_t malos = 0;
+    r.scan(id, INT64_MIN, INT64_MAX, [&](const atx::TsPoint& p) {
+      const atx::TsPoint& e = esperados[id][k < esperados[id].size() ? k : 0];
+      if (k >= esperados[id].size() || p.t_ms != e.t_ms || p.volts != e.volts || p.level != e.level) malos++;
+      k++;
+    });
+    if (malos || k != esperados[id].size()) fallas++;
+    printf("nodo=%u hueco_dias=%.2f puntos=%zu malos=%u %s\n", id, huecos_ms[id] / (double)DIA_ms, k, malos,
+           (malos || k != esperados[id].size()) ? "FALLA" : "ok");
+  }
+
+  // Chunk final cortado (cortes crecientes sobre el mismo archivo): su
+  // entrada de índice debe descartarse y el barrido secuencial no debe
+  // decodificar más allá del final del archivo.
+  const size_t completo = r.bytes();
+  const uint64_t total = esperados.size() * esperados[0].size();
+  const size_t cortes[] = { 9, 100 };
+  for (size_t corte : cortes) {
+    r.close();
+    if (truncate((std::string(ruta) + ".dat").c_str(), (off_t)(completo - corte)) != 0) { perror(ruta); return 1; }
+    if (!r.open(ruta)) { perror(ruta); return 1; }
+    uint64_t leidos = 0;
+    for (uint32_t id = 0; id < esperados.size(); ++id) leidos += r.scan(id, INT64_MIN, INT64_MAX, [](const atx::TsPoint&) {});
+    uint32_t ajenos = 0;
+    const uint64_t barridos = r.scanAll([&](uint32_t id, const atx::TsPoint& p) {
+      if (id >= esperados.size() || p.t_ms < esperados[id].front().t_ms || p.t_ms > esperados[id].back().t_ms) ajenos++;
+    });
+    const bool okCorte = leidos < total && total - leidos <= 64 && barridos == leidos && ajenos == 0;
+    if (!okCorte) fallas++;
+    printf("truncado -%zu bytes: puntos=%llu de %llu barrido=%llu ajenos=%u %s\n", corte, (unsigned long long)leidos,
+           (unsigned long long)total, (unsigned long long)barridos, ajenos, okCorte ? "ok" : "FALLA");
+  }
+  return fallas ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 5 && strcmp(argv[1], "gen") == 0)
+    return generar(argv[2], (uint32_t)atoi(argv[3]), atof(argv[4]), (argc > 5) ? (uint32_t)atoi(argv[5]) : 60);
+  if (argc >= 3 && strcmp(argv[1], "scan") == 0)
+    return barrer(argv[2], argc - 3, argv + 3);
+  if (argc >= 3 && strcmp(argv[1], "check") == 0)
+    return verificar(argv[2]);
+  if (argc >= 4 && strcmp(argv[1], "replay") == 0)
+    return reproducir(argv[2], (uint32_t)atoi(argv[3]), (argc > 4) ? (uint32_t)atoi(argv[4]) : 1000);
+  fprintf(stderr,
+          "uso: ts_store_tool gen <ruta> <nodos> <dias> [muestra_s]\n"
+          "     ts_store_tool scan <ruta> [nodo t0_ms t1_ms]\n"
+          "     ts_store_tool replay <ruta> <nodo> [paso_ms]\n"
+          "     ts_store_tool check <ruta>\n");
+  return 2;
+}
@@ -10,53 +10,36 @@
 
  #pragma once
  #include <Arduino.h>
- 
+ #include "AdaptiveTXWSNTypes.h"
+ #include "StagePolicies.h"
+ #include "TracePolicies.h"
+
  /**
-  * @class AdaptiveTXWSN
+  * @class BasicAdaptiveTXWSN
   * @brief Gestiona la lógica de transmisión adaptativa basada en el voltaje de la batería.
   *
   * La clase monitorea el voltaje, lo clasifica en niveles (ALTO, MEDIO, BAJO)
   * y determina el intervalo de tiempo adecuado para la próxima transmisión.
+  *
+  * Cada etapa de tick() es una política (ver StagePolicies.h para los
+  * conceptos) resuelta en compilación; `AdaptiveTXWSN` usa las de por defecto.
+  *
+  * @tparam Trace Política de traza (ver TracePolicies.h); sus ganchos se
+  * llaman al medir, filtrar, clasificar, cambiar de nivel, entrar o salir del
+  * corte y cuando toca enviar. `AdaptiveTXWSN` usa NoTrace, que no genera código.
+  * @tparam Sampler Lectura de la batería (AdcSampler).
+  * @tparam Filter Suavizado de la medición (NoFilter).
+  * @tparam Classifier Nivel a partir del voltaje (HysteresisClassifier).
+  * @tparam Scheduler Instante de envío dado el período (DeadlineScheduler).
   */
- class AdaptiveTXWSN {
+ template <class Trace      = NoTrace,
+           class Sampler    = AdcSampler,
+           class Filter     = NoFilter,
+           class Classifier = HysteresisClassifier,
+           class Scheduler  = DeadlineScheduler>
+ class BasicAdaptiveTXWSN : public AdaptiveTXWSNTypes, private Trace, private Sampler,
+                            private Filter, private Classifier, private Scheduler {
  public:
-   /**
-    * @struct Cfg
-    * @brief Estructura de configuración para la librería AdaptiveTXWSN.
-    * Contiene todos los pines, umbrales y períodos de operación.
-    */
-   struct Cfg {
-     // --- Lectura de bateria ---
-     int8_t  pinAdcBateria           = -1;     ///< Pin ADC para leer batería. -1 si se inyecta el voltaje manualmente.
-     float   voltajeReferenciaAdc    = 5.0f;   ///< Voltaje de referencia del ADC (5.0V, 3.3V, 1.1V, etc.).
-     float   divisorRArriba_k        = 100.0f; ///< Resistencia superior (kΩ) del divisor de voltaje (Vin -> R_arriba -> ADC).
-     float   divisorRAbajo_k         =  33.0f; ///< Resistencia inferior (kΩ) del divisor de voltaje (ADC -> R_abajo -> GND).
-     uint8_t muestrasPromedioAdc     = 8;      ///< Número de muestras a promediar para estabilizar la lectura de VBAT.
-                                               ///< Si no se usan resistencias, añadir 0 y 1 para evitar división por cero.
-     // --- Umbrales (VOLTIOS) ---
-     float umbralAlto_V              = 3.90f;  ///< Voltaje por encima del cual se considera nivel ALTO.
-     float umbralMedio_V             = 3.60f;  ///< Voltaje por encima del cual se considera nivel MEDIO (y por debajo de ALTO).
-     float fraccionHisteresis        = 0.03f;  ///< Fracción (ej. 0.03 = 3%) de histéresis para evitar rebotes de nivel.
- 
-     // --- Periodos de envio (ms) por nivel ---
-     uint32_t periodoAlto_ms         = 5000;   ///< Período de transmisión (ms) cuando el nivel es ALTO.
-     uint32_t periodoMedio_ms        = 15000;  ///< Período de transmisión (ms) cuando el nivel es MEDIO.
-     uint32_t periodoBajo_ms         = 120000; ///< Período de transmisión (ms) cuando el nivel es BAJO.
- 
-     // --- Corte duro: por debajo NO se transmite ---
-     float corteVoltaje_V            = 3.40f;  ///< Voltaje por debajo del cual el nodo deja de transmitir (isCutoff() = true).
-   };
- 
-   /**
-    * @enum Level
-    * @brief Define los niveles de energía discretos del nodo.
-    */
-   enum Level : uint8_t {
-     BATT_LOW=0,  ///< Nivel de energía bajo. Período de transmisión largo.
-     BATT_MID=1,  ///< Nivel de energía medio. Período de transmisión normal.
-     BATT_HIGH=2  ///< Nivel de energía alto. Período de transmisión corto.
-   };
- 
    /**
     * @brief Inicializa la librería con la configuración y umbrales.
     * Esta función configura los pines y establece los parámetros de operación iniciales.
@@ -77,11 +60,17 @@
      // Sobrescribir rangos/umbrales y periodos
 
      // Inicialización de hardware/estado
-     if (_configuracion.pinAdcBateria >= 0) {
-       pinMode(_configuracion.pinAdcBateria, INPUT);
-     }
+     Sampler::begin(_configuracion);
+     Filter::reset();
+     Classifier::begin(_configuracion);
+     Scheduler::begin(millis());
      _nivelEnergeticoActual = BATT_HIGH;      // Se recalibra en el primer tick()
-     _msProximoEnvio        = millis();
+     _derivaReloj_ppm       = 0;
+     _multiplicadorQ8       = 256;
+     _corrienteRelevo_uA    = 0;
+     _cargaEnvio_uC         = 0;
+     _periodoForzado_ms     = 0;
+     _bloqueadoPorCorte     = false;
    }
  
  
@@ -93,28 +82,41 @@
     * @return false Si aún no es momento de transmitir.
     */
    bool tick() {
-     // 1) Medir bateria
-     float voltajeBateria_V = (_usarLecturaInyectada)
-                               ? _voltajeInyectado_V
-                               : readBatteryVolts();
+     // 1) Medir bateria y filtrar
+     Trace::onSampleStart();
+     const float medido_V = (_usarLecturaInyectada) ? _voltajeInyectado_V : readBatteryVolts();
+     Trace::onSampleEnd(milivoltios(medido_V));
+     float voltajeBateria_V = Filter::apply(medido_V);
      _ultimoVoltajeMedido_V = voltajeBateria_V;
+     const uint16_t mV = milivoltios(voltajeBateria_V);
+     Trace::onFilterEnd(mV);
  
      // 2) Aplicar corte duro
      if (voltajeBateria_V < _configuracion.corteVoltaje_V) {
+       if (!_bloqueadoPorCorte) Trace::onCutoff(true, mV);
        _bloqueadoPorCorte = true;
+       Trace::onTickEnd(false);
        return false;
      }
+     if (_bloqueadoPorCorte) Trace::onCutoff(false, mV);
      _bloqueadoPorCorte = false;
  
      // 3) Actualizar nivel con histeresis
-     actualizarNivelConHisteresis(voltajeBateria_V);
+     const Level nivelAnterior = _nivelEnergeticoActual;
+     _nivelEnergeticoActual = Classifier::classify(_configuracion, _nivelEnergeticoActual, voltajeBateria_V);
+     Trace::onClassify(_nivelEnergeticoActual, mV);
+     if (_nivelEnergeticoActual != nivelAnterior) Trace::onLevelChange(nivelAnterior, _nivelEnergeticoActual);
  
      // 4) Temporizador
      uint32_t ahoraMs = millis();
-     if ((int32_t)(ahoraMs - _msProximoEnvio) >= 0) {
-       _msProximoEnvio = ahoraMs + currentPeriod();
+     if (Scheduler::due(ahoraMs)) {
+       const uint32_t periodo_ms = currentPeriod();
+       Scheduler::schedule(ahoraMs, periodoCorregidoPorDeriva(periodo_ms));
+       Trace::onSendDue(periodo_ms);
+       Trace::onTickEnd(true);
        return true; // toca transmitir
      }
+     Trace::onTickEnd(false);
      return false;
    }
  
@@ -130,28 +132,15 @@
    }
  
    /**
-    * @brief Lee el voltaje de la batería usando el pin ADC configurado y el divisor.
-    * Realiza un promediado de lecturas para estabilizar el valor.
+    * @brief Lee el voltaje de la batería con el Sampler (sin filtrar).
+    * Con AdcSampler usa el pin ADC configurado y el divisor, promediando lecturas.
     *
-    * @note Asume un ADC de 10 bits (1023.0f) por defecto para Arduino (ej. ATmega328P).
+    * @note AdcSampler asume un ADC de 10 bits (1023.0f) por defecto para Arduino (ej. ATmega328P).
     * Ajustar `voltajeReferenciaAdc` si se usa ref interna (1.1V) o si se porta a otro MCU.
     *
     * @return El voltaje calculado de la batería en Voltios.
     */
-   float readBatteryVolts() {
-     if (_configuracion.pinAdcBateria < 0) return _ultimoVoltajeMedido_V; // sin pin: devolver ultimo
-     uint32_t acumuladorAdc = 0;
-     uint8_t nMuestras = max((uint8_t)1, _configuracion.muestrasPromedioAdc);
-     for (uint8_t i = 0; i < nMuestras; ++i) {
-       acumuladorAdc += analogRead(_configuracion.pinAdcBateria);
-       delayMicroseconds(250);
-     }
-     float promedioCuentasAdc = (float)acumuladorAdc / nMuestras;
-     float voltajeAdc_V = (promedioCuentasAdc / 1023.0f) * _configuracion.voltajeReferenciaAdc;
-     float factorDivisor = (_configuracion.divisorRArriba_k + _configuracion.divisorRAbajo_k)
-                           / _configuracion.divisorRAbajo_k; // Vin = Vadc * factor
-     return voltajeAdc_V * factorDivisor;
-   }
+   float readBatteryVolts() { return Sampler::read(_configuracion, _ultimoVoltajeMedido_V); }
  
    // --- Getters (Consultores de estado) ---
  
@@ -175,17 +164,33 @@
    bool    isCutoff()       const { return _bloqueadoPorCorte; }
  
    /**
-    * @brief Obtiene el período de transmisión actual basado en el nivel de energía.
+    * @brief Obtiene el período de transmisión actual basado en el nivel de energía
+    * (o el fijado con setPeriodOverride()).
+    * Incluye el multiplicador fijado con setPeriodMultiplier() y el
+    * estiramiento por la corriente de relevo (setRelayCurrentUa()).
     * @return uint32_t El período de envío actual en milisegundos.
     */
    uint32_t currentPeriod() const {
+     uint32_t periodo_ms;
      switch (_nivelEnergeticoActual) {
-       case BATT_HIGH: return _configuracion.periodoAlto_ms;
-       case BATT_MID:  return _configuracion.periodoMedio_ms;
-       default:        return _configuracion.periodoBajo_ms;
+       case BATT_HIGH: periodo_ms = _configuracion.periodoAlto_ms;  break;
+       case BATT_MID:  periodo_ms = _configuracion.periodoMedio_ms; break;
+       default:        periodo_ms = _configuracion.periodoBajo_ms;  break;
+     }
+     if (_periodoForzado_ms != 0) periodo_ms = _periodoForzado_ms;
+     if (_multiplicadorQ8 != 256) {
+       uint64_t escalado = ((uint64_t)periodo_ms * _multiplicadorQ8) >> 8;
+       periodo_ms = (escalado > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)escalado;
      }
+     return periodoConRelevo(periodo_ms);
    }
  
+   /**
+    * @brief Obtiene el multiplicador de período vigente.
+    * @return uint16_t Multiplicador en punto fijo Q8.8 (256 = 1.0).
+    */
+   uint16_t periodMultiplier() const { return _multiplicadorQ8; }
+ 
    // --- Setters (Modificadores de configuración en tiempo de ejecución) ---
  
    /**
@@ -208,53 +213,151 @@
    void setThresholds(float umbralAlto_V, float umbralMedio_V) {
      _configuracion.umbralAlto_V  = umbralAlto_V;
      _configuracion.umbralMedio_V = umbralMedio_V;
+     Classifier::begin(_configuracion);
    }
  
    /**
     * @brief Actualiza la fracción de histéresis en tiempo de ejecución.
     * @param fraccion Fracción (ej. 0.03 para 3%).
     */
-   void setHysteresisPct(float fraccion) { _configuracion.fraccionHisteresis = fraccion; }
+   void setHysteresisPct(float fraccion) {
+     _configuracion.fraccionHisteresis = fraccion;
+     Classifier::begin(_configuracion);
+   }
+ 
+   /**
+    * @brief Aplica un multiplicador sobre el período de cada nivel.
+    * Lo calcula el gateway para equilibrar la vida útil de la flota: los nodos
+    * con celdas débiles transmiten más lento y los fuertes más rápido.
+    *
+    * @param multiplicador_q8 Multiplicador en Q8.8 (256 = 1.0, 512 = 2.0, 128 = 0.5). 0 se trata como 1.0.
+    */
+   void setPeriodMultiplier(uint16_t multiplicador_q8) {
+     _multiplicadorQ8 = (multiplicador_q8 == 0) ? 256 : multiplicador_q8;
+   }
+ 
+   /**
+    * @brief Sustituye el período por nivel con el que elija una política externa
+    * (p. ej. QTablePolicy o VariabilityRate). El corte, el multiplicador y el
+    * relevo se siguen aplicando. Un período más corto que la espera pendiente
+    * entra en vigor de inmediato; uno más largo, desde el próximo envío.
+    *
+    * @param periodo_ms Período (ms); 0 vuelve a los períodos por nivel del `Cfg`.
+    */
+   void setPeriodOverride(uint32_t periodo_ms) {
+     _periodoForzado_ms = periodo_ms;
+     if (periodo_ms == 0) return;
+     Scheduler::pullIn(millis() + periodoCorregidoPorDeriva(currentPeriod()));
+   }
+
+   /**
+    * @brief Fija la deriva del reloj local respecto al gateway.
+    * El período programado en tick() se escala para que, medido con la hora
+    * del gateway, dure exactamente `currentPeriod()`. Normalmente se alimenta
+    * con DriftEstimator::driftPpm().
+    *
+    * @param deriva_ppm Deriva en ppm (positiva si el reloj local atrasa).
+    */
+   void setClockDriftPpm(int32_t deriva_ppm) { _derivaReloj_ppm = deriva_ppm; }
+ 
+   /**
+    * @brief Obtiene la deriva de reloj aplicada actualmente al temporizador.
+    * @return int32_t Deriva en ppm.
+    */
+   int32_t clockDriftPpm() const { return _derivaReloj_ppm; }
+
+   /**
+    * @brief Informa la corriente media que el nodo gasta como relevo (reenvío y escucha).
+    * Esa corriente sale del mismo presupuesto que el período del nivel asigna
+    * a los envíos propios (`cargaEnvio_uC / período`), así que el período
+    * propio se alarga para que el consumo total se mantenga, hasta
+    * `estiramientoRelevoMax`. Normalmente se alimenta con el libro de energía:
+    * `setRelayCurrentUa(ledger.relayCurrentUa(), ledger.sendChargeUc())`.
+    *
+    * @param corriente_uA Corriente de relevo en µA (0 = nodo hoja).
+    * @param cargaEnvio_uC Carga de un envío propio (EnergyLedger::sendChargeUc()).
+    */
+   void setRelayCurrentUa(uint16_t corriente_uA, uint32_t cargaEnvio_uC) {
+     _corrienteRelevo_uA = corriente_uA;
+     _cargaEnvio_uC      = cargaEnvio_uC;
+   }
+
+   /**
+    * @brief Obtiene la corriente de relevo aplicada al período.
+    * @return uint16_t µA.
+    */
+   uint16_t relayCurrentUa() const { return _corrienteRelevo_uA; }
+
+   /**
+    * @brief Acceso a la política de traza (p. ej. para leer el anillo de RingTrace
+    * o llamar a begin() de GpioTrace).
+    */
+   Trace&       tracer()       { return *this; }
+   const Trace& tracer() const { return *this; }
+
+   /**
+    * @brief Acceso a las políticas de etapa (p. ej. JitterScheduler::seed()).
+    */
+   Sampler&    sampler()    { return *this; }
+   Filter&     filter()     { return *this; }
+   Classifier& classifier() { return *this; }
+   Scheduler&  scheduler()  { return *this; }
  
  private:
    Cfg       _configuracion;          ///< Almacena la configuración de la instancia.
    Level     _nivelEnergeticoActual;  ///< Estado de energía actual del nodo.
-   uint32_t  _msProximoEnvio;         ///< Marca de tiempo (millis()) para el siguiente envío.
-   float     _ultimoVoltajeMedido_V;  ///< Caché de la última medición de voltaje.
+   float     _ultimoVoltajeMedido_V = 0.0f;  ///< Caché de la última medición de voltaje.
    bool      _bloqueadoPorCorte;      ///< Flag que indica si se alcanzó el corte por bajo voltaje.
  
-   bool      _usarLecturaInyectada;   ///< Flag para usar el voltaje inyectado vs. el ADC.
-   float     _voltajeInyectado_V;     ///< Valor del voltaje inyectado manualmente.
+   // Sin inicializar, una instancia en la pila o el heap (no global) podía
+   // usar un voltaje inyectado basura en lugar de leer el ADC
+   bool      _usarLecturaInyectada = false;  ///< Flag para usar el voltaje inyectado vs. el ADC.
+   float     _voltajeInyectado_V   = 0.0f;   ///< Valor del voltaje inyectado manualmente.
+   int32_t   _derivaReloj_ppm;        ///< Deriva del reloj local usada para corregir el período.
+   uint16_t  _multiplicadorQ8;        ///< Multiplicador de período (Q8.8) fijado por el gateway.
+   uint16_t  _corrienteRelevo_uA;     ///< Corriente gastada en reenvío y escucha.
+   uint32_t  _cargaEnvio_uC;          ///< Carga de un envío propio, informada junto con la de relevo.
+   uint32_t  _periodoForzado_ms;      ///< Período de una política externa (0 = por nivel).
  
    /**
-    * @brief Función interna para actualizar el estado de energía (`_nivelEnergeticoActual`).
-    * Aplica la lógica de histéresis para evitar cambios rápidos de estado
-    * (rebotes) cuando el voltaje está cerca de un umbral.
+    * @brief Convierte un período en tiempo del gateway a milisegundos locales.
+    * local = periodo / (1 + deriva) ~ periodo * (1 - deriva), en aritmética entera.
     *
-    * @param voltajeBateria_V El voltaje de la batería medido actualmente.
+    * @param periodo_ms Período deseado (ms) medido con el reloj del gateway.
+    * @return uint32_t Período equivalente (ms) medido con millis().
     */
-   void actualizarNivelConHisteresis(float voltajeBateria_V) {
-     // diferencials de histéresis alrededor de los umbrales
-     float diferencialAlto_V  = _configuracion.umbralAlto_V  * _configuracion.fraccionHisteresis;
-     float diferencialMedio_V = _configuracion.umbralMedio_V * _configuracion.fraccionHisteresis;
- 
-     switch (_nivelEnergeticoActual) {
-       case BATT_HIGH: // ALTO -> MEDIO si baja por debajo de (alto - diferencial)
-         if (voltajeBateria_V < (_configuracion.umbralAlto_V - diferencialAlto_V))
-           _nivelEnergeticoActual = BATT_MID;
-         break;
- 
-       case BATT_MID:
-         // MEDIO -> ALTO si supera (alto + diferencial)
-         if (voltajeBateria_V >= (_configuracion.umbralAlto_V + diferencialAlto_V)) { _nivelEnergeticoActual = BATT_HIGH; break; }
-         // MEDIO -> BAJO si baja por debajo de (medio - diferencial)
-         if (voltajeBateria_V <  (_configuracion.umbralMedio_V - diferencialMedio_V)) { _nivelEnergeticoActual = BATT_LOW;  break; }
-         break;
+   uint32_t periodoCorregidoPorDeriva(uint32_t periodo_ms) const {
+     if (_derivaReloj_ppm == 0) return periodo_ms;
+     int64_t ajuste = ((int64_t)periodo_ms * _derivaReloj_ppm) / 1000000L;
+     return (uint32_t)((int64_t)periodo_ms - ajuste);
+   }
  
-       case BATT_LOW: // BAJO -> MEDIO si supera (medio + diferencial)
-         if (voltajeBateria_V >= (_configuracion.umbralMedio_V + diferencialMedio_V))
-           _nivelEnergeticoActual = BATT_MID;
-         break;
-     }
+   /** @brief Voltaje en mV saturado a 16 bits (dato de los ganchos de traza). */
+   static uint16_t milivoltios(float voltaje_V) {
+     const float mV = voltaje_V * 1000.0f + 0.5f;
+     return (mV <= 0.0f) ? 0 : (mV >= 65535.0f) ? 65535 : (uint16_t)mV;
    }
- };
\ No newline at end of file
+
+   /**
+    * @brief Alarga el período propio para pagar la corriente de relevo.
+    * Presupuesto del nivel B = Q / p (Q = carga de un envío). Con relevo R el envío
+    * propio dispone de B - R, es decir p' = p * B / (B - R) = p * Q / (Q - R * p),
+    * acotado a `estiramientoRelevoMax * p`.
+    *
+    * @param periodo_ms Período del nivel (ya multiplicado).
+    * @return uint32_t Período propio (ms).
+    */
+   uint32_t periodoConRelevo(uint32_t periodo_ms) const {
+     if (_corrienteRelevo_uA == 0 || _cargaEnvio_uC == 0) return periodo_ms;
+     const uint8_t  tope   = _configuracion.estiramientoRelevoMax ? _configuracion.estiramientoRelevoMax : 1;
+     const uint64_t maximo = (uint64_t)periodo_ms * tope;
+     const int64_t  q_nC   = (int64_t)_cargaEnvio_uC * 1000;                  // µC -> nC (µA * ms)
+     const int64_t  resto  = q_nC - (int64_t)_corrienteRelevo_uA * periodo_ms;
+     uint64_t p = (resto <= 0) ? maximo : ((uint64_t)periodo_ms * (uint64_t)q_nC) / (uint64_t)resto;
+     if (p > maximo) p = maximo;
+     return (p > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)p;
+   }
+ };
+
+ /// Temporizador adaptativo sin traza y con las etapas por defecto (el uso habitual).
+ typedef BasicAdaptiveTXWSN<> AdaptiveTXWSN;
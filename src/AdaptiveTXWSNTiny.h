@@ -0,0 +1,160 @@
+/**
+ * @file AdaptiveTXWSNTiny.h
+ * @brief Define AdaptiveTXWSNTiny: edición compacta de AdaptiveTXWSN para
+ * ATtiny85/ATtiny412 y otros MCU con poca RAM y flash.
+ * La configuración es constexpr (parámetro de plantilla, queda en flash como
+ * inmediatos), el estado ocupa 7 bytes empaquetados y toda la aritmética es
+ * entera en mV. Conserva los tres niveles con histéresis y el corte duro;
+ * no incluye corrección de deriva, multiplicador, relevo, período forzado ni
+ * políticas de traza.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "AdaptiveTXWSNTypes.h"
+
+/**
+ * @struct TinyCfg
+ * @brief Configuración por defecto (mismos valores que AdaptiveTXWSN::Cfg).
+ * Para cambiarla, derivar y redefinir sólo lo necesario:
+ * @code
+ *   struct MiCfg : TinyCfg {
+ *     static constexpr int8_t   PIN_ADC  = A1;
+ *     static constexpr uint16_t CORTE_mV = 3300;
+ *   };
+ *   AdaptiveTXWSNTiny<MiCfg> txTimer;
+ * @endcode
+ */
+struct TinyCfg {
+  // --- Lectura de bateria ---
+  static constexpr int8_t   PIN_ADC          = -1;     ///< Pin ADC; -1 si se inyecta con setBatteryMillivolts().
+  static constexpr uint16_t REF_ADC_mV       = 5000;   ///< Referencia del ADC (10 bits).
+  static constexpr uint32_t DIVISOR_ARRIBA_R = 100000; ///< Resistencia superior del divisor (Ω).
+  static constexpr uint32_t DIVISOR_ABAJO_R  = 33000;  ///< Resistencia inferior del divisor (Ω).
+  static constexpr uint8_t  MUESTRAS_ADC     = 8;      ///< Lecturas promediadas por medición.
+
+  // --- Umbrales (mV) ---
+  static constexpr uint16_t ALTO_mV          = 3900;   ///< Por encima: nivel ALTO.
+  static constexpr uint16_t MEDIO_mV         = 3600;   ///< Por encima (y debajo de ALTO): nivel MEDIO.
+  static constexpr uint16_t HISTERESIS_PM    = 30;     ///< Histéresis en milésimas del umbral (30 = 3 %).
+  static constexpr uint16_t CORTE_mV         = 3400;   ///< Por debajo no se transmite.
+
+  // --- Periodos de envio (ms) por nivel ---
+  static constexpr uint32_t PERIODO_ALTO_ms  = 5000;
+  static constexpr uint32_t PERIODO_MEDIO_ms = 15000;
+  static constexpr uint32_t PERIODO_BAJO_ms  = 120000;
+};
+
+/**
+ * @class AdaptiveTXWSNTiny
+ * @brief Temporizador adaptativo con la interfaz esencial de AdaptiveTXWSN.
+ * @tparam C Configuración (TinyCfg o una derivada).
+ */
+template <class C = TinyCfg>
+class AdaptiveTXWSNTiny {
+  static_assert(C::MUESTRAS_ADC >= 1, "AdaptiveTXWSNTiny: al menos una lectura ADC");
+  static_assert(C::DIVISOR_ABAJO_R > 0, "AdaptiveTXWSNTiny: divisor inferior nulo");
+  static_assert(C::MEDIO_mV < C::ALTO_mV, "AdaptiveTXWSNTiny: umbral medio por encima del alto");
+
+public:
+  typedef AdaptiveTXWSNTypes::Level Level;
+
+  /**
+   * @brief Inicializa el estado (el primer tick() mide y envía).
+   */
+  void begin() {
+    if (C::PIN_ADC >= 0) pinMode(C::PIN_ADC, INPUT);
+    _nivel     = AdaptiveTXWSNTypes::BATT_HIGH;
+    _corte     = 0;
+    _inyectado = 0;
+    _mV        = 0;
+    _proximo   = millis();
+  }
+
+  /**
+   * @brief Llamar en cada loop().
+   * @return true Si es momento de transmitir.
+   */
+  bool tick() {
+    if (!_inyectado && C::PIN_ADC >= 0) _mV = readBatteryMillivolts();
+    if (_mV < C::CORTE_mV) {
+      _corte = 1;
+      return false;
+    }
+    _corte = 0;
+    actualizarNivel();
+    const uint32_t ahora = millis();
+    if ((int32_t)(ahora - _proximo) >= 0) {
+      _proximo = ahora + currentPeriod();
+      return true;
+    }
+    return false;
+  }
+
+  /** @brief Inyecta el voltaje (mV) medido por otro medio; desde entonces no se lee el ADC. */
+  void setBatteryMillivolts(uint16_t mV) {
+    _mV = mV;
+    _inyectado = 1;
+  }
+
+  /** @brief Promedia MUESTRAS_ADC lecturas y convierte a mV con un factor constexpr. */
+  uint16_t readBatteryMillivolts() const {
+    uint32_t suma = 0;
+    for (uint8_t i = 0; i < C::MUESTRAS_ADC; ++i) {
+      suma += (uint16_t)analogRead(C::PIN_ADC);
+      delayMicroseconds(250);
+    }
+    return (uint16_t)((suma * FACTOR_Q16) >> 16);
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  Level    level()           const { return (Level)_nivel; }
+  bool     isCutoff()        const { return _corte; }
+  uint16_t lastMillivolts()  const { return _mV; }
+
+  /** @brief Período del nivel actual (ms). */
+  uint32_t currentPeriod() const {
+    switch (_nivel) {
+      case AdaptiveTXWSNTypes::BATT_HIGH: return C::PERIODO_ALTO_ms;
+      case AdaptiveTXWSNTypes::BATT_MID:  return C::PERIODO_MEDIO_ms;
+      default:                            return C::PERIODO_BAJO_ms;
+    }
+  }
+
+private:
+  // mV = suma de cuentas * REF * (Ra + Rb) / (1023 * Rb * n), en Q16
+  static constexpr uint32_t FACTOR_Q16 = (uint32_t)(((uint64_t)C::REF_ADC_mV * (C::DIVISOR_ARRIBA_R + C::DIVISOR_ABAJO_R) << 16)
+                                                    / (1023ULL * C::DIVISOR_ABAJO_R * C::MUESTRAS_ADC));
+  static_assert((uint64_t)FACTOR_Q16 * 1023ULL * C::MUESTRAS_ADC <= 0xFFFFFFFFULL,
+                "AdaptiveTXWSNTiny: el divisor da más de 65 V, fuera de rango");
+
+  static constexpr uint16_t ALTO_BAJA_mV  = C::ALTO_mV  - (uint16_t)((uint32_t)C::ALTO_mV  * C::HISTERESIS_PM / 1000);
+  static constexpr uint16_t ALTO_SUBE_mV  = C::ALTO_mV  + (uint16_t)((uint32_t)C::ALTO_mV  * C::HISTERESIS_PM / 1000);
+  static constexpr uint16_t MEDIO_BAJA_mV = C::MEDIO_mV - (uint16_t)((uint32_t)C::MEDIO_mV * C::HISTERESIS_PM / 1000);
+  static constexpr uint16_t MEDIO_SUBE_mV = C::MEDIO_mV + (uint16_t)((uint32_t)C::MEDIO_mV * C::HISTERESIS_PM / 1000);
+
+  uint32_t _proximo       = 0; ///< millis() del próximo envío.
+  uint16_t _mV            = 0; ///< Última medición.
+  uint8_t  _nivel     : 2;     ///< Level.
+  uint8_t  _corte     : 1;     ///< isCutoff().
+  uint8_t  _inyectado : 1;     ///< setBatteryMillivolts() reemplaza al ADC.
+
+  /** Misma histéresis que HysteresisClassifier, en mV. */
+  void actualizarNivel() {
+    switch (_nivel) {
+      case AdaptiveTXWSNTypes::BATT_HIGH:
+        if (_mV < ALTO_BAJA_mV) _nivel = AdaptiveTXWSNTypes::BATT_MID;
+        break;
+      case AdaptiveTXWSNTypes::BATT_MID:
+        if (_mV >= ALTO_SUBE_mV)     _nivel = AdaptiveTXWSNTypes::BATT_HIGH;
+        else if (_mV < MEDIO_BAJA_mV) _nivel = AdaptiveTXWSNTypes::BATT_LOW;
+        break;
+      default:
+        if (_mV >= MEDIO_SUBE_mV) _nivel = AdaptiveTXWSNTypes::BATT_MID;
+        break;
+    }
+  }
+};
@@ -0,0 +1,59 @@
+/**
+ * @file AdaptiveTXWSNTypes.h
+ * @brief Configuración y niveles de AdaptiveTXWSN, separados para que las
+ * políticas de etapa (StagePolicies.h) puedan usarlos sin depender de la clase.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+ #pragma once
+ #include <Arduino.h>
+
+ /**
+  * @class AdaptiveTXWSNTypes
+  * @brief Tipos comunes a todas las variantes de BasicAdaptiveTXWSN (no dependen
+  * de las políticas), de modo que `AdaptiveTXWSN::Cfg` y `AdaptiveTXWSN::Level`
+  * sirven para cualquiera de ellas y para las políticas de etapa.
+  */
+ class AdaptiveTXWSNTypes {
+ public:
+   /**
+    * @struct Cfg
+    * @brief Estructura de configuración para la librería AdaptiveTXWSN.
+    * Contiene todos los pines, umbrales y períodos de operación.
+    */
+   struct Cfg {
+     // --- Lectura de bateria ---
+     int8_t  pinAdcBateria           = -1;     ///< Pin ADC para leer batería. -1 si se inyecta el voltaje manualmente.
+     float   voltajeReferenciaAdc    = 5.0f;   ///< Voltaje de referencia del ADC (5.0V, 3.3V, 1.1V, etc.).
+     float   divisorRArriba_k        = 100.0f; ///< Resistencia superior (kΩ) del divisor de voltaje (Vin -> R_arriba -> ADC).
+     float   divisorRAbajo_k         =  33.0f; ///< Resistencia inferior (kΩ) del divisor de voltaje (ADC -> R_abajo -> GND).
+     uint8_t muestrasPromedioAdc     = 8;      ///< Número de muestras a promediar para estabilizar la lectura de VBAT.
+                                               ///< Si no se usan resistencias, añadir 0 y 1 para evitar división por cero.
+     // --- Umbrales (VOLTIOS) ---
+     float umbralAlto_V              = 3.90f;  ///< Voltaje por encima del cual se considera nivel ALTO.
+     float umbralMedio_V             = 3.60f;  ///< Voltaje por encima del cual se considera nivel MEDIO (y por debajo de ALTO).
+     float fraccionHisteresis        = 0.03f;  ///< Fracción (ej. 0.03 = 3%) de histéresis para evitar rebotes de nivel.
+ 
+     // --- Periodos de envio (ms) por nivel ---
+     uint32_t periodoAlto_ms         = 5000;   ///< Período de transmisión (ms) cuando el nivel es ALTO.
+     uint32_t periodoMedio_ms        = 15000;  ///< Período de transmisión (ms) cuando el nivel es MEDIO.
+     uint32_t periodoBajo_ms         = 120000; ///< Período de transmisión (ms) cuando el nivel es BAJO.
+ 
+     // --- Corte duro: por debajo NO se transmite ---
+     float corteVoltaje_V            = 3.40f;  ///< Voltaje por debajo del cual el nodo deja de transmitir (isCutoff() = true).
+
+     // --- Relevo: el reenvío se descuenta del presupuesto de envíos propios ---
+     uint8_t  estiramientoRelevoMax  = 8;      ///< Máximo factor en que el relevo puede alargar el período propio.
+   };
+ 
+   /**
+    * @enum Level
+    * @brief Define los niveles de energía discretos del nodo.
+    */
+   enum Level : uint8_t {
+     BATT_LOW=0,  ///< Nivel de energía bajo. Período de transmisión largo.
+     BATT_MID=1,  ///< Nivel de energía medio. Período de transmisión normal.
+     BATT_HIGH=2  ///< Nivel de energía alto. Período de transmisión corto.
+   };
+ };
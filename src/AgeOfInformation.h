@@ -0,0 +1,113 @@
+/**
+ * @file AgeOfInformation.h
+ * @brief Define la clase AgeOfInformation: edad de la información (AoI) del lado del consumidor.
+ * La edad en un instante es el tiempo transcurrido desde que se generó la
+ * última actualización que llegó al gateway. El nodo la sigue a partir de
+ * los acuses de recibo: cada entrega la baja a su retardo y entre entregas
+ * crece linealmente (diente de sierra). Se integra de forma exacta, así que
+ * el promedio no depende de cada cuánto se consulte.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @class AgeOfInformation
+ * @brief Edad instantánea, promedio en el tiempo y picos (edad justo antes de cada entrega).
+ *
+ * Uso típico:
+ * @code
+ *   uint32_t generado = millis();          // instante de la muestra
+ *   if (radio.sendWithAck(...)) aoi.onDelivered(millis(), generado);
+ * @endcode
+ */
+class AgeOfInformation {
+public:
+  /**
+   * @brief Reinicia la contabilidad. Se toma `ahora_ms` como instante de la
+   * última información (edad 0 al arrancar).
+   * @param ahora_ms millis().
+   */
+  void begin(uint32_t ahora_ms) {
+    _transcurrido_ms = 0;
+    _corte_ms       = ahora_ms;
+    _generado_ms    = ahora_ms;
+    _area_ms2       = 0;
+    _sumaPicos_ms   = 0;
+    _entregas       = 0;
+    _ultimoPico_ms  = 0;
+    _picoMaximo_ms  = 0;
+  }
+
+  /**
+   * @brief Registra una actualización entregada (con acuse).
+   * Una entrega más vieja que la información vigente (p. ej. un reintento
+   * tardío) no baja la edad y no cuenta como pico.
+   * @param ahora_ms Instante de la entrega.
+   * @param generado_ms Instante en que se generó la actualización entregada.
+   */
+  void onDelivered(uint32_t ahora_ms, uint32_t generado_ms) {
+    acumular(ahora_ms);
+    if ((int32_t)(generado_ms - _generado_ms) <= 0) return;
+    const uint32_t pico = ahora_ms - _generado_ms;
+    _ultimoPico_ms = pico;
+    if (pico > _picoMaximo_ms) _picoMaximo_ms = pico;
+    _sumaPicos_ms += pico;
+    _entregas++;
+    _generado_ms = generado_ms;
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /** @brief Edad instantánea (ms). */
+  uint32_t ageMs(uint32_t ahora_ms) const { return ahora_ms - _generado_ms; }
+
+  /**
+   * @brief Edad promedio en el tiempo desde begin() (ms).
+   * El tiempo transcurrido se lleva en 64 bits, así que el promedio sigue
+   * siendo válido después de que millis() da la vuelta (49.7 días).
+   * @param ahora_ms Instante de la consulta (incluye el tramo aún abierto).
+   */
+  uint32_t averageAgeMs(uint32_t ahora_ms) const {
+    const uint64_t total = _transcurrido_ms + (uint32_t)(ahora_ms - _corte_ms);
+    if (total == 0) return 0;
+    return (uint32_t)((_area_ms2 + areaTramo(_corte_ms, ahora_ms)) / total);
+  }
+
+  /** @brief Edad justo antes de la última entrega (ms). */
+  uint32_t lastPeakAgeMs() const { return _ultimoPico_ms; }
+
+  /** @brief Promedio de los picos de edad (ms); 0 sin entregas. */
+  uint32_t averagePeakAgeMs() const { return _entregas ? (uint32_t)(_sumaPicos_ms / _entregas) : 0; }
+
+  /** @brief Mayor pico de edad observado (ms). */
+  uint32_t maxPeakAgeMs() const { return _picoMaximo_ms; }
+
+  /** @brief Actualizaciones entregadas que bajaron la edad. */
+  uint32_t deliveries() const { return _entregas; }
+
+private:
+  uint64_t _transcurrido_ms = 0; ///< Tiempo integrado desde begin().
+  uint32_t _corte_ms      = 0; ///< Hasta dónde está integrada el área.
+  uint32_t _generado_ms   = 0; ///< Generación de la información vigente.
+  uint64_t _area_ms2      = 0; ///< Integral de la edad (ms * ms).
+  uint64_t _sumaPicos_ms  = 0;
+  uint32_t _entregas      = 0;
+  uint32_t _ultimoPico_ms = 0;
+  uint32_t _picoMaximo_ms = 0;
+
+  /** Área bajo el diente de sierra entre a y b con la información vigente. */
+  uint64_t areaTramo(uint32_t a, uint32_t b) const {
+    const uint64_t dt = b - a;
+    const uint64_t edadA = a - _generado_ms;
+    return dt * (2 * edadA + dt) / 2;
+  }
+
+  void acumular(uint32_t ahora_ms) {
+    _area_ms2 += areaTramo(_corte_ms, ahora_ms);
+    _transcurrido_ms += (uint32_t)(ahora_ms - _corte_ms);
+    _corte_ms = ahora_ms;
+  }
+};
@@ -0,0 +1,142 @@
+/**
+ * @file AoIScheduler.h
+ * @brief Define la clase AoIScheduler: modo de envío que minimiza la edad de la información.
+ * En lugar de transmitir cada `currentPeriod()` pase lo que pase, el nodo
+ * transmite cuando la edad en el gateway supera un umbral, gastando el mismo
+ * presupuesto de energía. El presupuesto lo fija el estado de la batería
+ * (el período de AdaptiveTXWSN: un envío por período) y se lleva como
+ * créditos; un envío fallido no baja la edad, así que el siguiente intento
+ * llega antes que con período fijo y se paga alargando los siguientes.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "AgeOfInformation.h"
+
+/**
+ * @class AoIScheduler
+ * @brief Política de umbral sobre la edad con cubeta de créditos de energía.
+ *
+ * El beneficio de enviar ahora es proporcional a la edad actual (es lo que
+ * baja el área del diente de sierra); el costo es un crédito, cuyo precio
+ * sube a medida que la cubeta se vacía. Eso da un umbral de edad
+ * θ = P * (D + 1 - c) / (D/2 + 1), con P el período del presupuesto, D la
+ * profundidad y c los créditos: con la cubeta a medias θ = P, llena θ < P
+ * (el presupuesto sobra) y casi vacía θ > P. En régimen y sin pérdidas se
+ * comporta como el período fijo.
+ *
+ * Uso típico, en cada loop():
+ * @code
+ *   txTimer.tick();                                   // nivel y corte
+ *   if (!txTimer.isCutoff() && aoi.shouldSend(millis(), txTimer.currentPeriod())) {
+ *     uint32_t generado = millis();
+ *     if (radio.sendWithAck(...)) aoi.onDelivered(millis(), generado);
+ *   }
+ * @endcode
+ */
+class AoIScheduler {
+public:
+  /**
+   * @struct Cfg
+   * @brief Parámetros del modo AoI.
+   */
+  struct Cfg {
+    uint8_t  profundidad         = 4;    ///< Créditos máximos (envíos que se pueden adelantar).
+    uint32_t separacionMinima_ms = 1000; ///< Tiempo mínimo entre intentos (ráfagas de pérdidas).
+  };
+
+  /**
+   * @brief Inicializa el modo con la cubeta a medias.
+   * @param cfg Parámetros.
+   * @param ahora_ms millis().
+   */
+  void begin(const Cfg& cfg, uint32_t ahora_ms) {
+    _cfg = cfg;
+    if (_cfg.profundidad < 2) _cfg.profundidad = 2;
+    _creditos_q16 = (uint32_t)(_cfg.profundidad / 2) << 16;
+    _ultimo_ms = ahora_ms;
+    _resto = 0;
+    _ultimoIntento_ms = ahora_ms - _cfg.separacionMinima_ms;
+    _sinAcuse = false;
+    _fallos = 0;
+    _aoi.begin(ahora_ms);
+  }
+
+  /**
+   * @brief Decide si transmitir ahora. Si devuelve true descuenta un crédito.
+   * @param ahora_ms millis().
+   * @param presupuesto_ms Período que fija el presupuesto de energía (AdaptiveTXWSN::currentPeriod()).
+   * @return true Si la edad justifica gastar un envío.
+   */
+  bool shouldSend(uint32_t ahora_ms, uint32_t presupuesto_ms) {
+    acreditar(ahora_ms, presupuesto_ms);
+    if (_creditos_q16 < 65536UL) return false;
+    const uint32_t umbral = thresholdMs(presupuesto_ms);
+    if (_aoi.ageMs(ahora_ms) < umbral) return false;
+    // Tras intentos sin acuse la separación se duplica (hasta el umbral): en una
+    // ráfaga de pérdidas reintentar de inmediato sólo quema créditos. Se
+    // desplaza en 64 bits: con separaciones de más de 65 s y 16 fallos el
+    // corrimiento no cabe en 32 y daría una separación cercana a cero.
+    const uint64_t separacion64 = (uint64_t)_cfg.separacionMinima_ms << _fallos;
+    const uint32_t separacion = (separacion64 > umbral) ? umbral : (uint32_t)separacion64;
+    if (ahora_ms - _ultimoIntento_ms < separacion) return false;
+    if (_sinAcuse && _fallos < 16) _fallos++;
+    _creditos_q16 -= 65536UL;
+    _ultimoIntento_ms = ahora_ms;
+    _sinAcuse = true;
+    return true;
+  }
+
+  /**
+   * @brief Registra una entrega con acuse (ver AgeOfInformation::onDelivered()).
+   */
+  void onDelivered(uint32_t ahora_ms, uint32_t generado_ms) {
+    _aoi.onDelivered(ahora_ms, generado_ms);
+    _sinAcuse = false;
+    _fallos = 0;
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /**
+   * @brief Umbral de edad vigente para un presupuesto.
+   * @param presupuesto_ms Período del presupuesto (ms).
+   * @return uint32_t Edad (ms) a partir de la cual conviene enviar.
+   */
+  uint32_t thresholdMs(uint32_t presupuesto_ms) const {
+    const uint32_t d = _cfg.profundidad;
+    const uint64_t num = ((uint64_t)(d + 1) << 16) - _creditos_q16;
+    return (uint32_t)(((uint64_t)presupuesto_ms * num) / ((uint64_t)(d / 2 + 1) << 16));
+  }
+
+  /** @brief Créditos disponibles en Q8.8. */
+  uint16_t creditsQ8() const { return (uint16_t)(_creditos_q16 >> 8); }
+
+  /** @brief Contabilidad de la edad de la información. */
+  const AgeOfInformation& aoi() const { return _aoi; }
+
+private:
+  Cfg              _cfg;
+  AgeOfInformation _aoi;
+  uint32_t         _creditos_q16     = 0; ///< Envíos pagados por adelantado, Q16.16.
+  uint32_t         _ultimo_ms        = 0; ///< Última acreditación.
+  uint32_t         _resto            = 0; ///< Resto de la división (loop() rápido con presupuesto largo).
+  uint32_t         _ultimoIntento_ms = 0;
+  bool             _sinAcuse         = false; ///< El último intento no tuvo acuse (aún).
+  uint8_t          _fallos           = 0;     ///< Intentos seguidos sin acuse.
+
+  /** Ingresa 1 crédito por `presupuesto_ms` transcurrido, hasta la profundidad. */
+  void acreditar(uint32_t ahora_ms, uint32_t presupuesto_ms) {
+    const uint32_t dt = ahora_ms - _ultimo_ms;
+    _ultimo_ms = ahora_ms;
+    if (presupuesto_ms == 0) presupuesto_ms = 1;
+    const uint64_t tope = (uint64_t)_cfg.profundidad << 16;
+    const uint64_t num = ((uint64_t)dt << 16) + _resto;
+    _resto = (uint32_t)(num % presupuesto_ms);
+    uint64_t c = _creditos_q16 + num / presupuesto_ms;
+    if (c >= tope) _resto = 0;
+    _creditos_q16 = (uint32_t)((c > tope) ? tope : c);
+  }
+};
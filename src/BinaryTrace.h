@@ -0,0 +1,307 @@
+/**
+ * @file BinaryTrace.h
+ * @brief Define BinaryTrace: política de traza para BasicAdaptiveTXWSN que
+ * guarda los eventos de tick() en un anillo binario compacto (5 bytes por
+ * registro) en RAM o FRAM, volcable por el puerto serie a pedido.
+ * Reemplaza a los `Serial.print` de diagnóstico: registrar un evento no
+ * bloquea el loop() y el volcado sólo ocurre cuando la aplicación lo pide.
+ * El decodificador del host (`extras/host/sim/TraceDecode.h`) reconstruye la
+ * línea de tiempo y la reproduce con el motor Replay.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "TracePolicies.h"
+
+/**
+ * @struct BinaryTraceFormat
+ * @brief Constantes del formato, compartidas con el decodificador del host.
+ *
+ * Registro (5 bytes): [evento:4 | escala:4] [delta:16 LE] [dato:16 LE].
+ * El tiempo desde el registro anterior es `delta << escala` ms; la escala es
+ * la menor que hace entrar delta en 16 bits, de modo que los intervalos
+ * cortos quedan exactos y los largos (hasta ~24 días) pierden a lo sumo
+ * 2^escala ms. El error no se acumula: cada delta se mide contra el instante
+ * reconstruido del registro anterior, no contra su millis() real.
+ *
+ * Volcado: "ATXB", versión, n (uint16 LE), t0 (uint32 LE, instante anterior
+ * al registro más viejo), n registros del más viejo al más nuevo y
+ * Fletcher-16 (uint16 LE) de todo lo que sigue a la marca.
+ *
+ * Memoria: "AT", MEMORIA y dos ranuras de cabecera [sec][pos:2][n:2][t0:4]
+ * [crc8] que se escriben alternadas; begin() toma la válida de secuencia
+ * más nueva, así que un corte de energía a mitad de una escritura deja la
+ * anterior intacta. Siguen los N registros.
+ */
+struct BinaryTraceFormat {
+  static constexpr uint8_t  VERSION   = 1;    ///< Versión del volcado.
+  static constexpr uint8_t  MEMORIA   = 2;    ///< Versión de la cabecera en memoria.
+  static constexpr uint8_t  REGISTRO  = 5;    ///< Bytes por registro.
+  static constexpr uint8_t  RANURA    = 10;   ///< Bytes de cada copia de la cabecera.
+  static constexpr uint16_t CABECERA  = 3 + 2 * RANURA; ///< Bytes de estado al inicio de la memoria.
+  static constexpr uint8_t  REINICIO  = 0x0F; ///< Evento propio: begin() retomó un anillo tras un reinicio.
+  static constexpr uint8_t  ESCALA_MAX = 15;
+
+  /** @brief Bytes de memoria que ocupa un anillo de n registros. */
+  static constexpr uint32_t bytes(uint16_t n) { return CABECERA + (uint32_t)n * REGISTRO; }
+};
+
+/**
+ * @class TraceRam
+ * @brief Memoria por defecto de BinaryTrace: un arreglo en RAM.
+ *
+ * Otra memoria (FRAM I2C/SPI, RAM con respaldo) sólo necesita los mismos dos
+ * métodos. Con una FRAM el anillo sobrevive a los reinicios:
+ * @code
+ *   struct MemoriaFram {
+ *     Adafruit_FRAM_I2C fram;
+ *     uint8_t read(uint16_t dir)            { return fram.read8(dir); }
+ *     void    write(uint16_t dir, uint8_t b) { fram.write8(dir, b); }
+ *   };
+ *   BasicAdaptiveTXWSN<BinaryTrace<1024, MemoriaFram>> txTimer;
+ * @endcode
+ * @tparam BYTES Tamaño del arreglo.
+ */
+template <uint32_t BYTES>
+class TraceRam {
+public:
+  uint8_t read(uint16_t dir) const      { return _datos[dir]; }
+  void    write(uint16_t dir, uint8_t b) { _datos[dir] = b; }
+
+private:
+  uint8_t _datos[BYTES] = {};
+};
+
+/**
+ * @class BinaryTrace
+ * @brief Anillo de eventos de tick() con marca de tiempo delta.
+ *
+ * Se registran las mediciones de batería (sólo si cambian al menos
+ * `setSampleBand()` mV respecto de la última registrada), los cambios de
+ * nivel (precedidos por el voltaje que cruzó el umbral), las entradas y
+ * salidas del corte y los envíos debidos. Los ganchos de inicio de medición y
+ * de clasificación no se registran: la clasificación se deduce del voltaje y
+ * ocuparía un registro por tick.
+ *
+ * El estado del anillo (posición, cantidad, instante inicial) se guarda en la
+ * cabecera de la memoria en cada registro, así que con una memoria no
+ * volátil begin() lo retoma tras un reinicio. El registro se escribe antes
+ * que la cabecera que lo incluye y, con el anillo lleno, antes de pisar el
+ * más viejo se guarda una cabecera que ya lo excluye: un corte en cualquier
+ * punto deja una cabecera que sólo describe registros completos.
+ *
+ * Uso típico:
+ * @code
+ *   BasicAdaptiveTXWSN<BinaryTrace<128>> txTimer;
+ *   // setup():  txTimer.tracer().begin();  txTimer.begin(cfg);
+ *   // loop():   if (Serial.available() && Serial.read() == 'T') txTimer.tracer().dump(Serial);
+ * @endcode
+ *
+ * @tparam N Registros del anillo.
+ * @tparam Memoria Almacenamiento con `read(uint16_t)` y `write(uint16_t, uint8_t)`.
+ */
+template <uint16_t N = 128, class Memoria = TraceRam<BinaryTraceFormat::bytes(N)>>
+class BinaryTrace {
+  static_assert(N >= 1, "BinaryTrace: el anillo necesita al menos un registro");
+  static_assert(BinaryTraceFormat::bytes(N) <= 0x10000UL, "BinaryTrace: direcciones de 16 bits");
+
+public:
+  /**
+   * @brief Inicializa el anillo.
+   * @param conservar Si la memoria ya tiene un anillo válido (FRAM tras un
+   *        reinicio) lo retoma y agrega un registro REINICIO; si no, lo vacía.
+   */
+  void begin(bool conservar = true) {
+    const uint32_t ahora = millis();
+    const int8_t ranura = conservar ? ranuraVigente() : -1;
+    if (ranura >= 0) {
+      const uint16_t dir = (uint16_t)(3 + ranura * BinaryTraceFormat::RANURA);
+      _sec    = _memoria.read(dir);
+      _pos    = leer16((uint16_t)(dir + 1));
+      _n      = leer16((uint16_t)(dir + 3));
+      _t0_ms  = leer32((uint16_t)(dir + 5));
+      _ult_ms = ahora; // delta 0 y los siguientes se miden con el millis() de este arranque
+      registrar(BinaryTraceFormat::REINICIO, 0);
+    } else {
+      clear();
+    }
+    _ultimoMv = 0;
+  }
+
+  /** @brief Vacía el anillo. */
+  void clear() {
+    _pos = 0;
+    _n = 0;
+    _ult_ms = millis();
+    _t0_ms = _ult_ms;
+    _memoria.write(0, 'A');
+    _memoria.write(1, 'T');
+    _memoria.write(2, BinaryTraceFormat::MEMORIA);
+    guardarCabecera(); // las dos ranuras, para no retomar una vieja
+    guardarCabecera();
+  }
+
+  /**
+   * @brief Cambio mínimo de voltaje (mV) para registrar una medición.
+   * 0 registra todas las mediciones que difieren de la anterior.
+   */
+  void setSampleBand(uint16_t banda_mV) { _banda_mV = banda_mV; }
+
+  /**
+   * @brief Escribe el anillo en formato de volcado.
+   * @param salida Cualquier objeto con `write(uint8_t)` (p. ej. `Serial`).
+   */
+  template <class Salida>
+  void dump(Salida& salida) {
+    uint8_t s1 = 0, s2 = 0;
+    auto emitir = [&](uint8_t b) {
+      salida.write(b);
+      s1 = (uint8_t)((s1 + b) % 255);
+      s2 = (uint8_t)((s2 + s1) % 255);
+    };
+    salida.write((uint8_t)'A');
+    salida.write((uint8_t)'T');
+    salida.write((uint8_t)'X');
+    salida.write((uint8_t)'B');
+    emitir(BinaryTraceFormat::VERSION);
+    emitir((uint8_t)_n);
+    emitir((uint8_t)(_n >> 8));
+    for (uint8_t i = 0; i < 4; ++i) emitir((uint8_t)(_t0_ms >> (8 * i)));
+    uint16_t p = (uint16_t)((_pos + N - _n) % N);
+    for (uint16_t i = 0; i < _n; ++i) {
+      const uint16_t dir = direccion(p);
+      for (uint8_t k = 0; k < BinaryTraceFormat::REGISTRO; ++k) emitir(_memoria.read((uint16_t)(dir + k)));
+      p = (uint16_t)((p + 1) % N);
+    }
+    salida.write(s1);
+    salida.write(s2);
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /** @brief Registros guardados (hasta N). */
+  uint16_t size() const { return _n; }
+
+  /** @brief Bytes que ocupa un volcado del anillo actual. */
+  uint32_t dumpBytes() const { return 13UL + (uint32_t)_n * BinaryTraceFormat::REGISTRO; }
+
+  /** @brief Acceso a la memoria (para inicializar una FRAM, por ejemplo). */
+  Memoria& memory() { return _memoria; }
+
+  // --- Ganchos de BasicAdaptiveTXWSN ---
+
+  void onSampleStart() {}
+  void onSampleEnd(uint16_t) {}
+  // Se registra la medición filtrada (la que se clasifica) con el evento
+  // TRAZA_MUESTRA_FIN, así Replay ve lo mismo que vio el nodo
+  void onFilterEnd(uint16_t mV) {
+    const uint16_t d = (mV > _ultimoMv) ? (uint16_t)(mV - _ultimoMv) : (uint16_t)(_ultimoMv - mV);
+    if (d == 0 || d < _banda_mV) return;
+    _ultimoMv = mV;
+    registrar(TRAZA_MUESTRA_FIN, mV);
+  }
+  void onClassify(uint8_t, uint16_t mV) { _clasificadoMv = mV; }
+  void onLevelChange(uint8_t anterior, uint8_t nuevo) {
+    // El voltaje que cruzó el umbral se registra aunque esté dentro de la banda
+    if (_clasificadoMv != _ultimoMv) {
+      _ultimoMv = _clasificadoMv;
+      registrar(TRAZA_MUESTRA_FIN, _clasificadoMv);
+    }
+    registrar(TRAZA_CAMBIO_NIVEL, (uint16_t)((anterior << 8) | nuevo));
+  }
+  void onCutoff(bool entra, uint16_t mV) { registrar(entra ? TRAZA_CORTE_ENTRADA : TRAZA_CORTE_SALIDA, mV); }
+  void onSendDue(uint32_t periodo_ms) {
+    const uint32_t s = periodo_ms / 1000;
+    registrar(TRAZA_ENVIO_DEBIDO, (uint16_t)((s > 0xFFFF) ? 0xFFFF : s));
+  }
+  void onTickEnd(bool) {}
+
+private:
+  Memoria  _memoria;
+  uint16_t _pos           = 0;  ///< Próximo registro a escribir.
+  uint16_t _n             = 0;
+  uint32_t _t0_ms         = 0;  ///< Instante reconstruido anterior al registro más viejo.
+  uint32_t _ult_ms        = 0;  ///< Instante reconstruido del registro más nuevo.
+  uint16_t _ultimoMv      = 0;  ///< Última medición registrada.
+  uint16_t _clasificadoMv = 0;  ///< Medición del tick() en curso.
+  uint16_t _banda_mV      = 4;
+  uint8_t  _sec           = 0;  ///< Secuencia de la última cabecera guardada.
+
+  static uint16_t direccion(uint16_t i) { return (uint16_t)(BinaryTraceFormat::CABECERA + i * BinaryTraceFormat::REGISTRO); }
+
+  void registrar(uint8_t evento, uint16_t dato) {
+    const uint32_t delta = millis() - _ult_ms;
+    uint8_t escala = 0;
+    while (escala < BinaryTraceFormat::ESCALA_MAX && (delta >> escala) > 0xFFFF) escala++;
+    const uint32_t unidades = ((delta >> escala) > 0xFFFF) ? 0xFFFF : (delta >> escala);
+
+    const uint16_t dir = direccion(_pos);
+    if (_n == N) {
+      // Se pisa el más viejo: t0 avanza su delta y la cabecera lo excluye
+      // antes de tocarlo
+      const uint8_t cab = _memoria.read(dir);
+      const uint32_t u = (uint32_t)_memoria.read((uint16_t)(dir + 1)) | ((uint32_t)_memoria.read((uint16_t)(dir + 2)) << 8);
+      _t0_ms += u << (cab >> 4);
+      _n--;
+      guardarCabecera();
+    }
+    _memoria.write(dir, (uint8_t)((escala << 4) | (evento & 0x0F)));
+    _memoria.write((uint16_t)(dir + 1), (uint8_t)unidades);
+    _memoria.write((uint16_t)(dir + 2), (uint8_t)(unidades >> 8));
+    _memoria.write((uint16_t)(dir + 3), (uint8_t)dato);
+    _memoria.write((uint16_t)(dir + 4), (uint8_t)(dato >> 8));
+    _ult_ms += unidades << escala;
+    _pos = (uint16_t)((_pos + 1) % N);
+    _n++;
+    guardarCabecera();
+  }
+
+  /** @brief Ranura de cabecera válida más nueva, o -1 si no hay anillo. */
+  int8_t ranuraVigente() {
+    if (_memoria.read(0) != 'A' || _memoria.read(1) != 'T' || _memoria.read(2) != BinaryTraceFormat::MEMORIA) return -1;
+    bool valida[2];
+    uint8_t sec[2];
+    for (uint8_t r = 0; r < 2; ++r) {
+      const uint16_t dir = (uint16_t)(3 + r * BinaryTraceFormat::RANURA);
+      sec[r] = _memoria.read(dir);
+      valida[r] = crc8(dir) == _memoria.read((uint16_t)(dir + BinaryTraceFormat::RANURA - 1))
+               && leer16((uint16_t)(dir + 1)) < N && leer16((uint16_t)(dir + 3)) <= N;
+    }
+    if (valida[0] && valida[1]) return ((int8_t)(sec[1] - sec[0]) > 0) ? 1 : 0;
+    return valida[0] ? 0 : valida[1] ? 1 : -1;
+  }
+
+  /** @brief Escribe el estado en la ranura que no tiene la última cabecera. */
+  void guardarCabecera() {
+    _sec++;
+    const uint16_t dir = (uint16_t)(3 + (_sec & 1) * BinaryTraceFormat::RANURA);
+    _memoria.write(dir, _sec);
+    escribir16((uint16_t)(dir + 1), _pos);
+    escribir16((uint16_t)(dir + 3), _n);
+    escribir32((uint16_t)(dir + 5), _t0_ms);
+    _memoria.write((uint16_t)(dir + BinaryTraceFormat::RANURA - 1), crc8(dir));
+  }
+
+  /** @brief CRC-8 (polinomio 0x07) de los bytes de una ranura sin su último byte. */
+  uint8_t crc8(uint16_t dir) {
+    uint8_t c = 0;
+    for (uint8_t i = 0; i < BinaryTraceFormat::RANURA - 1; ++i) {
+      c ^= _memoria.read((uint16_t)(dir + i));
+      for (uint8_t b = 0; b < 8; ++b) c = (uint8_t)((c & 0x80) ? (c << 1) ^ 0x07 : (c << 1));
+    }
+    return c;
+  }
+
+  uint16_t leer16(uint16_t dir) { return (uint16_t)(_memoria.read(dir) | (_memoria.read((uint16_t)(dir + 1)) << 8)); }
+  uint32_t leer32(uint16_t dir) { return (uint32_t)leer16(dir) | ((uint32_t)leer16((uint16_t)(dir + 2)) << 16); }
+  void escribir16(uint16_t dir, uint16_t v) {
+    _memoria.write(dir, (uint8_t)v);
+    _memoria.write((uint16_t)(dir + 1), (uint8_t)(v >> 8));
+  }
+  void escribir32(uint16_t dir, uint32_t v) {
+    escribir16(dir, (uint16_t)v);
+    escribir16((uint16_t)(dir + 2), (uint16_t)(v >> 16));
+  }
+};
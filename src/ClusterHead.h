@@ -0,0 +1,153 @@
+/**
+ * @file ClusterHead.h
+ * @brief Define la clase ClusterHead: elección rotativa de cabeza de clúster (tipo LEACH)
+ * ponderada por la energía residual.
+ * Cada nodo decide por sí solo, ronda a ronda, si es cabeza. La decisión es
+ * determinista dado (semilla, nodeId, ronda, energía): el gateway puede
+ * reproducirla para saber qué nodos escuchar sin recibir mensajes extra.
+ * Sólo usa enteros, un hash de 32 bits y unas pocas divisiones por ronda, así que
+ * se puede evaluar en cada ronda en un AVR de 8 bits.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @class ClusterHead
+ * @brief Umbral LEACH con época por nodo escalada por energía (estilo DEEC).
+ *
+ * Con `rondasPorEpoca` = N (p = 1/N) LEACH usa el umbral
+ * T(r) = p / (1 - p * (r mod N)) = 1 / (N - r mod N) para los nodos que no
+ * fueron cabeza en la época. Aquí cada nodo usa su propia época
+ * N_i = N * promedio / residuo: los nodos con más energía que el promedio de
+ * la red rotan más seguido y los débiles menos, manteniendo ~n/N cabezas por
+ * ronda. En la última ronda de su época un nodo elegible es cabeza con
+ * certeza, igual que en LEACH.
+ *
+ * Uso típico, al inicio de cada ronda:
+ * @code
+ *   uint8_t residuo = ClusterHead::residualQ8(mV, 3400, 4150);
+ *   if (cabeza.elect(ronda, residuo)) { ... anunciarse como cabeza ... }
+ * @endcode
+ */
+class ClusterHead {
+public:
+  /**
+   * @struct Cfg
+   * @brief Parámetros comunes a toda la red (todos los nodos deben usar los mismos).
+   */
+  struct Cfg {
+    uint16_t rondasPorEpoca  = 20;   ///< N = 1/p; 20 = 5 % de cabezas por ronda.
+    uint32_t semilla         = 0;    ///< Semilla de la red; cambiarla reordena las rotaciones.
+    bool     ponderarEnergia = true; ///< false: LEACH clásico (todas las épocas miden N).
+  };
+
+  /**
+   * @brief Inicializa el estado de rotación del nodo.
+   * @param cfg Parámetros de la red.
+   * @param nodeId Identificador del nodo (el mismo que en StatusBeacon).
+   */
+  void begin(const Cfg& cfg, uint32_t nodeId) {
+    _cfg = cfg;
+    if (_cfg.rondasPorEpoca == 0) _cfg.rondasPorEpoca = 1;
+    _nodeId = nodeId;
+    _promedio_q8 = 255;
+    _fueCabeza = false;
+    _esCabeza = false;
+    _ultimaRondaCabeza = 0;
+  }
+
+  /**
+   * @brief Fija el residuo promedio de la red (difundido por el gateway).
+   * Sin llamarla se supone 255 (red llena), con lo que los nodos gastados
+   * rotan cada vez menos y el número de cabezas por ronda baja.
+   * @param promedio_q8 Residuo promedio en Q0.8.
+   */
+  void setNetworkAverageQ8(uint8_t promedio_q8) { _promedio_q8 = promedio_q8 ? promedio_q8 : 1; }
+
+  /**
+   * @brief Decide si el nodo es cabeza en esta ronda y actualiza su historia.
+   * Llamar una vez por ronda, con rondas crecientes (desborda en 65535).
+   * @param ronda Número de ronda común a la red.
+   * @param residuo_q8 Energía residual del nodo en Q0.8 (ver residualQ8()).
+   * @return true Si el nodo es cabeza en esta ronda.
+   */
+  bool elect(uint16_t ronda, uint8_t residuo_q8) {
+    const uint16_t epoca = epochRounds(residuo_q8);
+    _esCabeza = false;
+    if (residuo_q8 > 0 && elegible(ronda, epoca)) {
+      _esCabeza = draw(_cfg.semilla, _nodeId, ronda) < threshold(ronda, epoca);
+    }
+    if (_esCabeza) {
+      _fueCabeza = true;
+      _ultimaRondaCabeza = ronda;
+    }
+    return _esCabeza;
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /** @brief Resultado de la última elect(). */
+  bool isHead() const { return _esCabeza; }
+
+  /** @brief Época propia N_i para un residuo dado (rondas entre turnos como cabeza). */
+  uint16_t epochRounds(uint8_t residuo_q8) const {
+    if (!_cfg.ponderarEnergia) return _cfg.rondasPorEpoca;
+    if (residuo_q8 == 0) return 0xFFFF;
+    uint32_t n = ((uint32_t)_cfg.rondasPorEpoca * _promedio_q8 + residuo_q8 / 2) / residuo_q8;
+    return (n == 0) ? 1 : (n > 0xFFFF) ? 0xFFFF : (uint16_t)n;
+  }
+
+  /**
+   * @brief Convierte un voltaje en residuo Q0.8, lineal entre corte y lleno.
+   * @param mV Voltaje medido (mV).
+   * @param corte_mV Voltaje de `corteVoltaje_V` (residuo 0).
+   * @param lleno_mV Voltaje de celda llena (residuo 255).
+   * @return uint8_t Residuo en Q0.8.
+   */
+  static uint8_t residualQ8(uint16_t mV, uint16_t corte_mV, uint16_t lleno_mV) {
+    if (mV <= corte_mV || lleno_mV <= corte_mV) return 0;
+    if (mV >= lleno_mV) return 255;
+    return (uint8_t)(((uint32_t)(mV - corte_mV) * 255) / (uint16_t)(lleno_mV - corte_mV));
+  }
+
+  /**
+   * @brief Número pseudoaleatorio de 16 bits para (semilla, nodo, ronda).
+   * Finalizador de 32 bits tipo murmur3: mezcla suficiente y barato en AVR.
+   */
+  static uint16_t draw(uint32_t semilla, uint32_t nodeId, uint16_t ronda) {
+    uint32_t x = semilla ^ (nodeId * 0x9E3779B1UL) ^ ((uint32_t)ronda * 0x85EBCA77UL);
+    x ^= x >> 16;
+    x *= 0x7FEB352DUL;
+    x ^= x >> 15;
+    x *= 0x846CA68BUL;
+    x ^= x >> 16;
+    return (uint16_t)(x >> 16);
+  }
+
+  /**
+   * @brief Umbral LEACH en Q0.16 para la posición de la ronda dentro de la época.
+   * @return uint32_t 65536 / (N_i - r mod N_i); 65536 en la última ronda (certeza).
+   */
+  static uint32_t threshold(uint16_t ronda, uint16_t epoca) {
+    const uint16_t restantes = epoca - (ronda % epoca);
+    return 65536UL / restantes;
+  }
+
+private:
+  Cfg      _cfg;
+  uint32_t _nodeId            = 0;
+  uint8_t  _promedio_q8       = 255;   ///< Residuo promedio de la red.
+  bool     _fueCabeza         = false; ///< Ya fue cabeza alguna vez.
+  bool     _esCabeza          = false; ///< Resultado de la última ronda.
+  uint16_t _ultimaRondaCabeza = 0;     ///< Ronda de su último turno como cabeza.
+
+  /** Conjunto G de LEACH: no fue cabeza en la época en curso. */
+  bool elegible(uint16_t ronda, uint16_t epoca) const {
+    if (!_fueCabeza) return true;
+    if ((uint16_t)(ronda - _ultimaRondaCabeza) >= epoca) return true;
+    return (ronda / epoca) != (_ultimaRondaCabeza / epoca);
+  }
+};
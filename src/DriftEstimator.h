@@ -0,0 +1,166 @@
+/**
+ * @file DriftEstimator.h
+ * @brief Define la clase DriftEstimator para estimar la deriva del reloj local
+ * respecto a la hora del gateway.
+ * Los Arduino con resonador cerámico derivan hasta ±0.5% (±5000 ppm), lo que
+ * desplaza minutos por día el calendario de tick(). Esta clase recibe pares
+ * (hora local, hora del gateway) obtenidos de ACKs o balizas y estima la
+ * deriva por mínimos cuadrados sobre una ventana pequeña, todo en enteros.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @class DriftEstimator
+ * @brief Estimador de deriva de reloj por mínimos cuadrados en punto fijo.
+ *
+ * Se modela el desfase `gateway - local` como una recta en función de la hora
+ * local; la pendiente de esa recta (en ppm) es la deriva. El resultado se
+ * entrega a AdaptiveTXWSN::setClockDriftPpm() para corregir el temporizador.
+ */
+class DriftEstimator {
+public:
+  static const uint8_t  VENTANA          = 8;          ///< Número de pares usados en el ajuste.
+  static const uint32_t SPAN_MAXIMO_ms   = 1UL << 28;  ///< Separación máxima entre el par más viejo y el más nuevo (~3 días).
+  static const int32_t  SALTO_MAXIMO_ms  = 1L << 22;   ///< Salto de desfase que se interpreta como reinicio del gateway.
+  static const int32_t  DERIVA_MAXIMA_ppm = 20000;     ///< Límite de la estimación reportada (±2%).
+
+  /**
+   * @brief Descarta todos los pares acumulados y la estimación actual.
+   */
+  void reset() {
+    _nPares      = 0;
+    _indiceNuevo = 0;
+    _deriva_ppm  = 0;
+  }
+
+  /**
+   * @brief Agrega un par (hora local, hora del gateway) y recalcula la deriva.
+   *
+   * @param local_ms Valor de millis() en el instante en que se recibió la hora.
+   * @param gateway_ms Hora del gateway (ms, base arbitraria pero monótona).
+   * @return int32_t La deriva estimada en ppm tras incorporar el par.
+   */
+  int32_t addSample(uint32_t local_ms, uint32_t gateway_ms) {
+    if (_nPares > 0) {
+      const Par& ultimo = _pares[_indiceNuevo];
+      int32_t salto = (int32_t)((gateway_ms - local_ms) - (ultimo.gateway_ms - ultimo.local_ms));
+      // El gateway se reinició o la hora local retrocedió: se empieza de cero
+      if (salto > SALTO_MAXIMO_ms || salto < -SALTO_MAXIMO_ms
+          || (int32_t)(local_ms - ultimo.local_ms) <= 0) {
+        reset();
+      }
+    }
+
+    _indiceNuevo = (_nPares == 0) ? 0 : (uint8_t)((_indiceNuevo + 1) % VENTANA);
+    _pares[_indiceNuevo].local_ms   = local_ms;
+    _pares[_indiceNuevo].gateway_ms = gateway_ms;
+    if (_nPares < VENTANA) _nPares++;
+
+    // Descartar pares demasiado viejos para que las sumas no desborden
+    while (_nPares > 2 && (local_ms - _pares[indiceViejo()].local_ms) > SPAN_MAXIMO_ms) _nPares--;
+
+    recalcular();
+    return _deriva_ppm;
+  }
+
+  /**
+   * @brief Convierte una hora local en la hora del gateway estimada.
+   * Usa el último par recibido y la deriva estimada para extrapolar.
+   *
+   * @param local_ms Valor de millis() a convertir.
+   * @return uint32_t Hora del gateway estimada (ms), o `local_ms` si no hay pares.
+   */
+  uint32_t toGatewayMs(uint32_t local_ms) const {
+    if (_nPares == 0) return local_ms;
+    const Par& ultimo = _pares[_indiceNuevo];
+    int32_t transcurrido = (int32_t)(local_ms - ultimo.local_ms);
+    int32_t correccion   = (int32_t)(((int64_t)transcurrido * _deriva_ppm) / 1000000L);
+    return ultimo.gateway_ms + (uint32_t)(transcurrido + correccion);
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /**
+   * @brief Obtiene la deriva estimada.
+   * Positiva si el reloj local atrasa respecto al gateway.
+   * @return int32_t Deriva en partes por millón.
+   */
+  int32_t driftPpm()  const { return _deriva_ppm; }
+
+  /**
+   * @brief Número de pares actualmente en la ventana de ajuste.
+   * @return uint8_t Entre 0 y VENTANA.
+   */
+  uint8_t samples()   const { return _nPares; }
+
+  /**
+   * @brief Indica si ya hay pares suficientes para confiar en la estimación.
+   * @return true Si la ventana tiene al menos 3 pares.
+   */
+  bool    isValid()   const { return _nPares >= 3; }
+
+private:
+  struct Par {
+    uint32_t local_ms;
+    uint32_t gateway_ms;
+  };
+
+  Par      _pares[VENTANA];       ///< Buffer circular de pares (local, gateway).
+  uint8_t  _nPares      = 0;      ///< Pares válidos en el buffer.
+  uint8_t  _indiceNuevo = 0;      ///< Posición del par más reciente.
+  int32_t  _deriva_ppm  = 0;      ///< Última estimación de deriva.
+
+  uint8_t indiceViejo() const {
+    return (uint8_t)((_indiceNuevo + VENTANA + 1 - _nPares) % VENTANA);
+  }
+
+  /**
+   * @brief Ajuste por mínimos cuadrados del desfase contra la hora local.
+   * Las coordenadas se toman relativas al par más viejo y se centran para
+   * que las sumas quepan en int64 incluso en AVR.
+   */
+  void recalcular() {
+    if (_nPares < 2) { _deriva_ppm = 0; return; }
+
+    const Par& base = _pares[indiceViejo()];
+    const int32_t desfaseBase = (int32_t)(base.gateway_ms - base.local_ms);
+
+    int32_t x[VENTANA];
+    int32_t y[VENTANA];
+    int64_t sumaX = 0, sumaY = 0;
+    for (uint8_t k = 0; k < _nPares; ++k) {
+      const Par& p = _pares[(indiceViejo() + k) % VENTANA];
+      x[k] = (int32_t)(p.local_ms - base.local_ms);
+      y[k] = (int32_t)(p.gateway_ms - p.local_ms) - desfaseBase;
+      sumaX += x[k];
+      sumaY += y[k];
+    }
+    const int32_t mediaX = (int32_t)(sumaX / _nPares);
+    const int32_t mediaY = (int32_t)(sumaY / _nPares);
+
+    // Escalar dx para que dx^2 * VENTANA no desborde
+    uint8_t escala = 0;
+    while ((x[_nPares - 1] >> escala) > (1L << 20)) escala++;
+
+    int64_t sxx = 0, sxy = 0;
+    for (uint8_t k = 0; k < _nPares; ++k) {
+      int32_t dx = (x[k] - mediaX) / (1L << escala);
+      int32_t dy = y[k] - mediaY;
+      sxx += (int64_t)dx * dx;
+      sxy += (int64_t)dx * dy;
+    }
+    // ppm = sxy * 1e6 / (sxx << escala), con 1e6 = 15625 * 64
+    int64_t denominador = (sxx << escala) >> 6;
+    if (denominador <= 0) return; // span demasiado corto: conservar la estimación previa
+
+    int64_t numerador = sxy * 15625;
+    int64_t ppm = (numerador + (numerador >= 0 ? denominador / 2 : -denominador / 2)) / denominador; // redondeo
+    if (ppm >  DERIVA_MAXIMA_ppm) ppm =  DERIVA_MAXIMA_ppm;
+    if (ppm < -DERIVA_MAXIMA_ppm) ppm = -DERIVA_MAXIMA_ppm;
+    _deriva_ppm = (int32_t)ppm;
+  }
+};
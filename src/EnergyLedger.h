@@ -0,0 +1,202 @@
+/**
+ * @file EnergyLedger.h
+ * @brief Define la clase EnergyLedger: contabilidad de la carga consumida por el nodo.
+ * Estima, con costos configurados por el usuario, cuánta carga (µC) se va en
+ * reposo, en muestrear la batería, en transmitir y, en nodos relevo, en
+ * reenviar paquetes ajenos y escuchar el canal. El gateway usa el consumo
+ * medio y la fracción atribuible a los envíos para balancear la vida útil
+ * de la flota; el nodo usa la corriente de relevo para alargar su propio
+ * período (AdaptiveTXWSN::setRelayCurrentUa()).
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @class EnergyLedger
+ * @brief Libro de energía por categoría, en enteros.
+ *
+ * Uso típico en loop():
+ * @code
+ *   bool envia = txTimer.tick();
+ *   ledger.onTick(millis(), envia);
+ *   txTimer.setRelayCurrentUa(ledger.relayCurrentUa(), ledger.sendChargeUc());
+ * @endcode
+ * y, en un relevo, `ledger.onForward()` por cada paquete reenviado y
+ * `ledger.onListen(ms)` con el tiempo que la radio estuvo escuchando.
+ */
+class EnergyLedger {
+public:
+  /**
+   * @struct Cfg
+   * @brief Costos del hardware concreto (medirlos con un amperímetro).
+   */
+  struct Cfg {
+    uint16_t corrienteReposo_uA  = 15;       ///< Corriente media entre ticks (MCU dormido + periféricos).
+    uint16_t cargaMuestra_uC     = 20;       ///< Carga de una lectura de batería en tick().
+    uint32_t cargaEnvio_uC       = 2500;     ///< Carga de una transmisión (ej. 50 mA durante 50 ms).
+    uint32_t cargaReenvio_uC     = 4000;     ///< Recibir y retransmitir un paquete ajeno.
+    uint16_t corrienteEscucha_uA = 5000;     ///< Corriente de la radio en recepción.
+    uint32_t ventanaRelevo_ms    = 600000UL; ///< Ventana de la corriente de relevo (10 min).
+    uint8_t  corrimientoRelevo   = 2;        ///< Constante de la EWMA de la corriente de relevo como 2^-n.
+  };
+
+  /**
+   * @enum Categoria
+   * @brief Destinos de la carga contabilizada.
+   */
+  enum Categoria : uint8_t {
+    REPOSO   = 0, ///< Tiempo entre ticks.
+    MUESTREO = 1, ///< Lecturas de batería.
+    ENVIO    = 2, ///< Transmisiones propias.
+    REENVIO  = 3, ///< Paquetes ajenos recibidos y retransmitidos.
+    ESCUCHA  = 4, ///< Radio en recepción esperando a los hijos.
+    NUM_CATEGORIAS
+  };
+
+  /**
+   * @brief Inicializa el libro y pone los acumuladores a cero.
+   * @param cfg Costos de operación.
+   * @param ahora_ms Valor actual de millis().
+   */
+  void begin(const Cfg& cfg, uint32_t ahora_ms) {
+    _cfg = cfg;
+    for (uint8_t i = 0; i < NUM_CATEGORIAS; ++i) _carga_uC[i] = 0;
+    _restoReposo_nC = 0;
+    _restoEscucha_nC = 0;
+    _transcurrido_ms = 0;
+    _ultimo_ms = ahora_ms;
+    _relevoVentana_uC = 0;
+    _inicioVentana_ms = ahora_ms;
+    _corrienteRelevo_uA = 0;
+    _reenvios = 0;
+  }
+
+  /**
+   * @brief Contabiliza un tick(): reposo desde el tick anterior, una muestra y, si hubo, un envío.
+   * @param ahora_ms Valor actual de millis().
+   * @param envio true si tick() devolvió true y se transmitió.
+   */
+  void onTick(uint32_t ahora_ms, bool envio) {
+    const uint32_t dt_ms = ahora_ms - _ultimo_ms;
+    _ultimo_ms = ahora_ms;
+    _transcurrido_ms += dt_ms;
+
+    // µA * ms = nC
+    uint64_t reposo_nC = (uint64_t)dt_ms * _cfg.corrienteReposo_uA + _restoReposo_nC;
+    _carga_uC[REPOSO] += reposo_nC / 1000;
+    _restoReposo_nC    = (uint16_t)(reposo_nC % 1000);
+
+    _carga_uC[MUESTREO] += _cfg.cargaMuestra_uC;
+    if (envio) _carga_uC[ENVIO] += _cfg.cargaEnvio_uC;
+
+    // Corriente de relevo: promedio de la ventana, suavizado entre ventanas
+    const uint32_t ventana_ms = ahora_ms - _inicioVentana_ms;
+    if (ventana_ms >= _cfg.ventanaRelevo_ms && ventana_ms > 0) {
+      uint64_t muestra_uA = ((uint64_t)_relevoVentana_uC * 1000) / ventana_ms;
+      if (muestra_uA > 0xFFFF) muestra_uA = 0xFFFF;
+      int32_t d = (int32_t)muestra_uA - (int32_t)_corrienteRelevo_uA;
+      _corrienteRelevo_uA = (uint16_t)((int32_t)_corrienteRelevo_uA + d / (1L << _cfg.corrimientoRelevo));
+      _relevoVentana_uC = 0;
+      _inicioVentana_ms = ahora_ms;
+    }
+  }
+
+  /**
+   * @brief Contabiliza paquetes de hijos recibidos y retransmitidos hacia el gateway.
+   * @param paquetes Número de paquetes reenviados.
+   */
+  void onForward(uint16_t paquetes = 1) {
+    uint32_t q = _cfg.cargaReenvio_uC * paquetes;
+    _carga_uC[REENVIO] += q;
+    _relevoVentana_uC  += q;
+    _reenvios          += paquetes;
+  }
+
+  /**
+   * @brief Contabiliza tiempo con la radio en recepción (ventanas de escucha de los hijos).
+   * @param ms Milisegundos de escucha.
+   */
+  void onListen(uint32_t ms) {
+    uint64_t escucha_nC = (uint64_t)ms * _cfg.corrienteEscucha_uA + _restoEscucha_nC;
+    uint32_t q = (uint32_t)(escucha_nC / 1000);
+    _restoEscucha_nC   = (uint16_t)(escucha_nC % 1000);
+    _carga_uC[ESCUCHA] += q;
+    _relevoVentana_uC  += q;
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /**
+   * @brief Carga acumulada en una categoría.
+   * @return uint64_t µC desde begin().
+   */
+  uint64_t consumedUc(Categoria c) const { return _carga_uC[c]; }
+
+  /**
+   * @brief Carga total acumulada.
+   * @return uint64_t µC desde begin().
+   */
+  uint64_t totalUc() const {
+    uint64_t t = 0;
+    for (uint8_t i = 0; i < NUM_CATEGORIAS; ++i) t += _carga_uC[i];
+    return t;
+  }
+
+  /**
+   * @brief Corriente media desde begin().
+   * @return uint16_t µA (satura en 65535).
+   */
+  uint16_t averageCurrentUa() const {
+    if (_transcurrido_ms == 0) return _cfg.corrienteReposo_uA;
+    uint64_t uA = (totalUc() * 1000) / _transcurrido_ms;
+    return (uA > 0xFFFF) ? 0xFFFF : (uint16_t)uA;
+  }
+
+  /**
+   * @brief Fracción del consumo atribuible a los envíos propios.
+   * Es la parte que escala con el período; el resto es fija.
+   * @return uint8_t Fracción en Q0.8 (255 ~ 100%).
+   */
+  uint8_t sendShareQ8() const {
+    uint64_t total = totalUc();
+    if (total == 0) return 0;
+    uint64_t q = (_carga_uC[ENVIO] * 255) / total;
+    return (uint8_t)q;
+  }
+
+  /**
+   * @brief Corriente media reciente gastada en el papel de relevo (reenvío + escucha).
+   * Se actualiza en onTick() una vez por `ventanaRelevo_ms`.
+   * @return uint16_t µA.
+   */
+  uint16_t relayCurrentUa() const { return _corrienteRelevo_uA; }
+
+  /**
+   * @brief Carga de un envío propio según los costos configurados.
+   * Es la única definición de ese costo: AdaptiveTXWSN y LyapunovScheduler la leen de aquí.
+   * @return uint32_t µC.
+   */
+  uint32_t sendChargeUc() const { return _cfg.cargaEnvio_uC; }
+
+  /**
+   * @brief Paquetes reenviados desde begin() (desborda; usar diferencias).
+   * RoutingCost deriva de aquí la carga de reenvío.
+   * @return uint32_t Paquetes.
+   */
+  uint32_t forwardedPackets() const { return _reenvios; }
+
+private:
+  Cfg      _cfg;
+  uint64_t _carga_uC[NUM_CATEGORIAS] = {};  ///< Carga acumulada por categoría (µC).
+  uint16_t _restoReposo_nC           = 0;   ///< Fracción de µC de reposo aún no contabilizada.
+  uint16_t _restoEscucha_nC          = 0;   ///< Fracción de µC de escucha aún no contabilizada.
+  uint64_t _transcurrido_ms          = 0;   ///< Tiempo cubierto por el libro.
+  uint32_t _ultimo_ms                = 0;   ///< millis() del último onTick().
+  uint32_t _relevoVentana_uC         = 0;   ///< Carga de relevo de la ventana en curso.
+  uint32_t _inicioVentana_ms         = 0;   ///< millis() de inicio de la ventana de relevo.
+  uint16_t _corrienteRelevo_uA       = 0;   ///< EWMA de la corriente de relevo.
+  uint32_t _reenvios                 = 0;   ///< Paquetes reenviados.
+};
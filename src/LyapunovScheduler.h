@@ -0,0 +1,135 @@
+/**
+ * @file LyapunovScheduler.h
+ * @brief Define la clase LyapunovScheduler: decisión "enviar o no" por
+ * deriva-más-penalización (Lyapunov) sobre una cola virtual de energía.
+ * Alternativa a los niveles con histéresis: en vez de tres períodos fijos,
+ * cada tick() compara el costo energético de enviar, pesado por el déficit
+ * acumulado de la batería, con la penalización por información vieja.
+ * La actualización es O(1) y sólo usa enteros.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "EnergyLedger.h"
+
+/**
+ * @class LyapunovScheduler
+ * @brief Cola virtual Z (déficit de carga respecto a batería llena, µC) y
+ * regla de deriva-más-penalización.
+ *
+ * Z crece con el reposo y con cada envío y baja con la cosecha informada
+ * (setIncomeUa()); no baja de 0 (batería llena). Minimizar
+ * Z·e·a - V·edad·a en cada tick (a = enviar, e = carga de un envío) da la regla
+ *
+ *   enviar  si  V · edad_s >= Z_uC
+ *
+ * es decir, un umbral de edad Z / V que crece a medida que la batería se
+ * vacía. V (`pesoEdad`) fija el compromiso: mayor V da información más
+ * fresca a costa de bajar más la batería (la cola se estabiliza en O(V));
+ * menor V la protege.
+ *
+ * Los costos de un envío y del reposo son los del EnergyLedger del nodo
+ * (begin() recibe su `Cfg`).
+ *
+ * Uso típico, en cada loop():
+ * @code
+ *   txTimer.tick();                                    // sólo corte
+ *   dpp.setIncomeUa(corrienteCosecha_uA);              // p. ej. desde el PMIC
+ *   if (!txTimer.isCutoff() && dpp.tick(millis())) { ... transmitir ... }
+ * @endcode
+ */
+class LyapunovScheduler {
+public:
+  /**
+   * @struct Cfg
+   * @brief Parámetros del controlador.
+   */
+  struct Cfg {
+    uint32_t pesoEdad           = 1000000; ///< V: µC de déficit que vale cada segundo de edad.
+    uint32_t periodoMinimo_ms   = 5000;    ///< Separación mínima entre envíos (con la batería llena Z = 0).
+  };
+
+  /**
+   * @brief Inicializa el controlador.
+   * @param cfg Parámetros.
+   * @param costos Costos del nodo (carga de un envío y corriente de reposo), los mismos del EnergyLedger.
+   * @param ahora_ms millis().
+   * @param deficit_uC Déficit inicial (0 = batería llena).
+   */
+  void begin(const Cfg& cfg, const EnergyLedger::Cfg& costos, uint32_t ahora_ms, uint64_t deficit_uC = 0) {
+    _cfg = cfg;
+    _cargaEnvio_uC = costos.cargaEnvio_uC;
+    _corrienteReposo_uA = costos.corrienteReposo_uA;
+    _deficit_uC = deficit_uC;
+    _ingreso_uA = 0;
+    _ultimo_ms = ahora_ms;
+    _ultimoEnvio_ms = ahora_ms;
+    _resto_nC = 0;
+  }
+
+  /**
+   * @brief Evalúa la regla. Llamar en cada loop(); si devuelve true se cuenta el envío.
+   * @param ahora_ms millis().
+   * @return true Si toca transmitir.
+   */
+  bool tick(uint32_t ahora_ms) {
+    // Z += (reposo - cosecha) * dt; µA * ms = nC
+    const uint32_t dt = ahora_ms - _ultimo_ms;
+    _ultimo_ms = ahora_ms;
+    int64_t neto_nC = ((int64_t)_corrienteReposo_uA - (int64_t)_ingreso_uA) * dt + _resto_nC;
+    _resto_nC = (int32_t)(neto_nC % 1000);
+    int64_t z = (int64_t)_deficit_uC + neto_nC / 1000;
+    if (z <= 0) { z = 0; _resto_nC = 0; }
+    _deficit_uC = (uint64_t)z;
+
+    const uint32_t edad = ahora_ms - _ultimoEnvio_ms;
+    if (edad < _cfg.periodoMinimo_ms) return false;
+    if ((uint64_t)_cfg.pesoEdad * (edad / 1000) < _deficit_uC) return false;
+    _ultimoEnvio_ms = ahora_ms;
+    _deficit_uC += _cargaEnvio_uC;
+    return true;
+  }
+
+  /**
+   * @brief Informa la corriente que entra a la batería (cosecha), en µA.
+   */
+  void setIncomeUa(uint32_t ingreso_uA) { _ingreso_uA = ingreso_uA; }
+
+  /**
+   * @brief Resincroniza la cola con una medición (p. ej. un medidor de carga),
+   * corrigiendo el error acumulado de los costos supuestos.
+   * @param deficit_uC Carga que falta para la batería llena.
+   */
+  void setDeficitUc(uint64_t deficit_uC) { _deficit_uC = deficit_uC; }
+
+  /** @brief Cambia V en tiempo de ejecución. */
+  void setAgeWeight(uint32_t pesoEdad) { _cfg.pesoEdad = pesoEdad; }
+
+  // --- Getters (Consultores de estado) ---
+
+  /** @brief Cola virtual Z (µC). */
+  uint64_t deficitUc() const { return _deficit_uC; }
+
+  /** @brief Edad desde el último envío (ms). */
+  uint32_t ageMs(uint32_t ahora_ms) const { return ahora_ms - _ultimoEnvio_ms; }
+
+  /** @brief Umbral de edad vigente Z / V (ms), al menos `periodoMinimo_ms`. */
+  uint32_t thresholdMs() const {
+    const uint64_t v = _cfg.pesoEdad ? _cfg.pesoEdad : 1;
+    const uint64_t t = (_deficit_uC * 1000 + v - 1) / v;
+    if (t > 0xFFFFFFFFULL) return 0xFFFFFFFFUL;
+    return (t < _cfg.periodoMinimo_ms) ? _cfg.periodoMinimo_ms : (uint32_t)t;
+  }
+
+private:
+  Cfg      _cfg;
+  uint64_t _deficit_uC     = 0; ///< Cola virtual Z.
+  uint32_t _ingreso_uA     = 0; ///< Cosecha informada.
+  uint32_t _cargaEnvio_uC  = 0; ///< EnergyLedger::Cfg::cargaEnvio_uC.
+  uint32_t _corrienteReposo_uA = 0; ///< EnergyLedger::Cfg::corrienteReposo_uA.
+  uint32_t _ultimo_ms      = 0; ///< Último tick().
+  uint32_t _ultimoEnvio_ms = 0;
+  int32_t  _resto_nC       = 0; ///< Fracción de µC aún no aplicada a Z.
+};
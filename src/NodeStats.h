@@ -0,0 +1,290 @@
+/**
+ * @file NodeStats.h
+ * @brief Define la clase NodeStats: estadísticas de operación del nodo para
+ * ajustar `fraccionHisteresis` y los períodos con distribuciones en lugar de
+ * instantáneas de level().
+ * Acumula tiempo por `Level` y en corte, transiciones, rebotes (vuelta al
+ * nivel anterior antes de `ventanaRebote_ms`), entradas en corte e
+ * histogramas logarítmicos del intervalo entre envíos y del margen de voltaje
+ * sobre el corte. Memoria fija, O(1) por tick.
+ *
+ * Se compila sólo si ADAPTIVETXWSN_STATS vale 1 (definirlo antes de incluir
+ * o con -D). Si no, NodeStats queda vacía y sus llamadas no generan código.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "AdaptiveTXWSN.h"
+
+#ifndef ADAPTIVETXWSN_STATS
+#define ADAPTIVETXWSN_STATS 0
+#endif
+
+/**
+ * @class NodeStats
+ * @brief Estadísticas acumuladas desde begin().
+ *
+ * Histogramas de 16 cubetas uint16; cuando una satura se dividen todas a la
+ * mitad (se conserva la forma de la distribución).
+ *  - Intervalo entre envíos: cubeta k = [2^k, 2^(k+1)) s.
+ *  - Margen sobre `corteVoltaje_V`: media octava por cubeta desde 8 mV
+ *    (cubeta 0 < 8 mV, luego 8, 11, 16, 22, 32, ... mV, hasta ~2 V).
+ *
+ * Uso típico:
+ * @code
+ *   bool enviar = txTimer.tick();
+ *   stats.update(txTimer, millis());
+ *   if (enviar) { stats.onSend(millis()); ... }
+ *   // anexar a la baliza como bloque de extensión:
+ *   // n = b.encode(buf); n += StatusBeacon::addExtension(buf, stats.encode(buf + n));
+ * @endcode
+ *
+ * El tiempo se acumula en segundos más un resto en ms por estado, así que
+ * no desborda en la vida del nodo (un uint32 en ms lo hacía a los 49.7 días).
+ */
+class NodeStats {
+public:
+  static const uint8_t CUBETAS = 16;   ///< Cubetas por histograma.
+  static const uint8_t TIPO    = 0x01; ///< Tipo del bloque de extensión en StatusBeacon.
+  static const uint8_t VERSION = 2;    ///< Versión del bloque que genera encode().
+  static const uint8_t TAMANO  = 33;   ///< Bytes del bloque con tipo y longitud (encode() escribe 0 si está desactivada).
+
+  /**
+   * @struct Cfg
+   * @brief Parámetros de la contabilidad.
+   */
+  struct Cfg {
+    uint32_t ventanaRebote_ms = 600000; ///< Volver al nivel anterior antes de esto cuenta como rebote.
+  };
+
+  /**
+   * @struct Resumen
+   * @brief Contenido del bloque codificado, tal como lo ve el gateway.
+   */
+  struct Resumen {
+    uint32_t segundos              = 0;  ///< Tiempo total contabilizado.
+    uint8_t  fraccion_q8[4]        = {}; ///< Fracción del tiempo en BAJO, MEDIO, ALTO y corte.
+    uint16_t transiciones          = 0;
+    uint16_t rebotes               = 0;
+    uint16_t entradasCorte         = 0;
+    uint8_t  intervalos[CUBETAS]   = {}; ///< Histograma de intervalos normalizado a 0..15.
+    uint8_t  margenVoltaje[CUBETAS] = {}; ///< Histograma del margen normalizado a 0..15.
+  };
+
+#if ADAPTIVETXWSN_STATS
+  /**
+   * @brief Reinicia los acumuladores.
+   * @param cfg Parámetros.
+   * @param ahora_ms millis().
+   */
+  void begin(const Cfg& cfg, uint32_t ahora_ms) {
+    _cfg = cfg;
+    memset(_s, 0, sizeof(_s));
+    memset(_resto_ms, 0, sizeof(_resto_ms));
+    memset(_intervalos, 0, sizeof(_intervalos));
+    memset(_margen, 0, sizeof(_margen));
+    _transiciones = _rebotes = _entradasCorte = 0;
+    _ultimo_ms = ahora_ms;
+    _ultimoEnvio_ms = ahora_ms;
+    _hayEnvio = false;
+    _estado = 0xFF;
+    _nivelAnterior = 0xFF;
+    _msTransicion = ahora_ms;
+  }
+
+  /**
+   * @brief Contabiliza el tiempo desde la llamada anterior y registra cambios de estado.
+   * Llamar después de cada tick().
+   */
+  template <class... P>
+  void update(const BasicAdaptiveTXWSN<P...>& nodo, uint32_t ahora_ms) {
+    const uint8_t estado = nodo.isCutoff() ? 3 : (uint8_t)nodo.level();
+    if (_estado != 0xFF) acumular(_estado, ahora_ms - _ultimo_ms);
+    _ultimo_ms = ahora_ms;
+
+    if (estado != _estado && _estado != 0xFF) {
+      if (estado == 3) {
+        saturar(_entradasCorte);
+      } else if (_estado != 3) {
+        saturar(_transiciones);
+        if (estado == _nivelAnterior && (ahora_ms - _msTransicion) < _cfg.ventanaRebote_ms) saturar(_rebotes);
+        _nivelAnterior = _estado;
+        _msTransicion = ahora_ms;
+      }
+    }
+    _estado = estado;
+
+    const float margen_mV = (nodo.lastVolts() - _corte_V) * 1000.0f;
+    contar(_margen, cubetaMargen(margen_mV <= 0.0f ? 0 : (uint16_t)min(margen_mV, 65535.0f)));
+  }
+
+  /** @brief Fija el corte de referencia del histograma de voltaje (por defecto 3.40 V). */
+  void setCutoffVolts(float corte_V) { _corte_V = corte_V; }
+
+  /** @brief Registra un envío (histograma de intervalos). */
+  void onSend(uint32_t ahora_ms) {
+    if (_hayEnvio) contar(_intervalos, cubetaIntervalo((ahora_ms - _ultimoEnvio_ms) / 1000));
+    _hayEnvio = true;
+    _ultimoEnvio_ms = ahora_ms;
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /** @brief Tiempo (s) en un nivel fuera de corte. */
+  uint32_t secondsInLevel(AdaptiveTXWSN::Level nivel) const { return _s[(uint8_t)nivel & 0x03]; }
+  /** @brief Tiempo (s) en corte. */
+  uint32_t secondsInCutoff() const { return _s[3]; }
+  /** @brief Cambios de nivel fuera de corte. */
+  uint16_t transitions() const { return _transiciones; }
+  /** @brief Cambios que volvieron al nivel anterior dentro de la ventana. */
+  uint16_t flaps() const { return _rebotes; }
+  /** @brief Veces que se entró en corte. */
+  uint16_t cutoffEntries() const { return _entradasCorte; }
+  /** @brief Cuenta de una cubeta del histograma de intervalos. */
+  uint16_t intervalBucket(uint8_t k) const { return (k < CUBETAS) ? _intervalos[k] : 0; }
+  /** @brief Cuenta de una cubeta del histograma de margen de voltaje. */
+  uint16_t voltageBucket(uint8_t k) const { return (k < CUBETAS) ? _margen[k] : 0; }
+
+  /**
+   * @brief Serializa el resumen en `buf` como bloque de extensión de
+   * StatusBeacon (ver StatusBeacon::addExtension()).
+   *
+   * Formato: [TIPO][longitud][versión][segundos:4][fracciones:4]
+   * [transiciones:2][rebotes:2][entradasCorte:2][intervalos:8][margen:8];
+   * `longitud` cuenta los bytes desde la versión. Cada histograma va en
+   * nibbles normalizados a su cubeta mayor (cubeta par en el nibble bajo).
+   *
+   * @param buf Buffer de al menos TAMANO bytes.
+   * @return uint8_t Bytes escritos.
+   */
+  uint8_t encode(uint8_t* buf) const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < 4; ++i) total += _s[i];
+    buf[0] = TIPO;
+    buf[1] = TAMANO - 2;
+    buf[2] = VERSION;
+    escribir32(buf + 3, total);
+    for (uint8_t i = 0; i < 4; ++i) {
+      uint32_t f = total ? (uint32_t)(((uint64_t)_s[i] * 255 + total / 2) / total) : 0;
+      buf[7 + i] = (uint8_t)f;
+    }
+    escribir16(buf + 11, _transiciones);
+    escribir16(buf + 13, _rebotes);
+    escribir16(buf + 15, _entradasCorte);
+    empacar(_intervalos, buf + 17);
+    empacar(_margen, buf + 25);
+    return TAMANO;
+  }
+#else
+  void     begin(const Cfg&, uint32_t) {}
+  template <class... P>
+  void     update(const BasicAdaptiveTXWSN<P...>&, uint32_t) {}
+  void     setCutoffVolts(float) {}
+  void     onSend(uint32_t) {}
+  uint32_t secondsInLevel(AdaptiveTXWSN::Level) const { return 0; }
+  uint32_t secondsInCutoff() const { return 0; }
+  uint16_t transitions() const { return 0; }
+  uint16_t flaps() const { return 0; }
+  uint16_t cutoffEntries() const { return 0; }
+  uint16_t intervalBucket(uint8_t) const { return 0; }
+  uint16_t voltageBucket(uint8_t) const { return 0; }
+  uint8_t  encode(uint8_t*) const { return 0; }
+#endif
+
+  /**
+   * @brief Deserializa el bloque (disponible siempre, para el gateway).
+   *
+   * Acepta bloques más largos que TAMANO (versiones futuras que agreguen
+   * campos al final) y lee sólo los campos conocidos.
+   *
+   * @param buf Inicio del bloque (p. ej. lo que devuelve StatusBeacon::findExtension()).
+   * @param len Bytes disponibles desde `buf`.
+   * @param out Resumen decodificado.
+   * @return true Si el tipo, la longitud y la versión son válidos.
+   */
+  static bool decode(const uint8_t* buf, uint8_t len, Resumen& out) {
+    if (len < TAMANO || buf[0] != TIPO || buf[1] < TAMANO - 2 || (uint16_t)buf[1] + 2 > len) return false;
+    if (buf[2] != VERSION) return false;
+    const uint8_t* v = buf + 3;
+    out.segundos = (uint32_t)v[0] | ((uint32_t)v[1] << 8) | ((uint32_t)v[2] << 16) | ((uint32_t)v[3] << 24);
+    for (uint8_t i = 0; i < 4; ++i) out.fraccion_q8[i] = v[4 + i];
+    out.transiciones  = (uint16_t)(v[8]  | ((uint16_t)v[9] << 8));
+    out.rebotes       = (uint16_t)(v[10] | ((uint16_t)v[11] << 8));
+    out.entradasCorte = (uint16_t)(v[12] | ((uint16_t)v[13] << 8));
+    for (uint8_t k = 0; k < CUBETAS; ++k) {
+      out.intervalos[k]    = (uint8_t)((v[14 + k / 2] >> ((k & 1) * 4)) & 0x0F);
+      out.margenVoltaje[k] = (uint8_t)((v[22 + k / 2] >> ((k & 1) * 4)) & 0x0F);
+    }
+    return true;
+  }
+
+  /** @brief Cubeta del histograma de intervalos: floor(log2(s)), acotada. */
+  static uint8_t cubetaIntervalo(uint32_t segundos) {
+    uint8_t k = 0;
+    while (segundos > 1 && k < CUBETAS - 1) { segundos >>= 1; k++; }
+    return k;
+  }
+
+  /** @brief Cubeta del histograma de margen: media octava desde 8 mV. */
+  static uint8_t cubetaMargen(uint16_t mV) {
+    if (mV < 8) return 0;
+    uint8_t octava = 0;
+    uint16_t x = mV >> 3;                      // 1.. en unidades de 8 mV
+    while (x > 1) { x >>= 1; octava++; }
+    const uint16_t base = (uint16_t)8 << octava;
+    const uint8_t medio = (mV >= base + (base >> 1) - (base >> 3)) ? 1 : 0; // ~sqrt(2) * base
+    const uint8_t k = (uint8_t)(1 + 2 * octava + medio);
+    return (k >= CUBETAS) ? CUBETAS - 1 : k;
+  }
+
+private:
+#if ADAPTIVETXWSN_STATS
+  Cfg      _cfg;
+  uint32_t _s[4];                      ///< Segundos en BAJO, MEDIO, ALTO y corte.
+  uint16_t _resto_ms[4];               ///< Milisegundos por debajo del segundo.
+  uint16_t _intervalos[CUBETAS];
+  uint16_t _margen[CUBETAS];
+  uint16_t _transiciones   = 0;
+  uint16_t _rebotes        = 0;
+  uint16_t _entradasCorte  = 0;
+  uint32_t _ultimo_ms      = 0;
+  uint32_t _ultimoEnvio_ms = 0;
+  uint32_t _msTransicion   = 0;        ///< Instante del último cambio de nivel.
+  float    _corte_V        = 3.40f;
+  uint8_t  _estado         = 0xFF;     ///< 0..2 nivel, 3 corte, 0xFF sin datos.
+  uint8_t  _nivelAnterior  = 0xFF;     ///< Nivel antes del último cambio.
+  bool     _hayEnvio       = false;
+
+  void acumular(uint8_t estado, uint32_t dt_ms) {
+    const uint16_t resto = (uint16_t)(_resto_ms[estado] + dt_ms % 1000);
+    _s[estado] += dt_ms / 1000 + resto / 1000;
+    _resto_ms[estado] = resto % 1000;
+  }
+
+  static void saturar(uint16_t& c) { if (c < 0xFFFF) c++; }
+
+  static void contar(uint16_t* h, uint8_t k) {
+    if (h[k] == 0xFFFF) {
+      for (uint8_t i = 0; i < CUBETAS; ++i) h[i] >>= 1;
+    }
+    h[k]++;
+  }
+
+  static void empacar(const uint16_t* h, uint8_t* out) {
+    uint16_t mayor = 0;
+    for (uint8_t i = 0; i < CUBETAS; ++i) if (h[i] > mayor) mayor = h[i];
+    for (uint8_t i = 0; i < CUBETAS / 2; ++i) {
+      uint8_t a = mayor ? (uint8_t)(((uint32_t)h[2 * i] * 15 + mayor - 1) / mayor) : 0;
+      uint8_t b = mayor ? (uint8_t)(((uint32_t)h[2 * i + 1] * 15 + mayor - 1) / mayor) : 0;
+      out[i] = (uint8_t)(a | (b << 4));
+    }
+  }
+
+  static void escribir16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+  static void escribir32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+  }
+#endif
+};
@@ -0,0 +1,89 @@
+/**
+ * @file QTableDefault.h
+ * @brief Tabla Q por defecto para QTablePolicy (generada, no editar a mano).
+ * Entrenada con extras/host/rl/qtable_trainer.cpp (train 8 40) sobre la
+ * distribución de sitios de NodeEnv; regenerarla si cambian los períodos,
+ * la cuantización del estado o la recompensa de QTablePolicy.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "QTablePolicy.h"
+
+/// Estado = (SOC * FRANJAS + franja) * ENLACES + enlace; fila = acciones (período corto a largo).
+static const int16_t QTABLA_DEFECTO[QTablePolicy::NUM_ESTADOS * QTablePolicy::ACCIONES] PROGMEM = {
+    -961,  -944,  -925,  -954, -1052,  // soc 0 franja 0 enlace 0
+   -1073, -1014,  -970, -1033, -1116,  // soc 0 franja 0 enlace 1
+   -1241, -1144, -1082, -1131, -1219,  // soc 0 franja 0 enlace 2
+   -1002,  -973,  -936,  -985, -1085,  // soc 0 franja 1 enlace 0
+   -1133, -1079,  -984, -1095, -1177,  // soc 0 franja 1 enlace 1
+   -1217, -1150, -1090, -1133, -1206,  // soc 0 franja 1 enlace 2
+    -997,  -984,  -930, -1019, -1076,  // soc 0 franja 2 enlace 0
+   -1091, -1050,  -974, -1074, -1136,  // soc 0 franja 2 enlace 1
+   -1227, -1150, -1079, -1141, -1215,  // soc 0 franja 2 enlace 2
+   -1019, -1017,  -921, -1002, -1104,  // soc 0 franja 3 enlace 0
+   -1084, -1045,  -975, -1057, -1137,  // soc 0 franja 3 enlace 1
+   -1232, -1148, -1074, -1137, -1207,  // soc 0 franja 3 enlace 2
+    -848,  -849,  -816,  -848,  -940,  // soc 1 franja 0 enlace 0
+    -928,  -899,  -873,  -901,  -992,  // soc 1 franja 0 enlace 1
+   -1067, -1004,  -955,  -999, -1072,  // soc 1 franja 0 enlace 2
+    -845,  -846,  -821,  -844,  -941,  // soc 1 franja 1 enlace 0
+    -918,  -890,  -873,  -895,  -985,  // soc 1 franja 1 enlace 1
+   -1054,  -987,  -964,  -985, -1060,  // soc 1 franja 1 enlace 2
+    -851,  -851,  -816,  -853,  -939,  // soc 1 franja 2 enlace 0
+    -919,  -894,  -876,  -896,  -988,  // soc 1 franja 2 enlace 1
+   -1055,  -980,  -958,  -979, -1063,  // soc 1 franja 2 enlace 2
+    -847,  -842,  -814,  -849,  -940,  // soc 1 franja 3 enlace 0
+    -920,  -892,  -877,  -893,  -990,  // soc 1 franja 3 enlace 1
+   -1057,  -990,  -961,  -990, -1064,  // soc 1 franja 3 enlace 2
+    -721,  -721,  -700,  -720,  -816,  // soc 2 franja 0 enlace 0
+    -767,  -765,  -743,  -763,  -850,  // soc 2 franja 0 enlace 1
+    -881,  -835,  -814,  -834,  -917,  // soc 2 franja 0 enlace 2
+    -701,  -701,  -695,  -711,  -807,  // soc 2 franja 1 enlace 0
+    -758,  -737,  -727,  -748,  -844,  // soc 2 franja 1 enlace 1
+    -865,  -822,  -802,  -822,  -903,  // soc 2 franja 1 enlace 2
+    -712,  -712,  -701,  -715,  -808,  // soc 2 franja 2 enlace 0
+    -761,  -747,  -736,  -749,  -843,  // soc 2 franja 2 enlace 1
+    -864,  -815,  -802,  -818,  -906,  // soc 2 franja 2 enlace 2
+    -713,  -718,  -701,  -716,  -810,  // soc 2 franja 3 enlace 0
+    -762,  -750,  -738,  -750,  -847,  // soc 2 franja 3 enlace 1
+    -870,  -816,  -801,  -819,  -912,  // soc 2 franja 3 enlace 2
+    -611,  -599,  -614,  -621,  -719,  // soc 3 franja 0 enlace 0
+    -655,  -644,  -630,  -654,  -750,  // soc 3 franja 0 enlace 1
+    -730,  -699,  -682,  -706,  -796,  // soc 3 franja 0 enlace 2
+    -608,  -593,  -614,  -617,  -712,  // soc 3 franja 1 enlace 0
+    -648,  -635,  -628,  -646,  -744,  // soc 3 franja 1 enlace 1
+    -723,  -686,  -674,  -697,  -790,  // soc 3 franja 1 enlace 2
+    -611,  -601,  -610,  -618,  -713,  // soc 3 franja 2 enlace 0
+    -650,  -638,  -631,  -650,  -745,  // soc 3 franja 2 enlace 1
+    -727,  -693,  -675,  -699,  -793,  // soc 3 franja 2 enlace 2
+    -612,  -597,  -601,  -618,  -716,  // soc 3 franja 3 enlace 0
+    -648,  -641,  -631,  -653,  -747,  // soc 3 franja 3 enlace 1
+    -729,  -698,  -682,  -701,  -795,  // soc 3 franja 3 enlace 2
+    -375,  -341,  -376,  -378,  -473,  // soc 4 franja 0 enlace 0
+    -428,  -399,  -428,  -435,  -529,  // soc 4 franja 0 enlace 1
+    -458,  -454,  -438,  -460,  -551,  // soc 4 franja 0 enlace 2
+    -355,  -325,  -355,  -364,  -461,  // soc 4 franja 1 enlace 0
+    -403,  -377,  -386,  -414,  -510,  // soc 4 franja 1 enlace 1
+    -441,  -435,  -408,  -438,  -520,  // soc 4 franja 1 enlace 2
+    -355,  -331,  -360,  -367,  -464,  // soc 4 franja 2 enlace 0
+    -413,  -386,  -405,  -419,  -515,  // soc 4 franja 2 enlace 1
+    -453,  -450,  -415,  -446,  -534,  // soc 4 franja 2 enlace 2
+    -368,  -344,  -364,  -369,  -469,  // soc 4 franja 3 enlace 0
+    -418,  -404,  -378,  -428,  -524,  // soc 4 franja 3 enlace 1
+    -450,  -443,  -431,  -450,  -545,  // soc 4 franja 3 enlace 2
+    -102,  -109,  -120,  -120,  -205,  // soc 5 franja 0 enlace 0
+    -112,  -119,  -140,  -144,  -216,  // soc 5 franja 0 enlace 1
+    -160,  -132,  -164,  -165,  -227,  // soc 5 franja 0 enlace 2
+     -69,   -79,   -79,   -94,  -193,  // soc 5 franja 1 enlace 0
+     -76,   -87,   -89,  -100,  -194,  // soc 5 franja 1 enlace 1
+    -107,   -97,  -114,  -114,  -206,  // soc 5 franja 1 enlace 2
+     -82,   -84,   -84,  -101,  -198,  // soc 5 franja 2 enlace 0
+     -96,   -88,   -90,  -106,  -203,  // soc 5 franja 2 enlace 1
+    -121,  -101,  -108,  -116,  -212,  // soc 5 franja 2 enlace 2
+     -96,  -108,  -109,  -110,  -206,  // soc 5 franja 3 enlace 0
+    -114,  -110,  -124,  -132,  -210,  // soc 5 franja 3 enlace 1
+    -159,  -127,  -145,  -147,  -229,  // soc 5 franja 3 enlace 2
+};
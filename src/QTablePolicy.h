@@ -0,0 +1,203 @@
+/**
+ * @file QTablePolicy.h
+ * @brief Define la clase QTablePolicy: política de período aprendida con una tabla Q.
+ * Alternativa opcional a los tres niveles del `Cfg`: el período se elige de
+ * una tabla pequeña indexada por estado de carga cuantizado, franja de
+ * cosecha y calidad de enlace. La tabla se entrena fuera de línea en el
+ * simulador del host (`extras/host/rl/`) y vive en PROGMEM; si se le da un
+ * búfer en RAM, el nodo puede además ajustarla en el sitio con aritmética
+ * entera (Q-learning de un paso, con el ajuste en Q4 para no perder las
+ * actualizaciones pequeñas).
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @class QTablePolicy
+ * @brief Tabla Q de NUM_ESTADOS x ACCIONES en int16 (unidades de recompensa).
+ *
+ * Recompensa por intervalo de decisión (misma función en el nodo y en el
+ * entrenador, ver reward()): frescura -64 * período / aoiReferencia, acotada
+ * a -128, menos un precio de energía que crece al bajar el estado de carga
+ * (envíos por minuto x ETX del enlace x cubetas por debajo de lleno), o -320
+ * si el nodo está en corte. El precio suple el horizonte corto del descuento:
+ * sin él la tabla no "ve" un agotamiento que tarda semanas. Con el descuento
+ * por defecto la tabla queda dentro de int16.
+ *
+ * Uso típico, una vez por intervalo de decisión (p. ej. 15 min):
+ * @code
+ *   uint32_t p = politica.decide(mV, franja, enlace, txTimer.isCutoff());
+ *   txTimer.setPeriodOverride(p);
+ * @endcode
+ */
+class QTablePolicy {
+public:
+  static const uint8_t  NIVELES_SOC = 6;   ///< Cubetas del estado de carga (entre corte y lleno).
+  static const uint8_t  FRANJAS     = 4;   ///< Franjas de cosecha (p. ej. noche, mañana, mediodía, tarde).
+  static const uint8_t  ENLACES     = 3;   ///< Calidad de enlace: 0 buena, 1 regular, 2 mala.
+  static const uint8_t  ACCIONES    = 5;   ///< Períodos candidatos.
+  static const uint8_t  NUM_ESTADOS = NIVELES_SOC * FRANJAS * ENLACES;
+  static const uint8_t  ESCALA_AJUSTE = 16; ///< Fracciones por unidad Q en el ajuste int16 en RAM (Q4).
+
+  /**
+   * @struct Cfg
+   * @brief Parámetros de la política (los de entrenamiento deben coincidir con el entrenador).
+   */
+  struct Cfg {
+    uint32_t periodos_ms[ACCIONES] = { 5000, 15000, 60000, 300000, 1200000 }; ///< Acción -> período.
+    uint16_t corte_mV           = 3400;    ///< Estado de carga 0 (`corteVoltaje_V`).
+    uint16_t lleno_mV           = 4150;    ///< Estado de carga lleno.
+    uint32_t aoiReferencia_ms   = 600000;  ///< Período que vale -64 (10 min).
+    uint8_t  precioEnergia_q4   = 10;      ///< Castigo por envío/min, ETX y cubeta bajo lleno, en Q4.4.
+    // --- Ajuste en el sitio (sólo con enableFineTuning()) ---
+    uint8_t  corrimientoAprendizaje = 3;   ///< Tasa de aprendizaje como 2^-n.
+    uint8_t  descuento_q8       = 253;     ///< Factor de descuento en Q0.8 (~0.99).
+    uint8_t  exploracion_q8     = 0;       ///< Probabilidad de acción aleatoria en Q0.8.
+  };
+
+  /**
+   * @brief Inicializa la política.
+   * @param cfg Parámetros.
+   * @param tablaProgmem Tabla de NUM_ESTADOS * ACCIONES valores int16 en PROGMEM
+   *        (p. ej. QTABLA_DEFECTO de QTableDefault.h).
+   */
+  void begin(const Cfg& cfg, const int16_t* tablaProgmem) {
+    _cfg = cfg;
+    _tabla = tablaProgmem;
+    _ajustes = nullptr;
+    _hayAnterior = false;
+    _azar = 0xACE1u;
+  }
+
+  /**
+   * @brief Activa el ajuste en el sitio sobre un búfer de NUM_ESTADOS * ACCIONES
+   * valores int16 en RAM (720 bytes).
+   * El búfer guarda correcciones en 1/ESCALA_AJUSTE de unidad Q sobre la tabla en
+   * PROGMEM (±2047 unidades); la fracción se conserva entre actualizaciones, así
+   * que errores TD pequeños también mueven el valor. Se pone a cero aquí y puede
+   * persistirse en EEPROM por el usuario.
+   * @param ajustes Búfer del usuario, o nullptr para desactivar.
+   */
+  void enableFineTuning(int16_t* ajustes) {
+    _ajustes = ajustes;
+    if (_ajustes) memset(_ajustes, 0, (size_t)NUM_ESTADOS * ACCIONES * sizeof(int16_t));
+  }
+
+  /**
+   * @brief Elige el período para el próximo intervalo y, si el ajuste está
+   * activo, aprende de la transición anterior.
+   * @param mV Voltaje de batería (mV).
+   * @param franja Franja de cosecha [0, FRANJAS).
+   * @param enlace Calidad de enlace [0, ENLACES).
+   * @param enCorte AdaptiveTXWSN::isCutoff() (entra en la recompensa).
+   * @return uint32_t Período (ms) para AdaptiveTXWSN::setPeriodOverride().
+   */
+  uint32_t decide(uint16_t mV, uint8_t franja, uint8_t enlace, bool enCorte) {
+    const uint8_t s = stateOf(_cfg, mV, franja, enlace);
+    if (_ajustes && _hayAnterior) {
+      learn(_estadoAnterior, _accionAnterior, reward(_cfg, _estadoAnterior, _cfg.periodos_ms[_accionAnterior], enCorte), s);
+    }
+    uint8_t a = bestAction(s);
+    if (_cfg.exploracion_q8 && (uint8_t)aleatorio() < _cfg.exploracion_q8) a = (uint8_t)(aleatorio() % ACCIONES);
+    _estadoAnterior = s;
+    _accionAnterior = a;
+    _hayAnterior = true;
+    return _cfg.periodos_ms[a];
+  }
+
+  /**
+   * @brief Acción de mayor valor en un estado (empates: el período más largo).
+   */
+  uint8_t bestAction(uint8_t estado) const {
+    uint8_t mejor = ACCIONES - 1;
+    int16_t vMejor = value(estado, mejor);
+    for (int8_t a = ACCIONES - 2; a >= 0; --a) {
+      int16_t v = value(estado, (uint8_t)a);
+      if (v > vMejor) { vMejor = v; mejor = (uint8_t)a; }
+    }
+    return mejor;
+  }
+
+  /**
+   * @brief Valor Q vigente (tabla en PROGMEM más el ajuste en RAM).
+   */
+  int16_t value(uint8_t estado, uint8_t accion) const {
+    const int32_t q = (valorQ4(estado, accion) + ESCALA_AJUSTE / 2) >> 4;
+    return (int16_t)((q < -32768) ? -32768 : (q > 32767) ? 32767 : q);
+  }
+
+  /**
+   * @brief Actualización Q-learning entera: Q += (r + γ·max Q(s') - Q) / 2^n.
+   * Sólo modifica el ajuste en RAM; la tabla en PROGMEM no cambia. La cuenta
+   * se hace en Q4, así que un error TD de media unidad ya mueve el ajuste.
+   */
+  void learn(uint8_t estado, uint8_t accion, int16_t recompensa, uint8_t estadoNuevo) {
+    if (!_ajustes) return;
+    const uint16_t i = (uint16_t)estado * ACCIONES + accion;
+    const int32_t q = valorQ4(estado, accion);
+    const int32_t siguiente = valorQ4(estadoNuevo, bestAction(estadoNuevo));
+    const int32_t objetivo = (int32_t)recompensa * ESCALA_AJUSTE + ((siguiente * _cfg.descuento_q8) >> 8);
+    const int32_t nuevo = q + (objetivo - q) / (1L << _cfg.corrimientoAprendizaje);
+    const int32_t d = nuevo - (int32_t)(int16_t)pgm_read_word(_tabla + i) * ESCALA_AJUSTE;
+    _ajustes[i] = (int16_t)((d > 32767) ? 32767 : (d < -32768) ? -32768 : d);
+  }
+
+  /**
+   * @brief Índice de estado: (cubeta SOC, franja, enlace).
+   */
+  static uint8_t stateOf(const Cfg& cfg, uint16_t mV, uint8_t franja, uint8_t enlace) {
+    uint8_t soc = 0;
+    if (mV > cfg.corte_mV && cfg.lleno_mV > cfg.corte_mV) {
+      uint32_t r = ((uint32_t)(mV - cfg.corte_mV) * NIVELES_SOC) / (uint16_t)(cfg.lleno_mV - cfg.corte_mV);
+      soc = (r >= NIVELES_SOC) ? NIVELES_SOC - 1 : (uint8_t)r;
+    }
+    if (franja >= FRANJAS) franja = FRANJAS - 1;
+    if (enlace >= ENLACES) enlace = ENLACES - 1;
+    return (uint8_t)((soc * FRANJAS + franja) * ENLACES + enlace);
+  }
+
+  /**
+   * @brief Recompensa de un intervalo: frescura y energía del período elegido
+   * en el estado de partida, o castigo por corte.
+   */
+  static int16_t reward(const Cfg& cfg, uint8_t estado, uint32_t periodo_ms, bool enCorte) {
+    if (enCorte) return -320;
+    if (periodo_ms == 0) periodo_ms = 1;
+    uint32_t frescura = ((uint64_t)periodo_ms * 64) / (cfg.aoiReferencia_ms ? cfg.aoiReferencia_ms : 1);
+    if (frescura > 128) frescura = 128;
+    const uint8_t soc = estado / (FRANJAS * ENLACES);
+    const uint8_t etx = (uint8_t)1 << (estado % ENLACES);               // 1, 2, 4
+    uint32_t energia = ((uint32_t)cfg.precioEnergia_q4 * etx * (NIVELES_SOC - 1 - soc) * 60000UL / periodo_ms) >> 4;
+    if (energia > 192) energia = 192;
+    return (int16_t)-(int16_t)(frescura + energia);
+  }
+
+  /** @brief Período (ms) de una acción. */
+  uint32_t periodFor(uint8_t accion) const { return _cfg.periodos_ms[accion < ACCIONES ? accion : ACCIONES - 1]; }
+
+private:
+  Cfg            _cfg;
+  const int16_t* _tabla          = nullptr;
+  int16_t*       _ajustes        = nullptr; ///< Ajuste en RAM en Q4 (o nullptr).
+  bool           _hayAnterior    = false;
+  uint8_t        _estadoAnterior = 0;
+  uint8_t        _accionAnterior = 0;
+  uint16_t       _azar           = 0xACE1u; ///< Estado del LFSR de exploración.
+
+  /** @brief Valor Q vigente en Q4 (tabla x ESCALA_AJUSTE más el ajuste). */
+  int32_t valorQ4(uint8_t estado, uint8_t accion) const {
+    const uint16_t i = (uint16_t)estado * ACCIONES + accion;
+    int32_t q = (int32_t)(int16_t)pgm_read_word(_tabla + i) * ESCALA_AJUSTE;
+    if (_ajustes) q += _ajustes[i];
+    return q;
+  }
+
+  uint16_t aleatorio() {
+    // LFSR de Galois de 16 bits
+    _azar = (uint16_t)((_azar >> 1) ^ (-(int16_t)(_azar & 1u) & 0xB400u));
+    return _azar;
+  }
+};
@@ -0,0 +1,155 @@
+/**
+ * @file RoutingCost.h
+ * @brief Define la clase RoutingCost: costo de ruteo consciente de la batería.
+ * En redes multi-salto los relevos con poca batería siguen siendo elegidos
+ * como padres y mueren primero. Este costo combina el `Level`, la vida
+ * restante prevista y la carga de reenvío del nodo en un entero Q8.8 de 16
+ * bits que cabe en la baliza de ruteo; los hijos eligen el vecino con menor
+ * costo de camino acumulado.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "AdaptiveTXWSN.h"
+#include "EnergyLedger.h"
+
+/**
+ * @class RoutingCost
+ * @brief Costo propio de un nodo como relevo, en Q8.8 (256 = un salto ideal).
+ *
+ * costo = 256 (salto)
+ *       + penalización del `Level`
+ *       + min(pesoVida * horizonte / vidaRestante, vidaMaxima)   (0 si no hay predicción)
+ *       + pesoCarga * reenvíos por hora / cargaReferencia
+ * En corte el costo es INALCANZABLE. El costo de camino que anuncia el nodo
+ * es el de su padre más el propio (accumulate()). Los reenvíos se leen del
+ * EnergyLedger del nodo, que ya los cuenta con `onForward()`.
+ *
+ * Uso típico:
+ * @code
+ *   if (reenvie) ledger.onForward();
+ *   if (tocaBalizaRuteo) {
+ *     uint16_t propio = ruteo.update(txTimer, ledger, tendencia.secondsTo(3400), millis());
+ *     uint16_t anuncio = RoutingCost::accumulate(costoCaminoPadre, propio);
+ *   }
+ * @endcode
+ */
+class RoutingCost {
+public:
+  static constexpr uint16_t UN_SALTO     = 256;    ///< Costo de un salto sin penalizaciones.
+  static constexpr uint16_t INALCANZABLE = 0xFFFF; ///< Nodo en corte o camino inexistente.
+
+  /**
+   * @struct Cfg
+   * @brief Pesos del costo (todos en Q8.8 de "saltos").
+   */
+  struct Cfg {
+    uint16_t penalizacionAlto_q8  = 0;      ///< Suma en BATT_HIGH.
+    uint16_t penalizacionMedio_q8 = 128;    ///< Suma en BATT_MID (medio salto).
+    uint16_t penalizacionBajo_q8  = 1024;   ///< Suma en BATT_LOW (cuatro saltos).
+    uint16_t pesoVida_q8          = 256;    ///< Suma cuando la vida restante iguala el horizonte.
+    uint32_t horizonteVida_s      = 2592000UL; ///< Vida a partir de la cual el término es menor a `pesoVida` (30 días).
+    uint16_t vidaMaxima_q8        = 4096;   ///< Tope del término de vida (16 saltos) para no saturar el camino.
+    uint16_t pesoCarga_q8         = 256;    ///< Suma cuando la carga de reenvío iguala la referencia.
+    uint16_t cargaReferencia_ph   = 240;    ///< Reenvíos por hora de referencia (un hijo cada 15 s).
+    uint8_t  corrimientoCarga     = 3;      ///< Constante de la EWMA de la carga como 2^-n.
+  };
+
+  /**
+   * @brief Inicializa el costo y descarta la historia de reenvíos.
+   * @param cfg Pesos.
+   * @param libro Libro de energía del nodo (punto de partida de la cuenta de reenvíos).
+   * @param ahora_ms Valor actual de millis().
+   */
+  void begin(const Cfg& cfg, const EnergyLedger& libro, uint32_t ahora_ms) {
+    _cfg = cfg;
+    _reenviosPrevios = libro.forwardedPackets();
+    _carga_ph = 0;
+    _inicioVentana_ms = ahora_ms;
+    _costo_q8 = UN_SALTO;
+  }
+
+  /**
+   * @brief Recalcula el costo propio. Llamar antes de emitir cada baliza de ruteo.
+   * @param nodo Temporizador adaptativo del nodo (nivel y corte).
+   * @param libro Libro de energía del nodo (paquetes reenviados).
+   * @param vidaRestante_s VoltageTrend::secondsTo(corte) o VoltageTrend::SIN_PREDICCION.
+   * @param ahora_ms Valor actual de millis().
+   * @return uint16_t Costo propio en Q8.8.
+   */
+  template <class... P>
+  uint16_t update(const BasicAdaptiveTXWSN<P...>& nodo, const EnergyLedger& libro, uint32_t vidaRestante_s,
+                  uint32_t ahora_ms) {
+    actualizarCarga(libro.forwardedPackets(), ahora_ms);
+    _costo_q8 = compute(_cfg, nodo.isCutoff(), nodo.level(), vidaRestante_s, _carga_ph);
+    return _costo_q8;
+  }
+
+  /**
+   * @brief Fórmula del costo, sin estado (la usa también el simulador del host).
+   * @param cfg Pesos.
+   * @param enCorte true si el nodo está en corte.
+   * @param nivel AdaptiveTXWSN::Level vigente.
+   * @param vidaRestante_s Vida restante prevista (s) o 0xFFFFFFFF si no hay predicción.
+   * @param carga_ph Reenvíos por hora.
+   * @return uint16_t Costo propio en Q8.8.
+   */
+  static uint16_t compute(const Cfg& cfg, bool enCorte, uint8_t nivel, uint32_t vidaRestante_s,
+                          uint16_t carga_ph) {
+    if (enCorte) return INALCANZABLE;
+    uint32_t c = UN_SALTO;
+    switch (nivel) {
+      case AdaptiveTXWSN::BATT_HIGH: c += cfg.penalizacionAlto_q8;  break;
+      case AdaptiveTXWSN::BATT_MID:  c += cfg.penalizacionMedio_q8; break;
+      default:                       c += cfg.penalizacionBajo_q8;  break;
+    }
+    if (vidaRestante_s != 0xFFFFFFFFUL) {
+      uint32_t vida_s = (vidaRestante_s == 0) ? 1 : vidaRestante_s;
+      uint64_t termino = ((uint64_t)cfg.pesoVida_q8 * cfg.horizonteVida_s) / vida_s;
+      c += (termino > cfg.vidaMaxima_q8) ? cfg.vidaMaxima_q8 : (uint32_t)termino;
+    }
+    if (cfg.cargaReferencia_ph > 0)
+      c += ((uint32_t)cfg.pesoCarga_q8 * carga_ph) / cfg.cargaReferencia_ph;
+    return (c >= INALCANZABLE) ? (uint16_t)(INALCANZABLE - 1) : (uint16_t)c;
+  }
+
+  /**
+   * @brief Costo de camino que anuncia un nodo: el de su padre más el propio, saturado.
+   * @param caminoPadre_q8 Costo de camino anunciado por el padre (0 para el gateway).
+   * @param propio_q8 Costo propio (update()).
+   * @return uint16_t Costo de camino en Q8.8, INALCANZABLE si alguno lo es.
+   */
+  static uint16_t accumulate(uint16_t caminoPadre_q8, uint16_t propio_q8) {
+    if (caminoPadre_q8 == INALCANZABLE || propio_q8 == INALCANZABLE) return INALCANZABLE;
+    uint32_t s = (uint32_t)caminoPadre_q8 + propio_q8;
+    return (s >= INALCANZABLE) ? (uint16_t)(INALCANZABLE - 1) : (uint16_t)s;
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /** @brief Último costo propio calculado en Q8.8. */
+  uint16_t cost() const { return _costo_q8; }
+
+  /** @brief Carga de reenvío suavizada (paquetes por hora). */
+  uint16_t forwardLoadPerHour() const { return _carga_ph; }
+
+private:
+  Cfg      _cfg;
+  uint32_t _reenviosPrevios  = 0;        ///< EnergyLedger::forwardedPackets() en la última update().
+  uint16_t _carga_ph         = 0;        ///< EWMA de reenvíos por hora.
+  uint32_t _inicioVentana_ms = 0;        ///< millis() de la última update().
+  uint16_t _costo_q8         = UN_SALTO; ///< Último costo calculado.
+
+  void actualizarCarga(uint32_t reenvios, uint32_t ahora_ms) {
+    const uint32_t dt_ms = ahora_ms - _inicioVentana_ms;
+    if (dt_ms == 0) return;
+    uint64_t muestra = ((uint64_t)(reenvios - _reenviosPrevios) * 3600000ULL) / dt_ms;
+    if (muestra > 0xFFFF) muestra = 0xFFFF;
+    int32_t d = (int32_t)muestra - (int32_t)_carga_ph;
+    _carga_ph = (uint16_t)((int32_t)_carga_ph + d / (1L << _cfg.corrimientoCarga));
+    _reenviosPrevios = reenvios;
+    _inicioVentana_ms = ahora_ms;
+  }
+};
@@ -0,0 +1,236 @@
+/**
+ * @file StagePolicies.h
+ * @brief Políticas de etapa de BasicAdaptiveTXWSN: cómo se mide la batería
+ * (Sampler), cómo se suaviza la medición (Filter), cómo se clasifica en
+ * `Level` (Classifier) y cuándo toca enviar (Scheduler).
+ * Cada política es un parámetro de plantilla que BasicAdaptiveTXWSN hereda en
+ * forma privada (las vacías no ocupan memoria) y llama sin funciones
+ * virtuales. Las opciones por defecto reproducen exactamente a AdaptiveTXWSN;
+ * una variante sólo tiene que cumplir el concepto de su etapa.
+ *
+ * Conceptos (Cfg y Level son los de AdaptiveTXWSNTypes):
+ *  - Sampler:    `void begin(const Cfg&)`;
+ *                `float read(const Cfg&, float ultimo_V)` devuelve voltios
+ *                (`ultimo_V` es la medición anterior, para fuentes sin dato).
+ *  - Filter:     `void reset()`; `float apply(float voltaje_V)`.
+ *  - Classifier: `void begin(const Cfg&)` (se vuelve a llamar al cambiar
+ *                umbrales o histéresis en tiempo de ejecución);
+ *                `Level classify(const Cfg&, Level actual, float voltaje_V)`.
+ *  - Scheduler:  `void begin(uint32_t ahora_ms)`; `bool due(uint32_t ahora_ms)`;
+ *                `void schedule(uint32_t ahora_ms, uint32_t periodo_ms)` (sólo
+ *                tras un due() verdadero); `void pullIn(uint32_t limite_ms)`
+ *                adelanta el envío pendiente a `limite_ms` si es posterior.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "AdaptiveTXWSNTypes.h"
+
+// ---------------------------------------------------------------- Sampler
+
+/**
+ * @struct AdcSampler
+ * @brief Sampler por defecto: promedia `muestrasPromedioAdc` lecturas del
+ * ADC de 10 bits y deshace el divisor resistivo. Sin pin devuelve `ultimo_V`.
+ */
+struct AdcSampler {
+  void begin(const AdaptiveTXWSNTypes::Cfg& cfg) {
+    if (cfg.pinAdcBateria >= 0) pinMode(cfg.pinAdcBateria, INPUT);
+  }
+
+  float read(const AdaptiveTXWSNTypes::Cfg& cfg, float ultimo_V) {
+    if (cfg.pinAdcBateria < 0) return ultimo_V; // sin pin: devolver ultimo
+    uint32_t acumuladorAdc = 0;
+    uint8_t nMuestras = max((uint8_t)1, cfg.muestrasPromedioAdc);
+    for (uint8_t i = 0; i < nMuestras; ++i) {
+      acumuladorAdc += analogRead(cfg.pinAdcBateria);
+      delayMicroseconds(250);
+    }
+    float promedioCuentasAdc = (float)acumuladorAdc / nMuestras;
+    float voltajeAdc_V = (promedioCuentasAdc / 1023.0f) * cfg.voltajeReferenciaAdc;
+    float factorDivisor = (cfg.divisorRArriba_k + cfg.divisorRAbajo_k)
+                          / cfg.divisorRAbajo_k; // Vin = Vadc * factor
+    return voltajeAdc_V * factorDivisor;
+  }
+};
+
+// ----------------------------------------------------------------- Filter
+
+/**
+ * @struct NoFilter
+ * @brief Filter por defecto: deja pasar la medición.
+ */
+struct NoFilter {
+  void  reset() {}
+  float apply(float voltaje_V) { return voltaje_V; }
+};
+
+/**
+ * @class EmaFilter
+ * @brief Media móvil exponencial con peso 1/2^K para la medición nueva.
+ * La primera medición tras reset() se toma tal cual. Reduce el ruido del ADC
+ * a costa de retrasar la detección de cambios unos 2^K tick().
+ * @tparam K Exponente del peso (1..7).
+ */
+template <uint8_t K = 2>
+class EmaFilter {
+  static_assert(K >= 1 && K <= 7, "EmaFilter: K entre 1 y 7");
+
+public:
+  void reset() { _iniciado = false; }
+
+  float apply(float voltaje_V) {
+    if (!_iniciado) {
+      _suavizado_V = voltaje_V;
+      _iniciado = true;
+    } else {
+      _suavizado_V += (voltaje_V - _suavizado_V) * (1.0f / (1 << K));
+    }
+    return _suavizado_V;
+  }
+
+private:
+  float _suavizado_V = 0.0f;
+  bool  _iniciado    = false;
+};
+
+// ------------------------------------------------------------- Classifier
+
+/**
+ * @struct HysteresisClassifier
+ * @brief Classifier por defecto: tres niveles con histéresis de
+ * `fraccionHisteresis` alrededor de cada umbral, a lo sumo un nivel por tick().
+ */
+struct HysteresisClassifier {
+  void begin(const AdaptiveTXWSNTypes::Cfg&) {}
+
+  AdaptiveTXWSNTypes::Level classify(const AdaptiveTXWSNTypes::Cfg& cfg, AdaptiveTXWSNTypes::Level actual,
+                                     float voltajeBateria_V) {
+    // diferencials de histéresis alrededor de los umbrales
+    float diferencialAlto_V  = cfg.umbralAlto_V  * cfg.fraccionHisteresis;
+    float diferencialMedio_V = cfg.umbralMedio_V * cfg.fraccionHisteresis;
+
+    switch (actual) {
+      case AdaptiveTXWSNTypes::BATT_HIGH: // ALTO -> MEDIO si baja por debajo de (alto - diferencial)
+        if (voltajeBateria_V < (cfg.umbralAlto_V - diferencialAlto_V))
+          return AdaptiveTXWSNTypes::BATT_MID;
+        break;
+
+      case AdaptiveTXWSNTypes::BATT_MID:
+        // MEDIO -> ALTO si supera (alto + diferencial)
+        if (voltajeBateria_V >= (cfg.umbralAlto_V + diferencialAlto_V))   return AdaptiveTXWSNTypes::BATT_HIGH;
+        // MEDIO -> BAJO si baja por debajo de (medio - diferencial)
+        if (voltajeBateria_V <  (cfg.umbralMedio_V - diferencialMedio_V)) return AdaptiveTXWSNTypes::BATT_LOW;
+        break;
+
+      case AdaptiveTXWSNTypes::BATT_LOW: // BAJO -> MEDIO si supera (medio + diferencial)
+        if (voltajeBateria_V >= (cfg.umbralMedio_V + diferencialMedio_V))
+          return AdaptiveTXWSNTypes::BATT_MID;
+        break;
+    }
+    return actual;
+  }
+};
+
+/**
+ * @class CachedHysteresisClassifier
+ * @brief Misma histéresis que HysteresisClassifier con los cuatro umbrales
+ * calculados en begin(): cada tick() hace sólo comparaciones (útil en MCU sin
+ * FPU, donde cada multiplicación en coma flotante es una llamada a la
+ * biblioteca). Ocupa 16 bytes de RAM.
+ */
+class CachedHysteresisClassifier {
+public:
+  void begin(const AdaptiveTXWSNTypes::Cfg& cfg) {
+    const float diferencialAlto_V  = cfg.umbralAlto_V  * cfg.fraccionHisteresis;
+    const float diferencialMedio_V = cfg.umbralMedio_V * cfg.fraccionHisteresis;
+    _altoBaja_V  = cfg.umbralAlto_V  - diferencialAlto_V;
+    _altoSube_V  = cfg.umbralAlto_V  + diferencialAlto_V;
+    _medioBaja_V = cfg.umbralMedio_V - diferencialMedio_V;
+    _medioSube_V = cfg.umbralMedio_V + diferencialMedio_V;
+  }
+
+  AdaptiveTXWSNTypes::Level classify(const AdaptiveTXWSNTypes::Cfg&, AdaptiveTXWSNTypes::Level actual,
+                                     float voltajeBateria_V) {
+    switch (actual) {
+      case AdaptiveTXWSNTypes::BATT_HIGH:
+        if (voltajeBateria_V < _altoBaja_V) return AdaptiveTXWSNTypes::BATT_MID;
+        break;
+      case AdaptiveTXWSNTypes::BATT_MID:
+        if (voltajeBateria_V >= _altoSube_V) return AdaptiveTXWSNTypes::BATT_HIGH;
+        if (voltajeBateria_V <  _medioBaja_V) return AdaptiveTXWSNTypes::BATT_LOW;
+        break;
+      case AdaptiveTXWSNTypes::BATT_LOW:
+        if (voltajeBateria_V >= _medioSube_V) return AdaptiveTXWSNTypes::BATT_MID;
+        break;
+    }
+    return actual;
+  }
+
+private:
+  float _altoBaja_V  = 0.0f;
+  float _altoSube_V  = 0.0f;
+  float _medioBaja_V = 0.0f;
+  float _medioSube_V = 0.0f;
+};
+
+// -------------------------------------------------------------- Scheduler
+
+/**
+ * @class DeadlineScheduler
+ * @brief Scheduler por defecto: un único instante límite; al vencer se
+ * programa el siguiente a un período de distancia.
+ */
+class DeadlineScheduler {
+public:
+  void begin(uint32_t ahora_ms)                        { _proximo_ms = ahora_ms; }
+  bool due(uint32_t ahora_ms) const                    { return (int32_t)(ahora_ms - _proximo_ms) >= 0; }
+  void schedule(uint32_t ahora_ms, uint32_t periodo_ms) { _proximo_ms = ahora_ms + periodo_ms; }
+  void pullIn(uint32_t limite_ms) {
+    if ((int32_t)(_proximo_ms - limite_ms) > 0) _proximo_ms = limite_ms;
+  }
+
+  /** @brief Instante (millis()) del próximo envío. */
+  uint32_t nextMs() const { return _proximo_ms; }
+
+private:
+  uint32_t _proximo_ms = 0; ///< Marca de tiempo (millis()) para el siguiente envío.
+};
+
+/**
+ * @class JitterScheduler
+ * @brief Como DeadlineScheduler pero cada período se desplaza al azar hasta
+ * ±PORCENTAJE %, con media igual al período. Evita que nodos encendidos a la
+ * vez (o sincronizados por el gateway) transmitan siempre en el mismo
+ * instante y colisionen. Generador xorshift de 16 bits; dar a cada nodo su
+ * semilla con seed() (p. ej. el id del nodo).
+ * @tparam PORCENTAJE Amplitud del desplazamiento (1..50).
+ */
+template <uint8_t PORCENTAJE = 10>
+class JitterScheduler : public DeadlineScheduler {
+  static_assert(PORCENTAJE >= 1 && PORCENTAJE <= 50, "JitterScheduler: porcentaje entre 1 y 50");
+
+public:
+  /** @brief Semilla del generador (0 se reemplaza por 1). */
+  void seed(uint16_t semilla) { _estado = semilla ? semilla : 1; }
+
+  void schedule(uint32_t ahora_ms, uint32_t periodo_ms) {
+    // periodo * (1 - p + 2p·u), u uniforme en [0, 1); el producto en 64 bits
+    // conserva la resolución de la amplitud y del generador con períodos cortos
+    const uint32_t amplitud = (uint32_t)(((uint64_t)periodo_ms * PORCENTAJE) / 50);
+    const uint32_t desvio = (uint32_t)(((uint64_t)amplitud * siguiente()) >> 16);
+    DeadlineScheduler::schedule(ahora_ms, periodo_ms - amplitud / 2 + desvio);
+  }
+
+private:
+  uint16_t _estado = 0xACE1;
+
+  uint16_t siguiente() {
+    _estado ^= (uint16_t)(_estado << 7);
+    _estado ^= (uint16_t)(_estado >> 9);
+    _estado ^= (uint16_t)(_estado << 8);
+    return _estado;
+  }
+};
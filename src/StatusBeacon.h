@@ -0,0 +1,226 @@
+/**
+ * @file StatusBeacon.h
+ * @brief Define la baliza de estado que un nodo AdaptiveTXWSN envía al gateway.
+ * La baliza resume el estado del temporizador adaptativo (nivel, voltaje,
+ * período vigente y deriva de reloj) en un formato binario compacto y
+ * little-endian, idéntico en AVR, ARM y en el host.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "AdaptiveTXWSN.h"
+#include "VoltageTrend.h"
+#include "EnergyLedger.h"
+
+/**
+ * @struct StatusBeacon
+ * @brief Estado de un nodo tal como viaja en el aire.
+ *
+ * Se construye justo después de que tick() devuelve true, por lo que
+ * `periodo_ms` es el intervalo hasta la siguiente transmisión. Con eso el
+ * gateway puede predecir el próximo envío sin conocer el `Cfg` del nodo.
+ *
+ * La versión 2 añade la tendencia de voltaje, el libro de energía y el
+ * multiplicador de período, que usa el balanceo de vida útil de la flota.
+ * La versión 3 añade un byte con la longitud de los bloques de extensión
+ * (tipo, longitud, valor) que van detrás, p. ej. el de NodeStats; así una
+ * trama ocupa frameSize() bytes y varias pueden ir seguidas en un flujo.
+ * decode() sigue aceptando balizas de versión 1 y 2 (los campos que no
+ * traen quedan en 0).
+ */
+struct StatusBeacon {
+  static const uint8_t VERSION   = 3;   ///< Versión del formato binario que genera encode().
+  static const uint8_t TAMANO    = 23;  ///< Bytes de la baliza sin extensiones.
+  static const uint8_t TAMANO_V2 = 22;  ///< Bytes de una baliza de versión 2.
+  static const uint8_t TAMANO_V1 = 15;  ///< Bytes de una baliza de versión 1.
+  static const uint16_t TAMANO_MAXIMO = TAMANO + 255; ///< Trama más larga (con 255 bytes de extensiones).
+
+  uint32_t nodeId           = 0;     ///< Identificador del nodo.
+  uint8_t  seq              = 0;     ///< Número de secuencia (desborda en 255).
+  uint8_t  level            = 0;     ///< AdaptiveTXWSN::Level vigente.
+  bool     cutoff           = false; ///< true si el nodo está en corte por batería.
+  uint16_t mV               = 0;     ///< Último voltaje medido (mV).
+  uint32_t periodo_ms       = 0;     ///< Período hasta el próximo envío (ms, hora del gateway).
+  int16_t  deriva_ppm       = 0;     ///< Deriva de reloj que el nodo está compensando.
+  // --- Versión 2 ---
+  int16_t  pendiente_10uVh  = 0;     ///< VoltageTrend::slopeUvPerHour() / 10.
+  uint16_t consumo_uA       = 0;     ///< EnergyLedger::averageCurrentUa().
+  uint8_t  fraccionEnvio_q8 = 0;     ///< EnergyLedger::sendShareQ8().
+  uint16_t multiplicador_q8 = 256;   ///< AdaptiveTXWSN::periodMultiplier().
+
+  /**
+   * @brief Captura el estado actual de un nodo.
+   *
+   * @param nodo Instancia de AdaptiveTXWSN del nodo.
+   * @param nodeId Identificador del nodo.
+   * @param seq Número de secuencia de la baliza.
+   * @return StatusBeacon La baliza lista para codificar.
+   */
+  template <class... P>
+  static StatusBeacon from(const BasicAdaptiveTXWSN<P...>& nodo, uint32_t nodeId, uint8_t seq) {
+    StatusBeacon b;
+    b.nodeId     = nodeId;
+    b.seq        = seq;
+    b.level      = nodo.level();
+    b.cutoff     = nodo.isCutoff();
+    float mV     = nodo.lastVolts() * 1000.0f + 0.5f;
+    b.mV         = (mV <= 0.0f) ? 0 : (mV >= 65535.0f) ? 65535 : (uint16_t)mV;
+    b.periodo_ms = nodo.currentPeriod();
+    int32_t d    = nodo.clockDriftPpm();
+    b.deriva_ppm = (int16_t)((d > 32767) ? 32767 : (d < -32768) ? -32768 : d);
+    b.multiplicador_q8 = nodo.periodMultiplier();
+    return b;
+  }
+
+  /**
+   * @brief Captura el estado de un nodo junto con su tendencia y su libro de energía.
+   *
+   * @param nodo Instancia de AdaptiveTXWSN del nodo.
+   * @param tendencia Tendencia de voltaje alimentada por el nodo.
+   * @param libro Libro de energía alimentado por el nodo.
+   * @param nodeId Identificador del nodo.
+   * @param seq Número de secuencia de la baliza.
+   * @return StatusBeacon La baliza lista para codificar.
+   */
+  template <class... P>
+  static StatusBeacon from(const BasicAdaptiveTXWSN<P...>& nodo, const VoltageTrend& tendencia,
+                           const EnergyLedger& libro, uint32_t nodeId, uint8_t seq) {
+    StatusBeacon b = from(nodo, nodeId, seq);
+    int32_t p = tendencia.slopeUvPerHour() / 10;
+    b.pendiente_10uVh  = (int16_t)((p > 32767) ? 32767 : (p < -32768) ? -32768 : p);
+    b.consumo_uA       = libro.averageCurrentUa();
+    b.fraccionEnvio_q8 = libro.sendShareQ8();
+    return b;
+  }
+
+  /**
+   * @brief Serializa la baliza en `buf`.
+   *
+   * Formato: [versión][nodeId:4][seq][flags][mV:2][periodo_ms:4][deriva_ppm:2]
+   * [pendiente_10uVh:2][consumo_uA:2][fraccionEnvio_q8][multiplicador_q8:2]
+   * [extensiones] con flags = nivel (bits 0-1) | corte (bit 2). El último
+   * byte queda en 0; addExtension() lo actualiza al anexar bloques.
+   *
+   * @param buf Buffer de al menos TAMANO bytes.
+   * @return uint8_t Bytes escritos (TAMANO).
+   */
+  uint8_t encode(uint8_t* buf) const {
+    buf[0] = VERSION;
+    escribir32(buf + 1, nodeId);
+    buf[5] = seq;
+    buf[6] = (uint8_t)((level & 0x03) | (cutoff ? 0x04 : 0x00));
+    escribir16(buf + 7, mV);
+    escribir32(buf + 9, periodo_ms);
+    escribir16(buf + 13, (uint16_t)deriva_ppm);
+    escribir16(buf + 15, (uint16_t)pendiente_10uVh);
+    escribir16(buf + 17, consumo_uA);
+    buf[19] = fraccionEnvio_q8;
+    escribir16(buf + 20, multiplicador_q8);
+    buf[22] = 0;
+    return TAMANO;
+  }
+
+  /**
+   * @brief Registra un bloque de extensión escrito justo detrás de la trama.
+   *
+   * Uso: `n = b.encode(buf); n += StatusBeacon::addExtension(buf, stats.encode(buf + n));`
+   *
+   * @param trama Trama generada por encode() (y, si hay, bloques anteriores).
+   * @param bytes Bytes del bloque anexado (tipo, longitud y valor).
+   * @return uint8_t `bytes`, o 0 si no cabe en las extensiones de la trama.
+   */
+  static uint8_t addExtension(uint8_t* trama, uint8_t bytes) {
+    if ((uint16_t)trama[22] + bytes > 255) return 0;
+    trama[22] = (uint8_t)(trama[22] + bytes);
+    return bytes;
+  }
+
+  /**
+   * @brief Bytes que ocupa la trama que empieza en `buf`, según su versión.
+   *
+   * @param buf Inicio de la trama.
+   * @param len Bytes disponibles desde `buf` (al menos 1).
+   * @return uint16_t Tamaño de la trama, que puede superar `len` si está
+   *         incompleta (con `len` < TAMANO en una v3 es el mínimo, TAMANO);
+   *         0 si la versión es desconocida.
+   */
+  static uint16_t frameSize(const uint8_t* buf, size_t len) {
+    switch (buf[0]) {
+      case 1:  return TAMANO_V1;
+      case 2:  return TAMANO_V2;
+      case 3:  return (len < TAMANO) ? TAMANO : (uint16_t)(TAMANO + buf[22]);
+      default: return 0;
+    }
+  }
+
+  /**
+   * @brief Busca un bloque de extensión por tipo.
+   *
+   * @param trama Trama completa (frameSize() bytes).
+   * @param len Longitud de `trama`.
+   * @param tipo Tipo del bloque buscado.
+   * @param largo Bytes desde el bloque hasta el fin de la trama.
+   * @return const uint8_t* Inicio del bloque (su byte de tipo) o nullptr.
+   */
+  static const uint8_t* findExtension(const uint8_t* trama, size_t len, uint8_t tipo, uint8_t& largo) {
+    if (len < TAMANO || trama[0] < 3) return nullptr;
+    size_t fin = (size_t)TAMANO + trama[22];
+    if (fin > len) fin = len;
+    for (size_t off = TAMANO; off + 2 <= fin; off += 2 + (size_t)trama[off + 1]) {
+      if (trama[off] == tipo) {
+        largo = (uint8_t)(fin - off);
+        return trama + off;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Deserializa una baliza.
+   *
+   * @param buf Bytes recibidos.
+   * @param len Longitud de `buf`.
+   * @param out Baliza decodificada.
+   * @return true Si la longitud y la versión son válidas.
+   */
+  static bool decode(const uint8_t* buf, uint8_t len, StatusBeacon& out) {
+    if (len < TAMANO_V1 || buf[0] < 1 || buf[0] > VERSION) return false;
+    if (buf[0] >= 2 && len < TAMANO_V2) return false;
+    if (buf[0] >= 3 && len < TAMANO) return false;
+    out.nodeId     = leer32(buf + 1);
+    out.seq        = buf[5];
+    out.level      = buf[6] & 0x03;
+    out.cutoff     = (buf[6] & 0x04) != 0;
+    out.mV         = leer16(buf + 7);
+    out.periodo_ms = leer32(buf + 9);
+    out.deriva_ppm = (int16_t)leer16(buf + 13);
+    if (buf[0] >= 2) {
+      out.pendiente_10uVh  = (int16_t)leer16(buf + 15);
+      out.consumo_uA       = leer16(buf + 17);
+      out.fraccionEnvio_q8 = buf[19];
+      out.multiplicador_q8 = leer16(buf + 20);
+    } else {
+      out.pendiente_10uVh  = 0;
+      out.consumo_uA       = 0;
+      out.fraccionEnvio_q8 = 0;
+      out.multiplicador_q8 = 256;
+    }
+    return out.level <= AdaptiveTXWSN::BATT_HIGH;
+  }
+
+private:
+  static void escribir16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8);
+  }
+  static void escribir32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+  }
+  static uint16_t leer16(const uint8_t* p) {
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+  }
+  static uint32_t leer32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+};
@@ -0,0 +1,190 @@
+/**
+ * @file TickProfiler.h
+ * @brief Define TickProfiler: política de traza para BasicAdaptiveTXWSN que
+ * mide la latencia de cada etapa de tick() con el contador de ciclos de la
+ * plataforma y guarda mínimo, máximo y media por etapa en memoria fija.
+ *
+ * Contador según la plataforma:
+ *  - Cortex-M3/M4/M7/M33: DWT CYCCNT (ciclos).
+ *  - AVR con Timer1 de 16 bits (ATmega328P, 32U4, 2560): Timer1 sin PWM con
+ *    prescaler 8, en ciclos con resolución de 8. begin() toma el Timer1
+ *    (no usar junto con Servo ni PWM en sus pines).
+ *  - Host x86: rdtsc (ciclos del TSC). Otro host: clock_gettime (ns).
+ *  - Cualquier otra placa: micros() (µs).
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "TracePolicies.h"
+
+#if !defined(ARDUINO) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#elif !defined(ARDUINO)
+#include <time.h>
+#endif
+
+/**
+ * @enum TickStage
+ * @brief Etapas de tick() medidas por TickProfiler.
+ */
+enum TickStage : uint8_t {
+  ETAPA_MUESTREO      = 0, ///< Lectura de batería (ráfaga ADC y conversión, o voltaje inyectado).
+  ETAPA_FILTRADO      = 1, ///< Política Filter sobre la medición.
+  ETAPA_CLASIFICACION = 2, ///< Corte duro y nivel con histéresis.
+  ETAPA_PLANIFICACION = 3, ///< Temporizador de envío (no ocurre en corte).
+  ETAPA_TICK          = 4, ///< tick() completo.
+  ETAPAS              = 5  ///< Cantidad de etapas.
+};
+
+/**
+ * @class TickProfiler
+ * @brief Latencia por etapa de tick(), con el desglose del tick más lento.
+ *
+ * Uso típico:
+ * @code
+ *   BasicAdaptiveTXWSN<TickProfiler> txTimer;
+ *   // setup():  txTimer.tracer().begin();
+ *   // después:  txTimer.tracer().stage(ETAPA_TICK).max  (en TickProfiler::UNIDAD)
+ * @endcode
+ *
+ * Las marcas se toman en los ganchos, así que cada etapa incluye el costo de
+ * una lectura del contador.
+ */
+class TickProfiler {
+public:
+  /**
+   * @struct Estadistica
+   * @brief Acumulado de una etapa.
+   */
+  struct Estadistica {
+    uint32_t min  = 0xFFFFFFFFUL; ///< Menor duración.
+    uint32_t max  = 0;            ///< Mayor duración.
+    uint64_t suma = 0;
+    uint32_t n    = 0;            ///< Veces medida.
+
+    /** @brief Duración media (0 si no hay mediciones). */
+    uint32_t mean() const { return n ? (uint32_t)(suma / n) : 0; }
+  };
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+  static constexpr const char* UNIDAD = "ciclos";
+#elif defined(__AVR__) && defined(TCNT1H)
+  static constexpr const char* UNIDAD = "ciclos";
+#elif !defined(ARDUINO) && (defined(__x86_64__) || defined(__i386__))
+  static constexpr const char* UNIDAD = "ciclos TSC";
+#elif !defined(ARDUINO)
+  static constexpr const char* UNIDAD = "ns";
+#else
+  static constexpr const char* UNIDAD = "us";
+#endif
+
+  /**
+   * @brief Habilita el contador de la plataforma y borra las estadísticas.
+   */
+  void begin() {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+    *(volatile uint32_t*)0xE000EDFCUL |= (1UL << 24);  // DEMCR.TRCENA
+    *(volatile uint32_t*)0xE0001FB0UL  = 0xC5ACCE55UL; // DWT_LAR (sólo M7)
+    *(volatile uint32_t*)0xE0001004UL  = 0;            // CYCCNT
+    *(volatile uint32_t*)0xE0001000UL |= 1UL;          // CTRL.CYCCNTENA
+#elif defined(__AVR__) && defined(TCNT1H)
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11); // modo normal, prescaler 8
+    TIFR1  = _BV(TOV1);
+    _alto  = 0;
+#endif
+    reset();
+  }
+
+  /** @brief Borra las estadísticas. */
+  void reset() {
+    for (uint8_t e = 0; e < ETAPAS; ++e) {
+      _etapas[e] = Estadistica();
+      _peor[e] = 0;
+    }
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /** @brief Estadística de una etapa, en UNIDAD. */
+  const Estadistica& stage(TickStage e) const { return _etapas[(e < ETAPAS) ? e : ETAPA_TICK]; }
+
+  /** @brief Duración de una etapa en el tick() más lento visto (su desglose). */
+  uint32_t worstTick(TickStage e) const { return _peor[(e < ETAPAS) ? e : ETAPA_TICK]; }
+
+  /** @brief Lectura actual del contador (UNIDAD), para medir otras secciones del loop(). */
+  uint32_t now() { return leer(); }
+
+  // --- Ganchos de BasicAdaptiveTXWSN ---
+
+  void onSampleStart()                 { _inicio = leer(); _clasificado = false; }
+  void onSampleEnd(uint16_t)           { _finMuestra = leer(); }
+  void onFilterEnd(uint16_t)           { _finFiltro = leer(); }
+  void onClassify(uint8_t, uint16_t)   { _clasificacion = leer(); _clasificado = true; }
+  void onLevelChange(uint8_t, uint8_t) {}
+  void onCutoff(bool, uint16_t)        {}
+  void onSendDue(uint32_t)             {}
+  void onTickEnd(bool) {
+    const uint32_t fin = leer();
+    uint32_t d[ETAPAS];
+    d[ETAPA_MUESTREO]      = _finMuestra - _inicio;
+    d[ETAPA_FILTRADO]      = _finFiltro - _finMuestra;
+    d[ETAPA_CLASIFICACION] = (_clasificado ? _clasificacion : fin) - _finFiltro;
+    d[ETAPA_PLANIFICACION] = _clasificado ? fin - _clasificacion : 0;
+    d[ETAPA_TICK]          = fin - _inicio;
+    for (uint8_t e = 0; e < ETAPAS; ++e) {
+      if (e == ETAPA_PLANIFICACION && !_clasificado) continue;
+      acumular(_etapas[e], d[e]);
+    }
+    if (d[ETAPA_TICK] >= _peor[ETAPA_TICK]) {
+      for (uint8_t e = 0; e < ETAPAS; ++e) _peor[e] = d[e];
+    }
+  }
+
+private:
+  Estadistica _etapas[ETAPAS];
+  uint32_t    _peor[ETAPAS]  = {};  ///< Desglose del tick() más lento.
+  uint32_t    _inicio        = 0;
+  uint32_t    _finMuestra    = 0;
+  uint32_t    _finFiltro     = 0;
+  uint32_t    _clasificacion = 0;
+  bool        _clasificado   = false; ///< false si el tick() terminó en el corte.
+#if defined(__AVR__) && defined(TCNT1H)
+  uint16_t    _alto          = 0;     ///< Desbordes de Timer1 vistos.
+#endif
+
+  static void acumular(Estadistica& s, uint32_t d) {
+    if (d < s.min) s.min = d;
+    if (d > s.max) s.max = d;
+    s.suma += d;
+    s.n++;
+  }
+
+  uint32_t leer() {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+    return *(volatile uint32_t*)0xE0001004UL;
+#elif defined(__AVR__) && defined(TCNT1H)
+    // Se cuenta a lo sumo un desborde entre lecturas: etapas de hasta 65 ms a 16 MHz
+    const uint8_t sreg = SREG;
+    cli();
+    uint16_t bajo = TCNT1;
+    if (TIFR1 & _BV(TOV1)) {
+      TIFR1 = _BV(TOV1);
+      _alto++;
+      bajo = TCNT1; // por si desbordó justo después de la primera lectura
+    }
+    SREG = sreg;
+    return (((uint32_t)_alto << 16) | bajo) << 3;
+#elif !defined(ARDUINO) && (defined(__x86_64__) || defined(__i386__))
+    return (uint32_t)__rdtsc();
+#elif !defined(ARDUINO)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#else
+    return micros();
+#endif
+  }
+};
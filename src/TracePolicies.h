@@ -0,0 +1,167 @@
+/**
+ * @file TracePolicies.h
+ * @brief Políticas de traza para BasicAdaptiveTXWSN.
+ * La política es un parámetro de plantilla: BasicAdaptiveTXWSN la hereda
+ * (base vacía, sin costo de memoria) y llama a sus ganchos en cada cambio de
+ * estado de tick(). Con NoTrace, la opción por defecto de `AdaptiveTXWSN`,
+ * los ganchos son funciones vacías en línea y el compilador no genera nada.
+ *
+ * Una política propia sólo tiene que definir los ocho ganchos de NoTrace.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @enum TraceEvent
+ * @brief Identificadores de evento (los usan las políticas que registran).
+ */
+enum TraceEvent : uint8_t {
+  TRAZA_MUESTRA_INICIO = 0, ///< Antes de medir la batería.
+  TRAZA_MUESTRA_FIN    = 1, ///< Medición lista, antes del filtro (dato: mV).
+  TRAZA_CLASIFICACION  = 2, ///< Nivel evaluado con histéresis (dato: mV).
+  TRAZA_CAMBIO_NIVEL   = 3, ///< Cambio de `Level` (dato: nivel anterior << 8 | nuevo).
+  TRAZA_CORTE_ENTRADA  = 4, ///< Entrada en corte (dato: mV).
+  TRAZA_CORTE_SALIDA   = 5, ///< Salida del corte (dato: mV).
+  TRAZA_ENVIO_DEBIDO   = 6, ///< tick() devuelve true (dato: período en s, saturado).
+  TRAZA_FILTRADO       = 7, ///< Medición filtrada, la que se clasifica (dato: mV).
+  TRAZA_EVENTOS        = 8  ///< Cantidad de eventos.
+};
+
+/**
+ * @struct NoTrace
+ * @brief Política por defecto: todos los ganchos vacíos.
+ */
+struct NoTrace {
+  void onSampleStart() {}
+  void onSampleEnd(uint16_t mV) { (void)mV; }
+  void onFilterEnd(uint16_t mV) { (void)mV; }
+  void onClassify(uint8_t nivel, uint16_t mV) { (void)nivel; (void)mV; }
+  void onLevelChange(uint8_t anterior, uint8_t nuevo) { (void)anterior; (void)nuevo; }
+  void onCutoff(bool entra, uint16_t mV) { (void)entra; (void)mV; }
+  void onSendDue(uint32_t periodo_ms) { (void)periodo_ms; }
+  void onTickEnd(bool envio) { (void)envio; }
+};
+
+/**
+ * @class RingTrace
+ * @brief Registra cada evento con su instante en un anillo en RAM (se
+ * sobrescriben los más viejos). 7 bytes por registro en AVR.
+ * @tparam N Registros del anillo.
+ */
+template <uint8_t N = 32>
+class RingTrace {
+public:
+  /** @brief Un evento registrado. */
+  struct Registro {
+    uint32_t ms;     ///< millis() del evento.
+    uint8_t  evento; ///< TraceEvent.
+    uint16_t dato;   ///< Ver TraceEvent.
+  };
+
+  void onSampleStart()                                 { registrar(TRAZA_MUESTRA_INICIO, 0); }
+  void onSampleEnd(uint16_t mV)                        { registrar(TRAZA_MUESTRA_FIN, mV); }
+  void onFilterEnd(uint16_t mV)                        { registrar(TRAZA_FILTRADO, mV); }
+  void onClassify(uint8_t, uint16_t mV)                { registrar(TRAZA_CLASIFICACION, mV); }
+  void onLevelChange(uint8_t anterior, uint8_t nuevo)  { registrar(TRAZA_CAMBIO_NIVEL, (uint16_t)((anterior << 8) | nuevo)); }
+  void onCutoff(bool entra, uint16_t mV)               { registrar(entra ? TRAZA_CORTE_ENTRADA : TRAZA_CORTE_SALIDA, mV); }
+  void onSendDue(uint32_t periodo_ms) {
+    const uint32_t s = periodo_ms / 1000;
+    registrar(TRAZA_ENVIO_DEBIDO, (uint16_t)((s > 0xFFFF) ? 0xFFFF : s));
+  }
+  void onTickEnd(bool) {}
+
+  /** @brief Registros guardados (hasta N). */
+  uint8_t size() const { return _n; }
+  /** @brief Registro i-ésimo, del más viejo (0) al más nuevo. */
+  const Registro& at(uint8_t i) const { return _anillo[(uint8_t)((_pos + N - _n + i) % N)]; }
+  /** @brief Vacía el anillo. */
+  void clear() { _n = 0; _pos = 0; }
+
+private:
+  Registro _anillo[N];
+  uint8_t  _pos = 0;
+  uint8_t  _n   = 0;
+
+  void registrar(uint8_t evento, uint16_t dato) {
+    _anillo[_pos].ms = millis();
+    _anillo[_pos].evento = evento;
+    _anillo[_pos].dato = dato;
+    _pos = (uint8_t)((_pos + 1) % N);
+    if (_n < N) _n++;
+  }
+};
+
+/**
+ * @class GpioTrace
+ * @brief Pines para un analizador lógico: PIN_MUESTRA queda en alto mientras
+ * se mide la batería; PIN_EVENTO conmuta en cada clasificación, cambio de
+ * nivel, corte y envío debido. Llamar a begin() (vía tracer()) en setup().
+ */
+template <uint8_t PIN_MUESTRA, uint8_t PIN_EVENTO>
+class GpioTrace {
+public:
+  void begin() {
+    pinMode(PIN_MUESTRA, OUTPUT);
+    pinMode(PIN_EVENTO, OUTPUT);
+    digitalWrite(PIN_MUESTRA, LOW);
+    digitalWrite(PIN_EVENTO, LOW);
+    _evento = false;
+  }
+
+  void onSampleStart()                   { digitalWrite(PIN_MUESTRA, HIGH); }
+  void onSampleEnd(uint16_t)             { digitalWrite(PIN_MUESTRA, LOW); }
+  void onFilterEnd(uint16_t)             {}
+  void onClassify(uint8_t, uint16_t)     { conmutar(); }
+  void onLevelChange(uint8_t, uint8_t)   { conmutar(); }
+  void onCutoff(bool, uint16_t)          { conmutar(); }
+  void onSendDue(uint32_t)               { conmutar(); }
+  void onTickEnd(bool)                   {}
+
+private:
+  bool _evento = false;
+
+  void conmutar() {
+    _evento = !_evento;
+    digitalWrite(PIN_EVENTO, _evento ? HIGH : LOW);
+  }
+};
+
+/**
+ * @class CycleTrace
+ * @brief Cuenta eventos y mide la duración de la medición de batería con micros()
+ * (en AVR a 16 MHz, 1 µs = 16 ciclos; resolución de 4 µs).
+ */
+class CycleTrace {
+public:
+  void onSampleStart()                   { _inicio_us = micros(); cuenta(TRAZA_MUESTRA_INICIO); }
+  void onSampleEnd(uint16_t) {
+    const uint32_t d = micros() - _inicio_us;
+    _muestra_us += d;
+    if (d > _muestraMax_us) _muestraMax_us = d;
+    cuenta(TRAZA_MUESTRA_FIN);
+  }
+  void onFilterEnd(uint16_t)             { cuenta(TRAZA_FILTRADO); }
+  void onClassify(uint8_t, uint16_t)     { cuenta(TRAZA_CLASIFICACION); }
+  void onLevelChange(uint8_t, uint8_t)   { cuenta(TRAZA_CAMBIO_NIVEL); }
+  void onCutoff(bool entra, uint16_t)    { cuenta(entra ? TRAZA_CORTE_ENTRADA : TRAZA_CORTE_SALIDA); }
+  void onSendDue(uint32_t)               { cuenta(TRAZA_ENVIO_DEBIDO); }
+  void onTickEnd(bool)                   {}
+
+  /** @brief Veces que ocurrió un evento. */
+  uint32_t count(TraceEvent e) const { return (e < TRAZA_EVENTOS) ? _cuentas[e] : 0; }
+  /** @brief Tiempo total (µs) dentro de la medición de batería. */
+  uint32_t sampleMicros() const { return _muestra_us; }
+  /** @brief Medición más larga (µs). */
+  uint32_t maxSampleMicros() const { return _muestraMax_us; }
+
+private:
+  uint32_t _cuentas[TRAZA_EVENTOS] = {};
+  uint32_t _inicio_us     = 0;
+  uint32_t _muestra_us    = 0;
+  uint32_t _muestraMax_us = 0;
+
+  void cuenta(uint8_t e) { _cuentas[e]++; }
+};
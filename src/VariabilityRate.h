@@ -0,0 +1,166 @@
+/**
+ * @file VariabilityRate.h
+ * @brief Define la plantilla VariabilityRate: períodos de muestreo y envío
+ * según la variabilidad de la señal medida.
+ * Si el fenómeno está quieto no hace falta muestrear ni transmitir al ritmo
+ * que permite la batería. La aplicación entrega sus lecturas; una ventana
+ * fija estima la actividad (desviación estándar o diferencia media entre
+ * muestras) y el período se interpola entre las cotas del `Level` actual.
+ * Sin memoria dinámica y con aritmética entera, apta para AVR.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "AdaptiveTXWSN.h"
+
+/**
+ * @class VariabilityRate
+ * @brief Ventana circular de VENTANA lecturas con sumas corrientes (O(1) por muestra).
+ *
+ * Actividad a = 0 da el período máximo del nivel; a >= `actividadReferencia`
+ * da el mínimo; en medio se interpola linealmente.
+ *
+ * Uso típico:
+ * @code
+ *   variab.addSample(lecturaSensor);
+ *   txTimer.setPeriodOverride(variab.txPeriodMs(txTimer.level()));
+ * @endcode
+ *
+ * @tparam VENTANA Número de muestras de la ventana (2..255).
+ */
+template <uint8_t VENTANA = 16>
+class VariabilityRate {
+  static_assert(VENTANA >= 2, "VariabilityRate: la ventana necesita al menos 2 muestras");
+
+public:
+  /**
+   * @enum Medida
+   * @brief Estimador de actividad.
+   */
+  enum Medida : uint8_t {
+    DESVIACION  = 0, ///< Desviación estándar de la ventana (capta derivas lentas).
+    DIFERENCIAS = 1  ///< Media de |x[i] - x[i-1]| (aproxima la energía de alta frecuencia).
+  };
+
+  /**
+   * @struct Cfg
+   * @brief Cotas por `Level` (índice AdaptiveTXWSN::Level) y sensibilidad.
+   */
+  struct Cfg {
+    uint32_t envioMin_ms[3]      = { 120000, 15000, 5000 };      ///< Período de envío con señal activa (BAJO, MEDIO, ALTO).
+    uint32_t envioMax_ms[3]      = { 3600000, 1800000, 600000 }; ///< Período de envío con señal quieta.
+    uint32_t muestreoMin_ms[3]   = { 60000, 20000, 10000 };      ///< Período de muestreo con señal activa.
+    uint32_t muestreoMax_ms[3]   = { 300000, 120000, 60000 };    ///< Período de muestreo con señal quieta.
+    uint16_t actividadReferencia = 16;                           ///< Actividad (unidades del sensor) que lleva al mínimo.
+    Medida   medida              = DESVIACION;                   ///< Estimador usado por activity().
+  };
+
+  /**
+   * @brief Configura y vacía la ventana.
+   */
+  void begin(const Cfg& cfg) {
+    _cfg = cfg;
+    if (_cfg.actividadReferencia == 0) _cfg.actividadReferencia = 1;
+    _n = 0;
+    _pos = 0;
+    _suma = 0;
+    _sumaCuadrados = 0;
+    _sumaDiferencias = 0;
+  }
+
+  /**
+   * @brief Agrega una lectura del sensor (unidades de la aplicación).
+   */
+  void addSample(int16_t valor) {
+    if (_n == VENTANA) {
+      const int16_t viejo = _muestras[_pos];
+      const int16_t siguiente = _muestras[(uint8_t)((_pos + 1) % VENTANA)];
+      _suma -= viejo;
+      _sumaCuadrados -= (uint32_t)((int32_t)viejo * viejo);
+      _sumaDiferencias -= distancia(siguiente, viejo);
+    } else {
+      _n++;
+    }
+    if (_n > 1) {
+      const int16_t anterior = _muestras[(uint8_t)((_pos + VENTANA - 1) % VENTANA)];
+      _sumaDiferencias += distancia(valor, anterior);
+    }
+    _muestras[_pos] = valor;
+    _suma += valor;
+    _sumaCuadrados += (uint32_t)((int32_t)valor * valor);
+    _pos = (uint8_t)((_pos + 1) % VENTANA);
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /** @brief true cuando la ventana está llena. */
+  bool full() const { return _n == VENTANA; }
+
+  /** @brief Varianza de la ventana (unidades²). */
+  uint32_t variance() const {
+    if (_n < 2) return 0;
+    // n·Σx² - (Σx)²: Σx² ocupa hasta 2^30 · VENTANA
+    const int64_t v = (int64_t)_n * (int64_t)_sumaCuadrados - (int64_t)_suma * _suma;
+    return (v <= 0) ? 0 : (uint32_t)(v / ((int64_t)_n * _n));
+  }
+
+  /** @brief Desviación estándar (raíz entera de variance()). */
+  uint16_t stdDev() const { return raiz(variance()); }
+
+  /** @brief Media de |x[i] - x[i-1]| en la ventana. */
+  uint16_t meanAbsDiff() const { return (_n < 2) ? 0 : (uint16_t)(_sumaDiferencias / (uint32_t)(_n - 1)); }
+
+  /** @brief Actividad según `medida`. */
+  uint16_t activity() const { return (_cfg.medida == DIFERENCIAS) ? meanAbsDiff() : stdDev(); }
+
+  /**
+   * @brief Período de envío para un nivel.
+   * Con la ventana aún incompleta devuelve el mínimo (no se sabe si la señal está quieta).
+   */
+  uint32_t txPeriodMs(AdaptiveTXWSN::Level nivel) const {
+    const uint8_t i = ((uint8_t)nivel > 2) ? 2 : (uint8_t)nivel;
+    return interpolar(_cfg.envioMin_ms[i], _cfg.envioMax_ms[i]);
+  }
+
+  /** @brief Período de muestreo para un nivel (misma interpolación que txPeriodMs()). */
+  uint32_t samplePeriodMs(AdaptiveTXWSN::Level nivel) const {
+    const uint8_t i = ((uint8_t)nivel > 2) ? 2 : (uint8_t)nivel;
+    return interpolar(_cfg.muestreoMin_ms[i], _cfg.muestreoMax_ms[i]);
+  }
+
+private:
+  Cfg      _cfg;
+  int16_t  _muestras[VENTANA];
+  uint8_t  _n               = 0;
+  uint8_t  _pos             = 0;  ///< Próxima posición a escribir (la más vieja si está llena).
+  int32_t  _suma            = 0;
+  uint64_t _sumaCuadrados   = 0;
+  uint32_t _sumaDiferencias = 0;
+
+  static uint16_t distancia(int16_t a, int16_t b) {
+    const int32_t d = (int32_t)a - b;
+    return (uint16_t)((d < 0) ? -d : d);
+  }
+
+  /** Raíz cuadrada entera por el método bit a bit (sin división). */
+  static uint16_t raiz(uint32_t x) {
+    uint32_t r = 0, bit = 1UL << 30;
+    while (bit > x) bit >>= 2;
+    while (bit) {
+      if (x >= r + bit) { x -= r + bit; r = (r >> 1) + bit; }
+      else              { r >>= 1; }
+      bit >>= 2;
+    }
+    return (uint16_t)r;
+  }
+
+  uint32_t interpolar(uint32_t minimo, uint32_t maximo) const {
+    if (!full() || maximo <= minimo) return minimo;
+    const uint16_t a = activity();
+    if (a >= _cfg.actividadReferencia) return minimo;
+    const uint32_t rango = maximo - minimo;
+    return maximo - (uint32_t)(((uint64_t)rango * a) / _cfg.actividadReferencia);
+  }
+};
@@ -0,0 +1,120 @@
+/**
+ * @file VoltageTrend.h
+ * @brief Define la clase VoltageTrend: tendencia de descarga de la batería.
+ * Estima, sólo con enteros, el voltaje suavizado y su pendiente (µV/h) para
+ * predecir cuánto falta para llegar a un voltaje dado (p. ej. `corteVoltaje_V`).
+ * El mismo modelo corre en el nodo y en el gateway, así las predicciones de
+ * ambos lados coinciden.
+ * @authors Francisco Rosales, Omar Tox
+ * @date 2025-09
+ */
+
+#pragma once
+#include <Arduino.h>
+
+/**
+ * @class VoltageTrend
+ * @brief Voltaje suavizado (EWMA en Q8) y pendiente medida entre anclas.
+ *
+ * La pendiente no se calcula muestra a muestra (el ruido del ADC la
+ * dominaría) sino entre el valor suavizado actual y un ancla tomada al menos
+ * `intervaloMinimo_ms` antes; esas pendientes se promedian con otra EWMA.
+ */
+class VoltageTrend {
+public:
+  static const uint32_t SIN_PREDICCION = 0xFFFFFFFFUL; ///< secondsTo() cuando la batería no se descarga.
+
+  /**
+   * @brief Configura el modelo y descarta la historia.
+   * @param intervaloMinimo_ms Separación mínima entre anclas (por defecto 1 h).
+   * @param corrimientoSuavizado Constante de la EWMA del voltaje como 2^-n (por defecto 1/8).
+   * @param corrimientoPendiente Constante de la EWMA de la pendiente como 2^-n (por defecto 1/8).
+   */
+  void begin(uint32_t intervaloMinimo_ms = 3600000UL, uint8_t corrimientoSuavizado = 3,
+             uint8_t corrimientoPendiente = 3) {
+    _intervaloMinimo_ms   = intervaloMinimo_ms;
+    _corrimientoSuavizado = corrimientoSuavizado;
+    _corrimientoPendiente = corrimientoPendiente;
+    reset();
+  }
+
+  /** @brief Descarta la historia conservando la configuración. */
+  void reset() {
+    _muestras      = 0;
+    _pendientes    = 0;
+    _pendiente_uVh = 0;
+  }
+
+  /**
+   * @brief Agrega una medición.
+   * @param ms Instante de la medición (millis() en el nodo, hora del gateway en el host).
+   * @param mV Voltaje medido en mV.
+   */
+  void addSample(uint32_t ms, uint16_t mV) {
+    const int32_t medida_q8 = (int32_t)mV << 8;
+    if (_muestras == 0) {
+      _suavizado_q8 = medida_q8;
+      _ancla_q8     = medida_q8;
+      _ancla_ms     = ms;
+      _muestras     = 1;
+      return;
+    }
+    if (_muestras < 255) _muestras++;
+    _suavizado_q8 += (medida_q8 - _suavizado_q8) / (1L << _corrimientoSuavizado);
+
+    const uint32_t dt_ms = ms - _ancla_ms;
+    if (dt_ms < _intervaloMinimo_ms) return;
+
+    // µV/h = dV_q8 * (1000 / 256) * (3.6e6 / dt_ms)
+    int64_t muestra_uVh = ((int64_t)(_suavizado_q8 - _ancla_q8) * 14062500LL) / (int64_t)dt_ms;
+    if (_pendientes == 0) _pendiente_uVh = (int32_t)muestra_uVh;
+    else                  _pendiente_uVh += (int32_t)((muestra_uVh - _pendiente_uVh) / (1L << _corrimientoPendiente));
+    if (_pendientes < 255) _pendientes++;
+    _ancla_q8 = _suavizado_q8;
+    _ancla_ms = ms;
+  }
+
+  // --- Getters (Consultores de estado) ---
+
+  /**
+   * @brief Pendiente estimada del voltaje.
+   * @return int32_t µV por hora (negativa al descargarse).
+   */
+  int32_t  slopeUvPerHour() const { return _pendiente_uVh; }
+
+  /**
+   * @brief Voltaje suavizado.
+   * @return uint16_t mV.
+   */
+  uint16_t smoothedMv()     const { return (uint16_t)((_suavizado_q8 + 128) >> 8); }
+
+  /**
+   * @brief Indica si ya se midió al menos una pendiente.
+   * @return true Si hay pendiente disponible.
+   */
+  bool     isValid()        const { return _pendientes > 0; }
+
+  /**
+   * @brief Tiempo estimado hasta que el voltaje suavizado llegue a `objetivo_mV`.
+   * @param objetivo_mV Voltaje objetivo en mV (p. ej. corteVoltaje_V * 1000).
+   * @return uint32_t Segundos; 0 si ya está por debajo, SIN_PREDICCION si no se descarga.
+   */
+  uint32_t secondsTo(uint16_t objetivo_mV) const {
+    int64_t margen_uV = ((int64_t)_suavizado_q8 * 1000) / 256 - (int64_t)objetivo_mV * 1000;
+    if (margen_uV <= 0) return 0;
+    if (!isValid() || _pendiente_uVh >= 0) return SIN_PREDICCION;
+    int64_t s = (margen_uV * 3600) / -(int64_t)_pendiente_uVh;
+    return (s >= (int64_t)SIN_PREDICCION) ? SIN_PREDICCION - 1 : (uint32_t)s;
+  }
+
+private:
+  uint32_t _intervaloMinimo_ms   = 3600000UL; ///< Separación mínima entre anclas.
+  uint8_t  _corrimientoSuavizado = 3;         ///< EWMA del voltaje: alfa = 2^-n.
+  uint8_t  _corrimientoPendiente = 3;         ///< EWMA de la pendiente: alfa = 2^-n.
+  uint8_t  _muestras             = 0;         ///< Mediciones vistas (satura en 255).
+  uint8_t  _pendientes           = 0;         ///< Pendientes promediadas (satura en 255).
+  int32_t  _suavizado_q8         = 0;         ///< Voltaje suavizado (mV, Q8).
+  int32_t  _ancla_q8             = 0;         ///< Voltaje suavizado en el ancla (mV, Q8).
+  uint32_t _ancla_ms             = 0;         ///< Instante del ancla.
+  int32_t  _pendiente_uVh        = 0;         ///< Pendiente promediada (µV/h).
+};